@@ -86,6 +86,7 @@ LIST(APPEND READDY_MODEL_SOURCES "${SOURCES_DIR}/observables/Positions.cpp")
 LIST(APPEND READDY_MODEL_SOURCES "${SOURCES_DIR}/observables/Topologies.cpp")
 LIST(APPEND READDY_MODEL_SOURCES "${SOURCES_DIR}/observables/RadialDistribution.cpp")
 LIST(APPEND READDY_MODEL_SOURCES "${SOURCES_DIR}/observables/Virial.cpp")
+LIST(APPEND READDY_MODEL_SOURCES "${SOURCES_DIR}/observables/AsyncWriter.cpp")
 
 # all sources
 LIST(APPEND READDY_ALL_SOURCES ${READDY_MODEL_SOURCES})
\ No newline at end of file
@@ -61,6 +61,16 @@ struct NeighborList {
      * drastically increase memory requirements.
      */
     std::uint8_t cll_radius{1};
+    /**
+     * Whether to use Verlet lists on top of the cell-linked list. Pairs are then collected up to the interaction
+     * distance plus skin and the lists are only rebuilt if a particle moved farther than half the skin or particles
+     * were added or removed.
+     */
+    bool verletList{false};
+    /**
+     * The skin of the Verlet lists, only used if verletList is set to true.
+     */
+    scalar skin{0};
 };
 
 /**
@@ -77,6 +87,35 @@ void to_json(json &j, const NeighborList &nl);
  */
 void from_json(const json &j, NeighborList &nl);
 
+/**
+ * Struct with configuration attributes for the periodic reordering of the CPU kernel's particle data
+ */
+struct Reorder {
+    /**
+     * Number of cell-linked list rebuilds between two reorderings of the particle data along a space filling curve
+     * of the cells. Zero disables the reordering.
+     */
+    std::size_t interval{0};
+    /**
+     * Whether to order along a Hilbert curve, otherwise a Morton (Z-order) curve is used.
+     */
+    bool hilbert{true};
+};
+
+/**
+ * Json serialization of Reorder config struct
+ * @param j the json object
+ * @param reorder the configurational object
+ */
+void to_json(json &j, const Reorder &reorder);
+
+/**
+ * Json deserialization to Reorder config struct
+ * @param j the json object
+ * @param reorder the configurational object
+ */
+void from_json(const json &j, Reorder &reorder);
+
 /**
  * Struct with configuration members that are used to parameterize the threading behavoir of the CPU kernel.
  */
@@ -123,6 +162,27 @@ struct Configuration {
      * Configuration of the threading behavior
      */
     ThreadConfig threadConfig{};
+    /**
+     * Configuration of the particle data reordering
+     */
+    Reorder reorder{};
+    /**
+     * Seed of the kernel's random numbers. Draws in parallel regions are keyed by particle index so that the random
+     * numbers of runs with the same seed do not depend on the number of threads. Zero selects a random seed on
+     * initialization.
+     */
+    std::uint64_t seed{0};
+    /**
+     * Whether the reaction handlers sample the number of first order events per type and reaction from a binomial
+     * distribution and pick the reacting particles uniformly, instead of drawing one random number per particle and
+     * reaction. Pays off for many particles with small reaction probabilities.
+     */
+    bool sampleFirstOrderReactions{false};
+    /**
+     * Whether the particle data additionally keeps positions, forces and types in contiguous arrays, on which the
+     * integrator and the pair force loop then operate.
+     */
+    bool structureOfArrays{false};
 };
 
 /**
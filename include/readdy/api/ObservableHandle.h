@@ -87,10 +87,12 @@ public:
     }
 
     /**
-     * Triggers a flush, i.e., everything that can be written will be written
+     * Triggers a flush, i.e., everything that can be written will be written, including the results that are still
+     * pending in the asynchronous writer
      */
     void flush() {
         if (_observable) {
+            _observable->waitForPendingWrites();
             _observable->flush();
         }
     }
@@ -46,6 +46,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <readdy/plugin/KernelProvider.h>
 #include <readdy/model/Kernel.h>
 #include <readdy/api/SimulationLoop.h>
@@ -156,6 +158,43 @@ public:
         return _kernel->registerObservable(std::move(observable));
     }
 
+    /**
+     * Hands the results of the registered observables to a writer thread, so that compression and file IO overlap
+     * with the simulation. The pending writes are finished at the end of each run.
+     * @param queueCapacity the number of pending writes after which the simulation waits for the writer
+     */
+    void enableAsyncOutput(std::size_t queueCapacity = 8) {
+        _kernel->enableAsyncObservableWriter(queueCapacity);
+    }
+
+    /**
+     * Finishes the pending writes, afterwards the observables write on the simulation thread again.
+     */
+    void disableAsyncOutput() {
+        _kernel->disableAsyncObservableWriter();
+    }
+
+    /**
+     * Blocks until the pending asynchronous writes are finished, e.g., before closing the output file after a custom
+     * simulation loop.
+     */
+    void waitForAsyncOutput() {
+        if (auto *writer = _kernel->asyncObservableWriter(); writer) {
+            writer->wait();
+        }
+    }
+
+    /**
+     * Bytes and time spent in asynchronous output so far.
+     * @return the statistics, empty if the output is synchronous
+     */
+    [[nodiscard]] std::optional<model::observables::util::AsyncWriter::Statistics> asyncOutputStatistics() const {
+        if (const auto *writer = _kernel->asyncObservableWriter(); writer) {
+            return writer->statistics();
+        }
+        return std::nullopt;
+    }
+
     /**
      * A method to access the particle positions of a certain type.
      * @param type the type
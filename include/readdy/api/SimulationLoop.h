@@ -64,6 +64,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <type_traits>
 
@@ -72,6 +73,7 @@
 #include <readdy/common/common.h>
 #include <readdy/model/Kernel.h>
 #include <readdy/model/IOUtils.h>
+#include <readdy/model/observables/io/TimeSeriesWriter.h>
 
 #include "Saver.h"
 
@@ -90,6 +92,26 @@ public:
     using TimeStepActionPtr = std::shared_ptr<readdy::model::actions::TimeStepDependentAction>;
     using ActionPtr = std::shared_ptr<readdy::model::actions::Action>;
 
+    /**
+     * Bounds from which the time step is chosen in each step if adaptive time stepping is enabled.
+     */
+    struct AdaptiveTimeStep {
+        /**
+         * the largest displacement D |F| / kT dt of a particle due to forces
+         */
+        scalar maxDisplacement;
+        /**
+         * the largest probability rate dt of a reaction event
+         */
+        scalar maxReactionProbability;
+        scalar minTimeStep;
+        scalar maxTimeStep;
+        /**
+         * the largest factor by which the time step may grow from one step to the next
+         */
+        scalar maxGrowthFactor;
+    };
+
     /**
      * Creates a new simulation scheme. Creates and initializes actions: Sets the neighborlist distance
      * to be the largest cutoff present in the context.
@@ -214,6 +236,45 @@ public:
 
     void writeConfigToFile(File &file) {
         configGroup = std::make_unique<h5rd::Group>(file.createGroup("readdy/config"));
+        outputGroup = std::make_unique<h5rd::Group>(file.subgroup("readdy"));
+    }
+
+    /**
+     * Chooses the time step anew before each step. It is the largest time step for which the displacement due to
+     * forces of every particle stays below maxDisplacement and the probability of every reaction event stays below
+     * maxReactionProbability, clamped to [minTimeStep, maxTimeStep] and growing by at most maxGrowthFactor per
+     * step. The forces enter through the drift speed that the integrator reported for the previous step, the first
+     * step uses the time step of the loop. Running the loop throws if the integrator does not report drift speeds.
+     * The time step of the latest step is available through lastTimeStep() and, if the config is written to a file,
+     * all chosen time steps are written to the group readdy/time_steps.
+     * @param maxDisplacement the largest displacement due to forces per step
+     * @param maxReactionProbability the largest probability of a reaction event per step
+     * @param minTimeStep the smallest time step
+     * @param maxTimeStep the largest time step, defaults to ten times the time step of the loop
+     * @param maxGrowthFactor the largest factor by which the time step grows from one step to the next
+     */
+    void useAdaptiveTimeStep(scalar maxDisplacement, scalar maxReactionProbability = .1, scalar minTimeStep = 0,
+                             scalar maxTimeStep = -1, scalar maxGrowthFactor = 2) {
+        if (maxDisplacement <= 0 || maxReactionProbability <= 0 || maxGrowthFactor < 1) {
+            throw std::invalid_argument(fmt::format(
+                    "Adaptive time stepping requires positive tolerances and a growth factor of at least one, got "
+                    "maxDisplacement={}, maxReactionProbability={}, maxGrowthFactor={}.",
+                    maxDisplacement, maxReactionProbability, maxGrowthFactor));
+        }
+        _adaptiveTimeStep = AdaptiveTimeStep{maxDisplacement, maxReactionProbability, minTimeStep,
+                                             maxTimeStep > 0 ? maxTimeStep : 10 * _timeStep, maxGrowthFactor};
+    }
+
+    [[nodiscard]] const std::optional<AdaptiveTimeStep> &adaptiveTimeStep() const {
+        return _adaptiveTimeStep;
+    }
+
+    /**
+     * The time step of the latest step, which differs from timeStep() only if adaptive time stepping is enabled.
+     * @return the latest time step
+     */
+    [[nodiscard]] scalar lastTimeStep() const {
+        return _lastTimeStep.value_or(_timeStep);
     }
 
     scalar &neighborListCutoff() {
@@ -251,6 +312,29 @@ public:
     void run(const continue_fun &continueFun) {
         validate(_timeStep);
         {
+            scalar maxRate = 0;
+            if (_adaptiveTimeStep) {
+                const auto &reactionRegistry = _kernel->context().reactions();
+                for (const auto *reaction : reactionRegistry.order1Flat()) {
+                    maxRate = std::max(maxRate, reaction->rate());
+                }
+                for (const auto *reaction : reactionRegistry.order2Flat()) {
+                    maxRate = std::max(maxRate, reaction->rate());
+                }
+                if (!std::dynamic_pointer_cast<model::actions::EulerBDIntegrator>(_integrator)) {
+                    throw std::logic_error("Adaptive time stepping requires an Euler Brownian dynamics integrator "
+                                           "which reports the drift speeds of the particles.");
+                }
+                if (outputGroup && !_timeStepsDataSet) {
+                    auto group = outputGroup->createGroup("time_steps");
+                    h5rd::dimensions fs = {timeStepsFlushStride};
+                    h5rd::dimensions dims = {h5rd::UNLIMITED_DIMS};
+                    _timeStepsDataSet = group.createDataSet<scalar>("data", fs, dims);
+                    _timeStepsTime = std::make_unique<model::observables::util::TimeSeriesWriter>(
+                            group, timeStepsFlushStride);
+                }
+            }
+            auto dt = lastTimeStep();
             bool requiresNeighborList = false;
             if (_initNeighborList) {
                 requiresNeighborList = _initNeighborList->cutoffDistance() > 0;
@@ -268,13 +352,29 @@ public:
             TimeStep t = _start;
             if(_makeCheckpoint) {
                 // this needs to happen before observables because observables can in principle influence the state
-                _makeCheckpoint->perform(t);
+                makeCheckpoint(t);
             }
             runEvaluateObservables(t);
             std::for_each(std::begin(_callbacks), std::end(_callbacks), [t](const auto &callback) {
                 callback(t);
             });
             while (continueFun(t)) {
+                if (_adaptiveTimeStep) {
+                    if (_lastTimeStep) dt = nextTimeStep(dt, maxRate);
+                    for (auto *action : {_integrator.get(), _reactions.get(),
+                                         static_cast<model::actions::TimeStepDependentAction *>(
+                                                 _topologyReactions.get())}) {
+                        if (action) action->setTimeStep(dt);
+                    }
+                    _lastTimeStep = dt;
+                    if (_timeStepsDataSet) {
+                        _pendingTimeSteps.push_back(dt);
+                        _pendingTimes.push_back(t);
+                        if (_pendingTimeSteps.size() >= timeStepsFlushStride) {
+                            writeTimeSteps();
+                        }
+                    }
+                }
                 runIntegrator();
                 if (requiresNeighborList) runUpdateNeighborList();
                 runReactions();
@@ -283,7 +383,7 @@ public:
                 runForces();
                 if(_makeCheckpoint && (t + 1) % _checkpointingStride == 0) {
                     // this needs to happen before observables because observables can in principle influence the state
-                    _makeCheckpoint->perform(t + 1);
+                    makeCheckpoint(t + 1);
                 }
                 runEvaluateObservables(t + 1);
                 std::for_each(std::begin(_callbacks), std::end(_callbacks), [t](const auto &callback) {
@@ -291,7 +391,17 @@ public:
                 });
                 ++t;
 
-                _kernel->stateModel().setTime(_kernel->stateModel().time() + _timeStep);
+                _kernel->stateModel().setTime(_kernel->stateModel().time() + (_adaptiveTimeStep ? dt : _timeStep));
+            }
+            if (_timeStepsDataSet) {
+                writeTimeSteps();
+            }
+            if (auto *writer = _kernel->asyncObservableWriter(); writer) {
+                writer->wait();
+            }
+            if (_timeStepsDataSet) {
+                _timeStepsDataSet->flush();
+                _timeStepsTime->flush();
             }
             if (requiresNeighborList) runClearNeighborList();
             _start = t;
@@ -349,6 +459,13 @@ public:
         description += fmt::format("Configured simulation loop with:\n");
         description += fmt::format("--------------------------------\n");
         description += fmt::format(" - timeStep = {}\n", _timeStep);
+        if (_adaptiveTimeStep) {
+            description += fmt::format(" - adaptive time step in [{}, {}] with maxDisplacement = {}, "
+                                       "maxReactionProbability = {}, maxGrowthFactor = {}\n",
+                                       _adaptiveTimeStep->minTimeStep, _adaptiveTimeStep->maxTimeStep,
+                                       _adaptiveTimeStep->maxDisplacement, _adaptiveTimeStep->maxReactionProbability,
+                                       _adaptiveTimeStep->maxGrowthFactor);
+        }
         description += fmt::format(" - evaluateObservables = {}\n", _evaluateObservables);
         description += fmt::format(" - progressOutputStride = {}\n", _progressOutputStride);
         description += fmt::format(" - context written to file = {}\n", static_cast<bool>(configGroup));
@@ -370,6 +487,60 @@ public:
     }
 
 protected:
+    static constexpr std::size_t timeStepsFlushStride = 1000;
+
+    /**
+     * The time step following a step of width dt under the bounds of the adaptive time stepping.
+     */
+    [[nodiscard]] scalar nextTimeStep(scalar dt, scalar maxRate) const {
+        const auto &bounds = *_adaptiveTimeStep;
+        auto next = std::min(bounds.maxTimeStep, bounds.maxGrowthFactor * dt);
+        // run() made sure that the integrator is an EulerBDIntegrator
+        const auto *integrator = static_cast<const model::actions::EulerBDIntegrator *>(_integrator.get());
+        const auto driftSpeed = integrator->maxDriftSpeed();
+        if (driftSpeed < 0) {
+            throw std::logic_error("The integrator did not report the drift speeds of the particles, adaptive time "
+                                   "stepping cannot bound the displacement due to forces.");
+        }
+        if (driftSpeed > 0) {
+            next = std::min(next, bounds.maxDisplacement / driftSpeed);
+        }
+        if (maxRate > 0) {
+            next = std::min(next, bounds.maxReactionProbability / maxRate);
+        }
+        return std::max(next, bounds.minTimeStep);
+    }
+
+    /**
+     * Writes the time steps collected since the last call, on the writer thread if there is one, as hdf5 must not
+     * be accessed concurrently.
+     */
+    void writeTimeSteps() {
+        if (_pendingTimeSteps.empty()) return;
+        const auto bytes = _pendingTimeSteps.size() * (sizeof(scalar) + sizeof(TimeStep));
+        auto write = [this, timeSteps = std::move(_pendingTimeSteps), times = std::move(_pendingTimes)]() {
+            _timeStepsDataSet->append({timeSteps.size()}, timeSteps.data());
+            _timeStepsTime->append(times);
+        };
+        _pendingTimeSteps.clear();
+        _pendingTimes.clear();
+        _pendingTimeSteps.reserve(timeStepsFlushStride);
+        _pendingTimes.reserve(timeStepsFlushStride);
+        if (auto *writer = _kernel->asyncObservableWriter(); writer) {
+            writer->submit(std::move(write), bytes);
+        } else {
+            write();
+        }
+    }
+
+    void makeCheckpoint(TimeStep t) {
+        // the checkpoint writes hdf5 on this thread, pending asynchronous writes have to be finished first
+        if (auto *writer = _kernel->asyncObservableWriter(); writer) {
+            writer->wait();
+        }
+        _makeCheckpoint->perform(t);
+    }
+
     model::Kernel *const _kernel;
     std::shared_ptr<model::actions::InitializeKernel> _initializeKernel{nullptr};
     std::shared_ptr<model::actions::TimeStepDependentAction> _integrator{nullptr};
@@ -381,6 +552,12 @@ protected:
     std::shared_ptr<model::actions::ClearNeighborList> _clearNeighborList{nullptr};
     std::shared_ptr<model::actions::MakeCheckpoint> _makeCheckpoint{nullptr};
     std::shared_ptr<h5rd::Group> configGroup{nullptr};
+    std::shared_ptr<h5rd::Group> outputGroup{nullptr};
+    std::unique_ptr<h5rd::DataSet> _timeStepsDataSet{nullptr};
+    std::unique_ptr<model::observables::util::TimeSeriesWriter> _timeStepsTime{nullptr};
+    // time steps and times not yet handed to the file, written in batches of timeStepsFlushStride
+    std::vector<scalar> _pendingTimeSteps{};
+    std::vector<TimeStep> _pendingTimes{};
 
     bool _evaluateObservables = true;
     TimeStep _start = 0;
@@ -390,6 +567,9 @@ protected:
     scalar _timeStep;
 
     std::vector<std::function<void(TimeStep)>> _callbacks;
+
+    std::optional<AdaptiveTimeStep> _adaptiveTimeStep{};
+    std::optional<scalar> _lastTimeStep{};
 };
 
 }
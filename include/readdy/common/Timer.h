@@ -42,7 +42,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 
 namespace readdy::util {
@@ -143,14 +146,36 @@ public:
 
     static std::string perfToJsonString();
 
+    /**
+     * The performance datum stored under the given name, it is created if not present. Must not be called
+     * concurrently, the returned reference is invalidated by clear().
+     * @param targetName the name
+     * @return the performance datum
+     */
+    static const PerformanceData &performanceData(const std::string &targetName);
+
     static void clear();
 
+    /**
+     * Whether fine grained timings are recorded, such as the time each thread spends in a balanced parallel loop.
+     * They are taken in hot loops and are therefore off by default.
+     * @return whether fine grained timings are recorded
+     */
+    static bool measureDetailed() {
+        return detailed.load(std::memory_order_relaxed);
+    }
+
+    static void setMeasureDetailed(bool measure) {
+        detailed.store(measure, std::memory_order_relaxed);
+    }
+
 private:
     bool measure{true};
     bool wasMeasured{false};
     const PerformanceData &target;
     std::chrono::high_resolution_clock::time_point begin;
     static std::unordered_map<std::string, PerformanceData> perf;
+    static std::atomic<bool> detailed;
 };
 
 }
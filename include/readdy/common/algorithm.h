@@ -47,6 +47,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <numeric>
+#include <memory_resource>
 
 #include "common.h"
 #include "../model/RandomProvider.h"
@@ -135,6 +137,194 @@ inline void performEvents(Events &events, const ShouldEvaluate &shouldEvaluate,
     }
 }
 
+/**
+ * Complete binary tree over a fixed number of non-negative weights. Inner nodes hold the sum of their children, so
+ * that updating a weight as well as drawing an index proportional to its weight are O(log n). Sums are recomputed
+ * from the children on every update (instead of adding differences), zeroed weights hence never leave round-off
+ * residue in the total.
+ * @tparam Weight the weight type
+ */
+template<typename Weight = scalar>
+class SumTree {
+public:
+    explicit SumTree(std::size_t n, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : _nLeaves(1), _nodes(resource) {
+        while (_nLeaves < n) _nLeaves <<= 1;
+        _nodes.resize(2 * _nLeaves, 0);
+    }
+
+    /**
+     * Assigns all weights at once in O(n).
+     * @param first iterator to the first weight, the range must not be longer than size()
+     * @param last iterator past the last weight
+     */
+    template<typename It>
+    void assign(It first, It last) {
+        std::fill(_nodes.begin(), _nodes.end(), 0);
+        std::copy(first, last, _nodes.begin() + _nLeaves);
+        for (auto i = _nLeaves - 1; i > 0; --i) {
+            _nodes[i] = _nodes[2 * i] + _nodes[2 * i + 1];
+        }
+    }
+
+    void set(std::size_t index, Weight weight) {
+        auto i = index + _nLeaves;
+        _nodes[i] = weight;
+        for (i >>= 1; i > 0; i >>= 1) {
+            _nodes[i] = _nodes[2 * i] + _nodes[2 * i + 1];
+        }
+    }
+
+    Weight get(std::size_t index) const {
+        return _nodes[index + _nLeaves];
+    }
+
+    Weight total() const {
+        return _nodes[1];
+    }
+
+    std::size_t size() const {
+        return _nLeaves;
+    }
+
+    /**
+     * Finds the index i with sum(w_0..w_{i-1}) <= x < sum(w_0..w_i). Subtrees of weight zero are never entered, as
+     * long as total() > 0 the returned index therefore has a positive weight even if x is off by round-off.
+     * @param x value in [0, total())
+     * @return the index
+     */
+    std::size_t find(Weight x) const {
+        std::size_t i = 1;
+        while (i < _nLeaves) {
+            const auto left = _nodes[2 * i];
+            const auto right = _nodes[2 * i + 1];
+            if ((x < left && left > 0) || right <= 0) {
+                i = 2 * i;
+            } else {
+                x -= left;
+                i = 2 * i + 1;
+            }
+        }
+        return i - _nLeaves;
+    }
+
+private:
+    std::size_t _nLeaves;
+    std::pmr::vector<Weight> _nodes;
+};
+
+/**
+ * Variant of performEvents that replaces the pairwise dependency predicate by keys: Two events depend on each other
+ * if they share at least one key (e.g., a particle index or a topology index). Events are drawn from a SumTree and an
+ * inverted key -> events index is used for disabling the dependents of an evaluated event, so that one step costs
+ * O(k log E) instead of O(E), where k is the number of events sharing a key with the evaluated one.
+ *
+ * Contrary to performEvents the events container is not reordered, postPerform receives the total number of events
+ * that have been deactivated so far.
+ *
+ * @param resource memory resource the event index and sum tree are allocated from
+ * @param events the events, each must provide a non-negative `rate`
+ * @param shouldEvaluate predicate deciding whether a drawn event is evaluated
+ * @param eventKeys maps an event to an iterable of (reasonably dense) std::size_t keys, duplicates are allowed
+ * @param evaluate evaluation of an event
+ * @param postPerform called after each evaluation
+ */
+template<typename Events, typename ShouldEvaluate, typename EventKeys, typename Evaluate,
+        typename PostPerform = std::function<void(typename Events::value_type, std::size_t)>>
+inline void performEventsIndexed(std::pmr::memory_resource *resource, Events &events,
+                                 const ShouldEvaluate &shouldEvaluate, const EventKeys &eventKeys,
+                                 const Evaluate &evaluate,
+                                 const PostPerform &postPerform = detail::noPostPerform<Events>) {
+    if (events.empty()) {
+        return;
+    }
+    const std::size_t nEvents = events.size();
+
+    // inverted index in compressed row storage: events of key k are eventsOfKey[offsets[k]..offsets[k+1])
+    std::pmr::vector<std::size_t> offsets(resource);
+    std::pmr::vector<std::size_t> eventsOfKey(resource);
+    {
+        std::size_t maxKey = 0;
+        for (const auto &event : events) {
+            for (auto key : eventKeys(event)) {
+                maxKey = std::max(maxKey, static_cast<std::size_t>(key));
+            }
+        }
+        offsets.resize(maxKey + 2, 0);
+        for (const auto &event : events) {
+            for (auto key : eventKeys(event)) {
+                ++offsets[key + 1];
+            }
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        eventsOfKey.resize(offsets.back());
+        std::pmr::vector<std::size_t> fill(offsets, resource);
+        for (std::size_t i = 0; i < nEvents; ++i) {
+            for (auto key : eventKeys(events[i])) {
+                eventsOfKey[fill[key]++] = i;
+            }
+        }
+    }
+
+    SumTree<scalar> tree (nEvents, resource);
+    {
+        std::pmr::vector<scalar> rates(resource);
+        rates.reserve(nEvents);
+        for (const auto &event : events) {
+            rates.push_back(event.rate);
+        }
+        tree.assign(rates.begin(), rates.end());
+    }
+    std::pmr::vector<char> active (nEvents, true, resource);
+    std::size_t nDeactivated = 0;
+
+    auto deactivate = [&](std::size_t i) {
+        if (active[i]) {
+            active[i] = false;
+            ++nDeactivated;
+            if (tree.get(i) > 0) {
+                tree.set(i, 0);
+            }
+        }
+    };
+
+    auto process = [&](std::size_t i) {
+        deactivate(i);
+        const auto &event = events[i];
+        if (shouldEvaluate(event)) {
+            evaluate(event);
+            for (auto key : eventKeys(event)) {
+                for (auto j = offsets[key]; j < offsets[key + 1]; ++j) {
+                    deactivate(eventsOfKey[j]);
+                }
+            }
+            postPerform(event, nDeactivated);
+        }
+    };
+
+    while (nDeactivated < nEvents && tree.total() > 0) {
+        const auto x = readdy::model::rnd::uniform_real<scalar>(0, tree.total());
+        process(tree.find(x));
+    }
+    // remaining events have zero rate, visit them in order
+    for (std::size_t i = 0; i < nEvents && nDeactivated < nEvents; ++i) {
+        if (active[i]) {
+            process(i);
+        }
+    }
+}
+
+/**
+ * Variant of performEventsIndexed which allocates from the default memory resource.
+ */
+template<typename Events, typename ShouldEvaluate, typename EventKeys, typename Evaluate,
+        typename PostPerform = std::function<void(typename Events::value_type, std::size_t)>>
+inline void performEventsIndexed(Events &events, const ShouldEvaluate &shouldEvaluate, const EventKeys &eventKeys,
+                                 const Evaluate &evaluate,
+                                 const PostPerform &postPerform = detail::noPostPerform<Events>) {
+    performEventsIndexed(std::pmr::get_default_resource(), events, shouldEvaluate, eventKeys, evaluate, postPerform);
+}
+
 template<typename ParticleContainer, typename EvaluateOnParticle, typename InteractionContainer,
         typename EvaluateOnInteraction, typename TopologyContainer, typename EvaluateOnTopology>
 inline void evaluateOnContainers(ParticleContainer &&particleContainer,
@@ -0,0 +1,113 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+
+/**
+ * Indices along space filling curves on a three dimensional integer grid. Sorting points by these indices keeps
+ * points that are close in space mostly close in the resulting order, which is used to improve the memory locality
+ * of particle data.
+ *
+ * @file space_filling_curve.h
+ * @brief Morton (Z-order) and Hilbert curve indices of 3D grid coordinates
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace readdy::util::sfc {
+
+/**
+ * The maximal number of bits per coordinate, so that the curve index of three coordinates fits into 64 bits.
+ */
+constexpr unsigned int maxBits = 21;
+
+/**
+ * The Morton index of a grid point, obtained by interleaving the bits of its coordinates.
+ * @param coordinates the grid coordinates, each smaller than 2^nBits
+ * @param nBits the number of bits per coordinate, at most maxBits
+ * @return the position along the Z-order curve
+ */
+inline std::uint64_t mortonIndex(const std::array<std::uint64_t, 3> &coordinates, unsigned int nBits = maxBits) {
+    std::uint64_t result = 0;
+    for (auto bit = nBits; bit-- > 0;) {
+        for (auto coordinate : coordinates) {
+            result = (result << 1u) | ((coordinate >> bit) & 1u);
+        }
+    }
+    return result;
+}
+
+/**
+ * The Hilbert index of a grid point. The coordinates are transformed into the transposed Hilbert index following
+ * J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004), whose bits are then interleaved. Unlike
+ * the Morton curve, consecutive indices always belong to adjacent grid points.
+ * @param coordinates the grid coordinates, each smaller than 2^nBits
+ * @param nBits the number of bits per coordinate, at most maxBits
+ * @return the position along the Hilbert curve
+ */
+inline std::uint64_t hilbertIndex(std::array<std::uint64_t, 3> coordinates, unsigned int nBits = maxBits) {
+    auto &x = coordinates;
+    const std::uint64_t m = std::uint64_t{1} << (nBits - 1);
+    // inverse undo
+    for (auto q = m; q > 1; q >>= 1u) {
+        const auto p = q - 1;
+        for (std::size_t i = 0; i < 3; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            } else {
+                const auto t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // gray encode
+    x[1] ^= x[0];
+    x[2] ^= x[1];
+    std::uint64_t t = 0;
+    for (auto q = m; q > 1; q >>= 1u) {
+        if (x[2] & q) t ^= q - 1;
+    }
+    for (auto &xi : x) {
+        xi ^= t;
+    }
+    return mortonIndex(x, nBits);
+}
+
+}
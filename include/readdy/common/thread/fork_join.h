@@ -0,0 +1,298 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Persistent fork-join runtime. A fixed team of worker threads sleeps until a parallel region is started, executes
+ * its statically partitioned share of the region together with the calling thread and signals completion. Starting
+ * a region does not allocate: the job is passed as a function pointer plus a pointer to the caller's (stack allocated)
+ * closure, partial results of reductions are kept in a per-thread slot array that only grows with the team size.
+ * For inhomogeneous work the *_dynamic variants take precomputed chunk boundaries which are claimed by the threads
+ * in order, so that idle threads keep taking over the remaining chunks. An exception thrown by the job on any thread
+ * does not cut the region short: all threads finish their share first, then the first exception is rethrown on the
+ * calling thread.
+ *
+ * @file fork_join.h
+ * @brief persistent fork-join runtime with parallel_for and parallel_reduce
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace readdy::util::thread {
+
+class fork_join {
+public:
+    /**
+     * Creates a team of nThreads threads, the calling thread counts as one of them.
+     * @param nThreads the team size
+     */
+    explicit fork_join(std::size_t nThreads = 1) {
+        resize(nThreads);
+    }
+
+    ~fork_join() {
+        stop();
+    }
+
+    fork_join(const fork_join &) = delete;
+    fork_join &operator=(const fork_join &) = delete;
+    fork_join(fork_join &&) = delete;
+    fork_join &operator=(fork_join &&) = delete;
+
+    /**
+     * @return the team size including the calling thread
+     */
+    [[nodiscard]] std::size_t size() const {
+        return _workers.size() + 1;
+    }
+
+    /**
+     * Changes the team size. Must not be called while a parallel region is running.
+     * @param nThreads the new team size, at least one
+     */
+    void resize(std::size_t nThreads) {
+        nThreads = std::max<std::size_t>(nThreads, 1);
+        if (nThreads == size() && !_workers.empty()) return;
+        stop();
+        _stop = false;
+        _workers.reserve(nThreads - 1);
+        for (std::size_t tid = 1; tid < nThreads; ++tid) {
+            _workers.emplace_back([this, tid, generation = _generation] { work(tid, generation); });
+        }
+    }
+
+    /**
+     * Invokes f(tid, begin, end) for a static partition of [begin, end) into size() contiguous chunks. Empty
+     * chunks are skipped. Returns once all chunks were processed, if f threw, the first exception is rethrown
+     * afterwards. Regions must not be nested.
+     */
+    template<typename F>
+    void parallel_for(std::size_t begin, std::size_t end, const F &f) {
+        if (end <= begin) return;
+        const auto n = end - begin;
+        const auto nThreads = size();
+        if (nThreads == 1 || n == 1) {
+            f(std::size_t{0}, begin, end);
+            return;
+        }
+        auto chunk = [&f, begin, n, nThreads](std::size_t tid) {
+            const auto chunkBegin = begin + (n * tid) / nThreads;
+            const auto chunkEnd = begin + (n * (tid + 1)) / nThreads;
+            if (chunkBegin != chunkEnd) f(tid, chunkBegin, chunkEnd);
+        };
+        run(chunk);
+    }
+
+    /**
+     * Partitions like parallel_for, each chunk produces a partial result via f(tid, begin, end). The partial
+     * results are combined in thread order with reduce, so that the result does not depend on the scheduling. init
+     * has to be the neutral element of reduce, it is also the partial result of empty chunks.
+     */
+    template<typename T, typename F, typename R>
+    T parallel_reduce(std::size_t begin, std::size_t end, T init, const F &f, const R &reduce) {
+        if (end <= begin) return init;
+        const auto nThreads = size();
+        std::vector<T> &partials = slots<T>(nThreads, init);
+        parallel_for(begin, end, [&](std::size_t tid, std::size_t b, std::size_t e) {
+            partials[tid] = f(tid, b, e);
+        });
+        T result = std::move(init);
+        for (std::size_t tid = 0; tid < nThreads; ++tid) {
+            result = reduce(std::move(result), partials[tid]);
+        }
+        return result;
+    }
+
+    /**
+     * Dynamically scheduled loop over the chunks [bounds[c], bounds[c+1]). Threads claim chunks one at a time from a
+     * shared counter until none are left, so that threads which finish their chunks early take over the remaining
+     * ones. Invokes f(tid, begin, end) for each non-empty chunk.
+     * @param bounds the chunk boundaries, nondecreasing and of size nChunks + 1
+     */
+    template<typename F>
+    void parallel_for_dynamic(const std::vector<std::size_t> &bounds, const F &f) {
+        parallel_for_chunks(bounds, [&f](std::size_t tid, std::size_t, std::size_t begin, std::size_t end) {
+            f(tid, begin, end);
+        });
+    }
+
+    /**
+     * Dynamically scheduled like parallel_for_dynamic, each chunk produces a partial result via f(tid, begin, end).
+     * The partials are stored per chunk and combined in chunk order, so that the result does not depend on which
+     * thread processed which chunk.
+     */
+    template<typename T, typename F, typename R>
+    T parallel_reduce_dynamic(const std::vector<std::size_t> &bounds, T init, const F &f, const R &reduce) {
+        if (bounds.size() < 2) return init;
+        const auto nChunks = bounds.size() - 1;
+        std::vector<T> &partials = slots<T>(nChunks, init);
+        parallel_for_chunks(bounds, [&](std::size_t tid, std::size_t chunk, std::size_t begin, std::size_t end) {
+            partials[chunk] = f(tid, begin, end);
+        });
+        T result = std::move(init);
+        for (std::size_t chunk = 0; chunk < nChunks; ++chunk) {
+            result = reduce(std::move(result), partials[chunk]);
+        }
+        return result;
+    }
+
+private:
+    template<typename F>
+    void parallel_for_chunks(const std::vector<std::size_t> &bounds, const F &f) {
+        if (bounds.size() < 2) return;
+        const auto nChunks = bounds.size() - 1;
+        if (size() == 1 || nChunks == 1) {
+            for (std::size_t chunk = 0; chunk < nChunks; ++chunk) {
+                if (bounds[chunk] != bounds[chunk + 1]) f(std::size_t{0}, chunk, bounds[chunk], bounds[chunk + 1]);
+            }
+            return;
+        }
+        _nextChunk.store(0, std::memory_order_relaxed);
+        auto claim = [this, &f, &bounds, nChunks](std::size_t tid) {
+            for (auto chunk = _nextChunk.fetch_add(1, std::memory_order_relaxed);
+                 chunk < nChunks; chunk = _nextChunk.fetch_add(1, std::memory_order_relaxed)) {
+                if (bounds[chunk] != bounds[chunk + 1]) f(tid, chunk, bounds[chunk], bounds[chunk + 1]);
+            }
+        };
+        run(claim);
+    }
+
+    template<typename F>
+    void run(const F &f) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _job = [](const void *closure, std::size_t tid) { (*static_cast<const F *>(closure))(tid); };
+            _closure = &f;
+            _pending = _workers.size();
+            ++_generation;
+        }
+        _wakeup.notify_all();
+        // the workers reference the closure on this stack frame, so they have to be waited for in any case
+        try {
+            f(0);
+        } catch (...) {
+            storeException(std::current_exception());
+        }
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this] { return _pending == 0; });
+            _closure = nullptr;
+            exception = std::exchange(_exception, nullptr);
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void storeException(std::exception_ptr exception) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_exception) {
+            _exception = std::move(exception);
+        }
+    }
+
+    void work(std::size_t tid, std::size_t seenGeneration) {
+        while (true) {
+            void (*job)(const void *, std::size_t);
+            const void *closure;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wakeup.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+                if (_stop) return;
+                seenGeneration = _generation;
+                job = _job;
+                closure = _closure;
+            }
+            try {
+                job(closure, tid);
+            } catch (...) {
+                storeException(std::current_exception());
+            }
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (--_pending == 0) {
+                    _done.notify_one();
+                }
+            }
+        }
+    }
+
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+        _workers.clear();
+    }
+
+    template<typename T>
+    std::vector<T> &slots(std::size_t n, const T &init) {
+        // one slot array per result type, shared by all teams of this type and only grown, never shrunk
+        thread_local std::vector<T> partials;
+        if (partials.size() < n) partials.resize(n, init);
+        std::fill(partials.begin(), partials.begin() + n, init);
+        return partials;
+    }
+
+    std::vector<std::thread> _workers {};
+    std::mutex _mutex {};
+    std::condition_variable _wakeup {};
+    std::condition_variable _done {};
+    std::size_t _generation {0};
+    std::size_t _pending {0};
+    bool _stop {false};
+    void (*_job)(const void *, std::size_t) {nullptr};
+    const void *_closure {nullptr};
+    std::exception_ptr _exception {};
+    std::atomic<std::size_t> _nextChunk {0};
+};
+
+}
@@ -63,15 +63,31 @@ public:
         BloscLZ, LZ4, LZ4HC, SNAPPY, ZLIB, ZSTD
     };
 
+    /**
+     * The available shuffle modes that are applied before compression.
+     */
+    enum ShuffleMode {
+        NoShuffle, ByteShuffle, BitShuffle
+    };
+
     /**
      * Creates a new BloscFilter instance.
      * @param compressor the backing compressor to use, by default the blosc internal LZ4 implementation
      * @param compressionLevel the compression level (0 is the lowest and 9 is the highest compression level)
-     * @param shuffle whether to perform bitshuffle
+     * @param shuffle whether to perform byte shuffle
      */
     explicit BloscFilter(Compressor compressor = Compressor::BloscLZ, unsigned int compressionLevel = 9,
                          bool shuffle = true);
 
+    /**
+     * Creates a new BloscFilter instance with an explicit shuffle mode. Bit shuffle pays off for integer data whose
+     * values only occupy the lower bits, e.g., quantized and delta encoded coordinates.
+     * @param compressor the backing compressor to use
+     * @param compressionLevel the compression level (0 is the lowest and 9 is the highest compression level)
+     * @param shuffle the shuffle mode
+     */
+    BloscFilter(Compressor compressor, unsigned int compressionLevel, ShuffleMode shuffle);
+
     /**
      * default destructor
      */
@@ -96,9 +112,9 @@ public:
 
 private:
     /**
-     * whether to perform bit shuffle
+     * the shuffle mode
      */
-    bool shuffle;
+    ShuffleMode shuffle;
     /**
      * the compressor to use
      */
@@ -149,6 +149,9 @@ public:
 
     std::vector<readdy::model::Particle> getParticles() const override;
 
+    void trajectorySnapshot(const std::vector<readdy::model::ParticleFlavor> &flavors,
+                            std::vector<readdy::model::observables::TrajectoryEntry> &entries) const override;
+
     std::vector<readdy::model::reactions::ReactionRecord>& reactionRecords() {
         return _observableData.reactionRecords;
     }
@@ -223,8 +226,7 @@ public:
 
     void insert_topology(topology&& top);
 
-    void toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                std::vector<std::size_t>::iterator end) const override;
+    [[nodiscard]] readdy::model::DenseParticleIndices denseParticleIndices() const override;
 
     std::vector<readdy::model::top::GraphTopology*> getTopologies() override;
 
@@ -64,6 +64,7 @@ public:
         const auto &box = context.boxSize().data();
         auto& stateModel = kernel->getSCPUKernelStateModel();
         const auto pd = stateModel.getParticleData();
+        scalar maxDriftSpeedSquared = 0;
         for(auto& entry : *pd) {
             if(!entry.is_deactivated()) {
                 const scalar D = context.particleTypes().diffusionConstantOf(entry.type);
@@ -72,9 +73,12 @@ public:
                 entry.pos += randomDisplacement;
                 const auto deterministicDisplacement = entry.force * _timeStep * D / kbt;
                 entry.pos += deterministicDisplacement;
+                const auto driftVelocity = entry.force * D / kbt;
+                maxDriftSpeedSquared = std::max(maxDriftSpeedSquared, driftVelocity * driftVelocity);
                 bcs::fixPosition(entry.pos, box, pbc);
             }
         }
+        _maxDriftSpeed = std::sqrt(maxDriftSpeedSquared);
     }
 
 private:
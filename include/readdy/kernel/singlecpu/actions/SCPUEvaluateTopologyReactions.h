@@ -45,6 +45,8 @@
 
 #pragma once
 
+#include <array>
+
 #include <readdy/model/actions/Actions.h>
 #include <readdy/kernel/singlecpu/SCPUKernel.h>
 
@@ -67,7 +69,7 @@ private:
 
     bool topologyDeactivated(std::size_t index) const;
 
-    bool eventsDependent(const TREvent& evt1, const TREvent& evt2) const;
+    std::array<std::size_t, 2> eventKeys(const TREvent &event) const;
 
     void handleStructuralReactionEvent(SCPUStateModel::topologies_vec &topologies,
                                        std::vector<SCPUStateModel::topology> &new_topologies,
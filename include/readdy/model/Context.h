@@ -52,6 +52,7 @@
 
 #include <array>
 #include <memory>
+#include <cstdint>
 #include <vector>
 #include <unordered_set>
 
@@ -215,6 +216,14 @@ public:
 
     void setKernelConfiguration(const std::string &jsonStr);
 
+    /**
+     * Process-wide unique id of this context's state, renewed whenever the context is assigned to. Caches derived
+     * from a context can compare it to notice a replaced context even if its registries have the same version counts.
+     */
+    std::uint64_t generation() const {
+        return _generation;
+    }
+
     Context();
 
     Context(Context &&rhs) noexcept;
@@ -233,6 +242,10 @@ private:
     // which has to be reset upon copy/move
     void setTypeRegistryReferences();
 
+    static std::uint64_t nextGeneration();
+
+    std::uint64_t _generation;
+
     ParticleTypeRegistry _particleTypeRegistry;
     reactions::ReactionRegistry _reactionRegistry;
     potentials::PotentialRegistry _potentialRegistry;
@@ -106,6 +106,7 @@ public:
      * @return an observable handle that allows for post-hoc modification of the observable
      */
     ObservableHandle registerObservable(std::unique_ptr<readdy::model::observables::ObservableBase> observable) {
+        observable->setAsyncWriter(_asyncObservableWriter.get());
         auto connection = connectObservable(observable.get());
         registeredObservables().push_back(std::move(observable));
         observableConnections().push_back(std::move(connection));
@@ -124,6 +125,41 @@ public:
         });
     }
 
+    /**
+     * Lets the registered observables hand their results to a writer thread instead of writing them into their files
+     * on the simulation thread, see observables::util::AsyncWriter.
+     * @param queueCapacity the number of pending writes after which evaluating observables blocks
+     */
+    void enableAsyncObservableWriter(std::size_t queueCapacity = 8) {
+        disableAsyncObservableWriter();
+        _asyncObservableWriter = std::make_unique<observables::util::AsyncWriter>(queueCapacity);
+        for (auto &observable : _observables) {
+            observable->setAsyncWriter(_asyncObservableWriter.get());
+        }
+    }
+
+    /**
+     * Finishes the pending writes and lets the registered observables write synchronously again.
+     */
+    void disableAsyncObservableWriter() {
+        for (auto &observable : _observables) {
+            observable->setAsyncWriter(nullptr);
+        }
+        _asyncObservableWriter.reset();
+    }
+
+    /**
+     * The writer thread of the registered observables.
+     * @return the writer or nullptr if the observables write synchronously
+     */
+    observables::util::AsyncWriter *asyncObservableWriter() {
+        return _asyncObservableWriter.get();
+    }
+
+    const observables::util::AsyncWriter *asyncObservableWriter() const {
+        return _asyncObservableWriter.get();
+    }
+
     /**
      * Evaluates all observables.
      */
@@ -232,6 +268,8 @@ protected:
     observables::signal_type _signal;
     ObservableContainer _observables{};
     ConnectionContainer _observableConnections{};
+    // declared after the observables, so that it finishes their pending writes before they are destroyed
+    std::unique_ptr<observables::util::AsyncWriter> _asyncObservableWriter{nullptr};
 };
 
 }
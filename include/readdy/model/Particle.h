@@ -109,6 +109,25 @@ public:
         return std::atomic_fetch_add<ParticleId>(&idCounter, 1);
     }
 
+    /**
+     * Reserves a range of consecutive ids from the global id counter.
+     * @param n the number of ids
+     * @return the first id of the range
+     */
+    static ParticleId reserveIds(std::size_t n) {
+        return std::atomic_fetch_add<ParticleId>(&idCounter, static_cast<ParticleId>(n));
+    }
+
+    /**
+     * Hands out ids from a block of idBlockSize ids that the calling thread reserved from the global counter, so that
+     * threads creating many particles touch the shared counter only once per block. The ids are unique, but ids
+     * handed out to different threads are not ordered by the time of their creation.
+     * @return the next id of the calling thread
+     */
+    static ParticleId nextThreadLocalId();
+
+    static constexpr std::size_t idBlockSize = 1024;
+
 protected:
     Vec3 _pos;
     ParticleTypeId _type;
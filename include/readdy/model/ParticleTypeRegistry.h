@@ -163,6 +163,18 @@ public:
         return type_mapping_;
     }
 
+    /**
+     * Dense lookup table of the particle flavors.
+     * @return a vector containing the flavor of each particle type at the type's id
+     */
+    std::vector<ParticleFlavor> flavors() const {
+        std::vector<ParticleFlavor> result(type_counter_, particleflavor::NORMAL);
+        for (const auto &[id, info] : particle_info_) {
+            result.at(id) = info.flavor;
+        }
+        return result;
+    }
+
     std::string describe() const;
 
 private:
@@ -35,7 +35,8 @@
 
 /**
  * The random provider can provide normal and uniform distributed random numbers. The choice of random generator
- * can be altered by template parameter. Current default: mt19937.
+ * can be altered by template parameter. Current default: mt19937. For draws in parallel regions that should not
+ * depend on the number of threads, CounterBasedStream provides Philox streams keyed by seed and stream identifier.
  *
  * @file RandomProvider.h
  * @brief Header file containing the definitions for readdy::model::RandomProvider.
@@ -44,11 +45,15 @@
  */
 
 #pragma once
+#include <array>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <random>
 #include <ctime>
 #include <thread>
 #include "readdy/common/common.h"
+#include "readdy/common/numeric.h"
 
 namespace readdy::model::rnd {
 
@@ -61,32 +66,48 @@ Generator randomlySeededGenerator() {
     return Generator(seed);
 }
 
+/**
+ * The calling thread's generator of the given type, which is shared by the free functions of this namespace.
+ * @return reference to the generator
+ */
+template<typename Generator = std::mt19937>
+Generator &threadGenerator() {
+    static thread_local auto generator = randomlySeededGenerator<Generator>();
+    return generator;
+}
+
+/**
+ * Seeds the calling thread's generator, so that subsequent draws of this thread are reproducible.
+ * @param seed the seed
+ */
+template<typename Generator = std::mt19937>
+void seedThreadGenerator(std::uint64_t seed) {
+    std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32u)};
+    threadGenerator<Generator>().seed(seq);
+}
+
 template<typename RealType=scalar, typename Generator = std::mt19937>
 RealType normal(const RealType mean = 0.0, const RealType variance = 1.0) {
-    static thread_local auto generator = randomlySeededGenerator<Generator>();
     std::normal_distribution<RealType> distribution(mean, variance);
-    return distribution(generator);
+    return distribution(threadGenerator<Generator>());
 }
 
 template<typename RealType=scalar, typename Generator = std::mt19937>
 RealType uniform_real(const RealType a = 0.0, const RealType b = 1.0) {
-    static thread_local auto generator = randomlySeededGenerator<Generator>();
     std::uniform_real_distribution<RealType> distribution(a, b);
-    return distribution(generator);
+    return distribution(threadGenerator<Generator>());
 }
 
 template<typename IntType=int, typename Generator = std::mt19937>
 IntType uniform_int(const IntType a, const IntType b) {
-    static thread_local auto generator = randomlySeededGenerator<Generator>();
     std::uniform_int_distribution<IntType> distribution(a, b);
-    return distribution(generator);
+    return distribution(threadGenerator<Generator>());
 }
 
 template<typename RealType=scalar, typename Generator = std::mt19937>
 RealType exponential(RealType lambda = 1.0) {
-    static thread_local auto generator = randomlySeededGenerator<Generator>();
     std::exponential_distribution<RealType> distribution(lambda);
-    return distribution(generator);
+    return distribution(threadGenerator<Generator>());
 }
 
 template<typename scalar, typename Generator = std::mt19937>
@@ -96,6 +117,213 @@ Vec3 normal3(const scalar mean = 0.0, const scalar variance = 1.0) {
             normal<scalar, Generator>(mean, variance)};
 }
 
+/**
+ * Philox4x32-10 counter-based random number generator, see Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", SC'11. Maps a 128 bit counter and a 64 bit key bijectively to 128 random bits, so that independent streams can
+ * be addressed directly by their counter instead of carrying generator state around.
+ */
+struct Philox4x32 {
+    using counter_type = std::array<std::uint32_t, 4>;
+    using key_type = std::array<std::uint32_t, 2>;
+
+    static counter_type generate(counter_type counter, key_type key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            const auto product0 = static_cast<std::uint64_t>(0xD2511F53u) * counter[0];
+            const auto product1 = static_cast<std::uint64_t>(0xCD9E8D57u) * counter[2];
+            counter = {{static_cast<std::uint32_t>(product1 >> 32u) ^ counter[1] ^ key[0],
+                        static_cast<std::uint32_t>(product1),
+                        static_cast<std::uint32_t>(product0 >> 32u) ^ counter[3] ^ key[1],
+                        static_cast<std::uint32_t>(product0)}};
+        }
+        return counter;
+    }
+};
+
+/**
+ * Stream of random numbers which is fully determined by a 64 bit seed and a 96 bit stream identifier, e.g.,
+ * (epoch, particle id, purpose). Streams with different identifiers are independent, so that draws keyed by
+ * particle instead of by thread do not depend on the number of threads or the scheduling. Satisfies the
+ * UniformRandomBitGenerator requirements and can be used with the distributions and algorithms of the standard
+ * library.
+ */
+class CounterBasedStream {
+public:
+    using result_type = std::uint32_t;
+
+    CounterBasedStream(std::uint64_t seed, std::uint32_t id0, std::uint32_t id1, std::uint32_t id2)
+            : _key{{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32u)}},
+              _counter{{id0, id1, id2, 0}} {}
+
+    /**
+     * Stream identified by a 32 bit word, e.g., an epoch, and a 64 bit word, e.g., a particle id.
+     */
+    CounterBasedStream(std::uint64_t seed, std::uint32_t id0, std::uint64_t id1)
+            : CounterBasedStream(seed, id0, static_cast<std::uint32_t>(id1), static_cast<std::uint32_t>(id1 >> 32u)) {}
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (_position == 4) {
+            _block = Philox4x32::generate(_counter, _key);
+            ++_counter[3];
+            _position = 0;
+        }
+        return _block[_position++];
+    }
+
+    /**
+     * @return a uniformly distributed number in the open interval (0, 1) with 64 bits of randomness
+     */
+    template<typename RealType = scalar>
+    RealType uniform() {
+        const auto bits = (static_cast<std::uint64_t>((*this)()) << 32u) | (*this)();
+        // 53 bits, offset by half a unit so that neither zero nor one is attained
+        return static_cast<RealType>((static_cast<double>(bits >> 11u) + .5) * 0x1.0p-53);
+    }
+
+    /**
+     * Three standard normal numbers from one Philox block via the Box-Muller transform.
+     * @return normally distributed vector with zero mean and unit variance per component
+     */
+    Vec3 normal3() {
+        std::array<scalar, 4> u {};
+        for (auto &ui : u) {
+            ui = (static_cast<scalar>((*this)()) + static_cast<scalar>(.5)) * static_cast<scalar>(0x1.0p-32);
+        }
+        const auto twoPi = 2 * readdy::util::numeric::pi<scalar>();
+        const auto r0 = std::sqrt(-2 * std::log(u[0]));
+        const auto r1 = std::sqrt(-2 * std::log(u[2]));
+        return {r0 * std::cos(twoPi * u[1]), r0 * std::sin(twoPi * u[1]), r1 * std::cos(twoPi * u[3])};
+    }
+
+    /**
+     * Binomially distributed number of successes in n trials with success probability p. Unlike
+     * std::binomial_distribution, whose algorithm is implementation-defined, the result only depends on the stream,
+     * so that it is reproducible across standard libraries. Uses inversion if the mode is small and the
+     * transformed rejection of Hoermann (BTRD) otherwise.
+     */
+    std::size_t binomial(std::size_t n, double p) {
+        if (n == 0 || p <= 0) return 0;
+        if (p >= 1) return n;
+        if (p > .5) return n - binomial(n, 1 - p);
+        const auto nd = static_cast<double>(n);
+        if (std::floor((nd + 1) * p) < 11) {
+            return binomialInversion(n, p);
+        }
+        return binomialBTRD(n, p);
+    }
+
+private:
+    std::size_t binomialInversion(std::size_t n, double p) {
+        const auto q = 1 - p;
+        const auto s = p / q;
+        const auto a = (static_cast<double>(n) + 1) * s;
+        // the mode is below 11, so that q^n stays well above the smallest double
+        auto r = std::exp(static_cast<double>(n) * std::log1p(-p));
+        auto u = uniform<double>();
+        std::size_t x = 0;
+        while (u > r && x < n) {
+            u -= r;
+            ++x;
+            const auto next = (a / static_cast<double>(x) - s) * r;
+            // the probabilities decay exponentially beyond the mode, the remaining mass is negligible
+            if (next < std::numeric_limits<double>::epsilon() && next < r) break;
+            r = next;
+        }
+        return x;
+    }
+
+    std::size_t binomialBTRD(std::size_t n, double p) {
+        const auto nd = static_cast<double>(n);
+        const auto m = std::floor((nd + 1) * p);
+        const auto r = p / (1 - p);
+        const auto nr = (nd + 1) * r;
+        const auto npq = nd * p * (1 - p);
+        const auto sqrtNpq = std::sqrt(npq);
+        const auto b = 1.15 + 2.53 * sqrtNpq;
+        const auto a = -0.0873 + 0.0248 * b + 0.01 * p;
+        const auto c = nd * p + 0.5;
+        const auto alpha = (2.83 + 5.1 / b) * sqrtNpq;
+        const auto vr = 0.92 - 4.2 / b;
+        const auto urvr = 0.86 * vr;
+
+        while (true) {
+            auto v = uniform<double>();
+            double u;
+            if (v <= urvr) {
+                u = v / vr - 0.43;
+                return static_cast<std::size_t>(std::floor((2 * a / (0.5 - std::abs(u)) + b) * u + c));
+            }
+            if (v >= vr) {
+                u = uniform<double>() - 0.5;
+            } else {
+                u = v / vr - 0.93;
+                u = (u < 0 ? -0.5 : 0.5) - u;
+                v = uniform<double>() * vr;
+            }
+            const auto us = 0.5 - std::abs(u);
+            const auto k = std::floor((2 * a / us + b) * u + c);
+            if (k < 0 || k > nd) continue;
+            v = v * alpha / (a / (us * us) + b);
+            const auto km = std::abs(k - m);
+            if (km <= 15) {
+                // recursive evaluation of f(k) / f(m)
+                double f = 1;
+                if (m < k) {
+                    for (auto i = m + 1; i <= k; ++i) f *= nr / i - r;
+                } else if (m > k) {
+                    for (auto i = k + 1; i <= m; ++i) v *= nr / i - r;
+                }
+                if (v <= f) return static_cast<std::size_t>(k);
+                continue;
+            }
+            // squeeze, then the final acceptance test with Stirling's approximation
+            v = std::log(v);
+            const auto rho = (km / npq) * (((km / 3. + 0.625) * km + 1. / 6) / npq + 0.5);
+            const auto t = -km * km / (2 * npq);
+            if (v < t - rho) return static_cast<std::size_t>(k);
+            if (v > t + rho) continue;
+            const auto nm = nd - m + 1;
+            const auto h = (m + 0.5) * std::log((m + 1) / (r * nm)) + stirlingCorrection(m)
+                           + stirlingCorrection(nd - m);
+            const auto nk = nd - k + 1;
+            if (v <= h + (nd + 1) * std::log(nm / nk) + (k + 0.5) * std::log(nk * r / (k + 1))
+                      - stirlingCorrection(k) - stirlingCorrection(nd - k)) {
+                return static_cast<std::size_t>(k);
+            }
+        }
+    }
+
+    /**
+     * @return log(k!) - ((k + 1/2) log(k + 1) - (k + 1) + log(2 pi) / 2)
+     */
+    static double stirlingCorrection(double k) {
+        static constexpr std::array<double, 10> table {{
+            0.08106146679532726, 0.04134069595540929, 0.02767792568499834, 0.02079067210376509,
+            0.01664469118982119, 0.01387612882307075, 0.01189670994589177, 0.01041126526197209,
+            0.009255462182712733, 0.008330563433362871
+        }};
+        if (k < 10) return table[static_cast<std::size_t>(k)];
+        const auto ik = 1. / (k + 1);
+        return (1. / 12 - (1. / 360 - 1. / 1260 * (ik * ik)) * (ik * ik)) * ik;
+    }
+
+    Philox4x32::key_type _key;
+    Philox4x32::counter_type _counter;
+    Philox4x32::counter_type _block {};
+    std::size_t _position {4};
+};
+
 template<typename Iter, typename Gen = std::mt19937>
 Iter random_element(Iter start, const Iter end) {
     using IntType = typename std::iterator_traits<Iter>::difference_type;
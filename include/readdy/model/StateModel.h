@@ -44,12 +44,41 @@
 
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <readdy/model/topologies/GraphTopology.h>
+#include <readdy/model/observables/io/TrajectoryEntry.h>
 #include "Particle.h"
 #include "readdy/common/ReaDDyVec3.h"
 
 namespace readdy::model {
 
+/**
+ * Maps indices into a kernel's particle storage to dense indices, i.e., to positions in StateModel::getParticles(), by
+ * subtracting the number of blanks in front of them. The blanks are sorted once, so that each conversion is a binary
+ * search. Meant to be built once and shared when converting many indices, e.g., of all topologies.
+ */
+class DenseParticleIndices {
+public:
+    DenseParticleIndices() = default;
+
+    template<typename It>
+    DenseParticleIndices(It blanksBegin, It blanksEnd) : _blanks(blanksBegin, blanksEnd) {
+        std::sort(_blanks.begin(), _blanks.end());
+    }
+
+    [[nodiscard]] std::size_t operator()(std::size_t index) const {
+        auto nBlanksBefore = std::lower_bound(_blanks.begin(), _blanks.end(), index) - _blanks.begin();
+        return index - static_cast<std::size_t>(nBlanksBefore);
+    }
+
+    void apply(std::vector<std::size_t>::iterator begin, std::vector<std::size_t>::iterator end) const {
+        std::transform(begin, end, begin, *this);
+    }
+
+private:
+    std::vector<std::size_t> _blanks;
+};
+
 class StateModel {
 public:
 
@@ -74,6 +103,15 @@ public:
 
     [[nodiscard]] virtual ParticleTypeId getParticleType(std::size_t index) const = 0;
 
+    /**
+     * Writes the active particles into a buffer of trajectory entries, in the same order as getParticles(). Kernels
+     * override this to fill the buffer directly from their particle data instead of materializing the particles.
+     * @param flavors the flavor of each particle type id, see ParticleTypeRegistry::flavors()
+     * @param entries the buffer, it is resized to the number of active particles
+     */
+    virtual void trajectorySnapshot(const std::vector<ParticleFlavor> &flavors,
+                                    std::vector<observables::TrajectoryEntry> &entries) const;
+
     /**
      * Initialize the neighbor list such that all particle-particle interactions
      * that are shorter than the given interactionDistance can be considered. Usually this distance is the largest cutoff distance
@@ -111,8 +149,15 @@ public:
 
     virtual void setTime(scalar t) = 0;
 
-    virtual void toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                        std::vector<std::size_t>::iterator end) const = 0;
+    /**
+     * @return the mapping from particle indices to dense particle indices for the current particle storage
+     */
+    [[nodiscard]] virtual DenseParticleIndices denseParticleIndices() const = 0;
+
+    void toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
+                                std::vector<std::size_t>::iterator end) const {
+        denseParticleIndices().apply(begin, end);
+    }
 
     virtual void clear() = 0;
 };
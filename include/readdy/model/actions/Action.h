@@ -74,6 +74,12 @@ public:
 
     [[nodiscard]] scalar timeStep() const { return _timeStep; }
 
+    /**
+     * Changes the time step of subsequent invocations, used by adaptive time stepping.
+     * @param timeStep the new time step
+     */
+    void setTimeStep(scalar timeStep) { _timeStep = timeStep; }
+
 protected:
     scalar _timeStep;
 };
@@ -97,6 +97,16 @@ public:
     explicit EulerBDIntegrator(scalar timeStep);
 
     ~EulerBDIntegrator() override = default;
+
+    /**
+     * The largest deterministic drift speed D |F| / kT of a particle in the last invocation, so that D |F| / kT dt
+     * is the largest displacement due to forces. Negative if the integrator does not keep track of it.
+     * @return the maximal drift speed
+     */
+    [[nodiscard]] scalar maxDriftSpeed() const { return _maxDriftSpeed; }
+
+protected:
+    scalar _maxDriftSpeed {-1};
 };
 
 class MdgfrdIntegrator : public TimeStepDependentAction {
@@ -73,7 +73,7 @@ protected:
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     std::vector<scalar> binBorders;
     std::set<ParticleTypeId> typesToCount;
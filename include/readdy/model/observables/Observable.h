@@ -65,6 +65,7 @@
 #include <readdy/common/logging.h>
 #include <readdy/common/tuple_utils.h>
 #include <readdy/common/ReaDDyVec3.h>
+#include <readdy/model/observables/io/AsyncWriter.h>
 
 namespace readdy::model {
 class Kernel;
@@ -166,10 +167,29 @@ public:
     }
 
     /**
-     * Write now! Only has an effect if writing to file was enabled, see enableWriteToFile().
+     * Write now! Only has an effect if writing to file was enabled, see enableWriteToFile(). If the observable writes
+     * asynchronously, the pending writes have to be drained first, see waitForPendingWrites().
      */
     virtual void flush() = 0;
 
+    /**
+     * Blocks until the results that were handed to the asynchronous writer are written.
+     */
+    void waitForPendingWrites() {
+        if (asyncWriter) {
+            asyncWriter->wait();
+        }
+    }
+
+    /**
+     * Sets the writer thread to which the results are handed instead of being written on the calling thread.
+     * @param writer the writer, nullptr for synchronous writes
+     */
+    void setAsyncWriter(util::AsyncWriter *writer) {
+        waitForPendingWrites();
+        asyncWriter = writer;
+    }
+
     virtual std::string_view type() const = 0;
 
     void writeCurrentResult() {
@@ -223,6 +243,10 @@ protected:
      * this is only initially true and otherwise false
      */
     bool firstCall = true;
+    /**
+     * the writer thread if results are written asynchronously, otherwise nullptr
+     */
+    util::AsyncWriter *asyncWriter = nullptr;
 };
 
 /**
@@ -282,6 +306,35 @@ public:
     }
 
 protected:
+    /**
+     * Writes the result into the file, either directly or by handing a copy of it to the asynchronous writer.
+     */
+    void append() override {
+        if (asyncWriter) {
+            if (!_buffers) {
+                _buffers = std::make_unique<util::BufferPool<Result>>();
+            }
+            auto *snapshot = _buffers->acquire();
+            // copy assignment reuses the capacity of the recycled buffer
+            *snapshot = result;
+            asyncWriter->submit([this, snapshot, t = t_current]() {
+                write(*snapshot, t);
+                _buffers->release(snapshot);
+            }, util::byteSize(result));
+        } else {
+            write(result, t_current);
+        }
+    }
+
+    /**
+     * Writes a result into the data sets that were created in initializeDataSet(). Might be called on the writer
+     * thread, in which case it must neither access the observable's result nor the kernel's state model. The
+     * snapshot is not const as variable length data sets take their data by pointer.
+     * @param snapshot the result
+     * @param t the time step at which it was evaluated
+     */
+    virtual void write(Result &snapshot, TimeStep t) = 0;
+
     /**
      * the result variable, storing the current state
      */
@@ -290,6 +343,10 @@ protected:
      * the callback function
      */
     CallbackFunction _callback = [](const Result /*unused*/) {};
+    /**
+     * recycled buffers of the results that are handed to the asynchronous writer
+     */
+    std::unique_ptr<util::BufferPool<Result>> _buffers {nullptr};
 };
 
 /**
@@ -351,7 +408,7 @@ protected:
     /**
      * Not supported, see flush().
      */
-    void append() override {
+    void write(RESULT &, TimeStep) override {
         throw std::runtime_error("not supported for combiner observables");
     }
 
@@ -189,6 +189,14 @@ public:
         return std::move(obs);
     }
 
+    [[nodiscard]] std::unique_ptr<CompactTrajectory> compactTrajectory(Stride stride, scalar precision,
+                                                                      std::size_t keyframeInterval = 100,
+                                                                      ObsCallback<CompactTrajectory> callback = [](const CompactTrajectory::result_type&){}) const {
+        auto obs = std::make_unique<CompactTrajectory>(kernel, stride, precision, keyframeInterval);
+        obs->setCallback(callback);
+        return std::move(obs);
+    }
+
     [[nodiscard]] std::unique_ptr<Topologies> topologies(Stride stride, ObsCallback<Topologies> callback = [](const Topologies::result_type&){}) const {
         auto obs = std::make_unique<Topologies>(kernel, stride);
         obs->setCallback(callback);
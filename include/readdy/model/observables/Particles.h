@@ -72,7 +72,7 @@ public:
 protected:
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     struct Impl;
     std::unique_ptr<Impl> pimpl;
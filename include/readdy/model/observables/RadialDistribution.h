@@ -46,6 +46,7 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <readdy/io/BloscFilter.h>
 #include "Observable.h"
 
@@ -75,14 +76,47 @@ protected:
 
     void setBinBorders(const std::vector<scalar> &binBorders);
 
+    /**
+     * Determines the bin of a pair distance. If the bins are uniform (up to floating point noise), the bin is computed
+     * directly and only corrected at the bin borders, otherwise it is found by binary search.
+     * @param distance the distance
+     * @return the bin index, such that binBorders[i] <= distance < binBorders[i+1], or counts.size() if the distance
+     *         is not covered by the bins
+     */
+    std::size_t binOf(scalar distance) const {
+        const auto nBins = counts.size();
+        if (nBins == 0 || distance < binBorders.front() || distance >= binBorders.back()) {
+            return nBins;
+        }
+        if (uniformBins) {
+            auto bin = std::min(static_cast<std::size_t>((distance - binBorders.front()) / binWidth), nBins - 1);
+            if (distance < binBorders[bin]) {
+                --bin;
+            } else if (distance >= binBorders[bin + 1]) {
+                ++bin;
+            }
+            return bin;
+        }
+        auto upperBound = std::upper_bound(binBorders.begin(), binBorders.end(), distance);
+        return static_cast<std::size_t>(upperBound - binBorders.begin()) - 1;
+    }
+
+    /**
+     * Converts the pair counts into the radial distribution function of the result.
+     * @param nFromParticles the number of particles of a type in typeCountFrom
+     */
+    void normalize(std::size_t nFromParticles);
+
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     struct Impl;
     std::unique_ptr<Impl> pimpl;
     std::vector<scalar> binBorders;
     std::vector<scalar> counts;
+    bool uniformBins{false};
+    scalar binWidth{0};
     std::vector<ParticleTypeId> typeCountFrom, typeCountTo;
     scalar particleToDensity;
     io::BloscFilter bloscFilter;
@@ -0,0 +1,217 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Writer thread for the output of observables. Observables hand a snapshot of their result to the writer through a
+ * bounded queue instead of appending to their data sets on the simulation thread, so that compression and hdf5 IO
+ * overlap with the simulation. The snapshots are kept in recycled buffers, see BufferPool. All jobs run on the same
+ * thread in submission order, hence the data sets are never accessed concurrently by the writer.
+ *
+ * @file AsyncWriter.h
+ * @brief Asynchronous writer thread for observables
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#pragma once
+
+#include <tuple>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <exception>
+#include <type_traits>
+#include <unordered_map>
+#include <condition_variable>
+
+namespace readdy::model::observables::util {
+
+class AsyncWriter {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Statistics of the writes that were performed so far.
+     */
+    struct Statistics {
+        /**
+         * number of finished jobs
+         */
+        std::size_t nWrites {0};
+        /**
+         * (approximate) size of the data that was handed to the writer in bytes
+         */
+        std::size_t bytes {0};
+        /**
+         * seconds spent by the writer thread in performing jobs, i.e., in compression and IO
+         */
+        double writeTime {0};
+        /**
+         * seconds the submitting thread was blocked, either by a full queue or by waiting for the queue to drain
+         */
+        double waitTime {0};
+    };
+
+    /**
+     * Starts the writer thread.
+     * @param capacity the number of jobs that can be pending before submit() blocks
+     */
+    explicit AsyncWriter(std::size_t capacity = 8);
+
+    /**
+     * Drains the queue and joins the writer thread.
+     */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter &) = delete;
+
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+    AsyncWriter(AsyncWriter &&) = delete;
+
+    AsyncWriter &operator=(AsyncWriter &&) = delete;
+
+    /**
+     * Enqueues a job, blocks while the queue is full. Rethrows the exception of a previously failed job.
+     * @param job the job
+     * @param bytes size of the data written by the job, only used for the statistics
+     */
+    void submit(Job job, std::size_t bytes = 0);
+
+    /**
+     * Blocks until all submitted jobs have been performed. Rethrows the exception of a failed job.
+     */
+    void wait();
+
+    std::size_t capacity() const {
+        return _capacity;
+    }
+
+    Statistics statistics() const;
+
+private:
+    void run();
+
+    void rethrow();
+
+    std::size_t _capacity;
+    mutable std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::condition_variable _idle;
+    std::deque<std::pair<Job, std::size_t>> _queue;
+    bool _busy {false};
+    bool _stop {false};
+    std::exception_ptr _error {nullptr};
+    Statistics _statistics {};
+    std::thread _thread;
+};
+
+/**
+ * Pool of buffers that are handed out to the writer and returned once the job is done, so that a steady stream of
+ * snapshots does not allocate. Acquire and release may be called from different threads.
+ */
+template<typename T>
+class BufferPool {
+public:
+    T *acquire() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_free.empty()) {
+            _buffers.push_back(std::make_unique<T>());
+            return _buffers.back().get();
+        }
+        auto *buffer = _free.back();
+        _free.pop_back();
+        return buffer;
+    }
+
+    void release(T *buffer) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(buffer);
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<T>> _buffers;
+    std::vector<T *> _free;
+};
+
+namespace detail {
+template<typename T>
+struct is_vector : std::false_type {};
+template<typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+template<typename T>
+struct is_tuple : std::false_type {};
+template<typename... T>
+struct is_tuple<std::tuple<T...>> : std::true_type {};
+template<typename T>
+struct is_unordered_map : std::false_type {};
+template<typename... T>
+struct is_unordered_map<std::unordered_map<T...>> : std::true_type {};
+}
+
+/**
+ * Approximate size of an observable's result in bytes, nested vectors and tuples are traversed, everything else
+ * accounts for its sizeof.
+ */
+template<typename T>
+std::size_t byteSize(const T &value) {
+    if constexpr (detail::is_vector<T>::value) {
+        using value_type = typename T::value_type;
+        if constexpr (detail::is_vector<value_type>::value || detail::is_tuple<value_type>::value) {
+            std::size_t result = 0;
+            for (const auto &element : value) {
+                result += byteSize(element);
+            }
+            return result;
+        } else {
+            return value.size() * sizeof(value_type);
+        }
+    } else if constexpr (detail::is_tuple<T>::value) {
+        return std::apply([](const auto &... elements) { return (std::size_t{0} + ... + byteSize(elements)); }, value);
+    } else if constexpr (detail::is_unordered_map<T>::value) {
+        return value.size() * sizeof(typename T::value_type);
+    } else {
+        return sizeof(T);
+    }
+}
+
+}
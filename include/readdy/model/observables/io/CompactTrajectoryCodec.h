@@ -0,0 +1,379 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+/**
+ * Encoding of the compact trajectory format. Positions are quantized on a regular grid with spacing `precision`
+ * anchored at the lower corner of the simulation box and stored as zigzag encoded 32 bit integers, so that small
+ * values only occupy the lower bits and compress well under bit shuffle. On keyframes the grid coordinates are stored
+ * as they are, between keyframes the difference to the previous frame's grid coordinates is stored. Frame `i` is a
+ * keyframe if `i % keyframeInterval == 0`.
+ *
+ * The particles are stored in an order of their own which does not depend on the order of the particle data: it is
+ * kept from frame to frame, removed particles are dropped from it and new particles are appended. Each frame carries
+ * the change of the particle set as a ParticleSetDelta, keyframes carry the complete particle set instead. Reactions
+ * and reorderings of the particle data therefore neither force keyframes nor a rewrite of all ids and types.
+ *
+ * @file CompactTrajectoryCodec.h
+ * @brief Encoder and decoder for the quantized, delta encoded compact trajectory format
+ * @author clonker
+ * @date 17.10.26
+ * @copyright BSD-3
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <readdy/common/common.h>
+#include "TrajectoryEntry.h"
+
+namespace readdy::model::observables::util {
+
+namespace compact {
+/**
+ * Grid coordinates are restricted to this magnitude so that differences between two frames still fit 32 bits.
+ */
+static constexpr std::int64_t maxGridCoordinate = std::int64_t{1} << 30;
+
+inline std::uint32_t zigzag(std::int32_t value) {
+    return (static_cast<std::uint32_t>(value) << 1u) ^ static_cast<std::uint32_t>(value >> 31);
+}
+
+inline std::int32_t unzigzag(std::uint32_t value) {
+    return static_cast<std::int32_t>(value >> 1u) ^ -static_cast<std::int32_t>(value & 1u);
+}
+
+inline void validate(scalar precision, const std::array<scalar, 3> &extent) {
+    if (!(precision > 0)) {
+        throw std::invalid_argument(fmt::format("The precision of a compact trajectory must be positive "
+                                                "but was {}", precision));
+    }
+    for (std::size_t d = 0; d < 3; ++d) {
+        if (extent[d] / precision >= static_cast<scalar>(maxGridCoordinate)) {
+            throw std::invalid_argument(fmt::format("A precision of {} is too fine for a box extent of {}, the "
+                                                    "grid coordinates would not fit 32 bits", precision, extent[d]));
+        }
+    }
+}
+}
+
+/**
+ * Change of the particle set from one frame to the next. Indices refer to the particle order of the previous frame.
+ * The types of the changed particles are replaced, then the removed particles are dropped (their indices are
+ * ascending), then the added particles are appended. On keyframes only the added particles are set and they form the
+ * complete particle set.
+ */
+struct ParticleSetDelta {
+    std::vector<std::size_t> removed;
+    std::vector<std::size_t> changed;
+    std::vector<ParticleTypeId> changedTypes;
+    std::vector<ParticleId> addedIds;
+    std::vector<ParticleTypeId> addedTypes;
+
+    void clear() {
+        removed.clear();
+        changed.clear();
+        changedTypes.clear();
+        addedIds.clear();
+        addedTypes.clear();
+    }
+};
+
+class CompactTrajectoryEncoder {
+public:
+    /**
+     * Creates a new encoder
+     * @param precision the grid spacing, the maximal reconstruction error per coordinate is precision / 2
+     * @param origin the anchor of the grid, usually the lower corner of the simulation box
+     * @param keyframeInterval a frame with absolute grid coordinates is stored at least every keyframeInterval frames
+     */
+    CompactTrajectoryEncoder(scalar precision, const Vec3 &origin, std::size_t keyframeInterval)
+            : _precision(precision), _origin(origin), _keyframeInterval(std::max<std::size_t>(1, keyframeInterval)) {}
+
+    /**
+     * Encodes the next frame. After this call the positions and the change of the particle set can be obtained.
+     * @param snapshot the trajectory entries of the frame
+     */
+    void encode(const std::vector<TrajectoryEntry> &snapshot) {
+        const auto n = snapshot.size();
+        const auto nPrevious = _ids.size();
+        _keyframe = _nFrames % _keyframeInterval == 0;
+        _delta.clear();
+
+        // match the snapshot against the current particle order by id
+        _source.assign(nPrevious, noSource);
+        _addedSources.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto &entry = snapshot[i];
+            auto it = _indices.find(entry.id);
+            if (it != _indices.end() && _source[it->second] == noSource) {
+                const auto index = it->second;
+                _source[index] = i;
+                if (_types[index] != entry.typeId) {
+                    _delta.changed.push_back(index);
+                    _delta.changedTypes.push_back(entry.typeId);
+                    _types[index] = entry.typeId;
+                }
+            } else {
+                _delta.addedIds.push_back(entry.id);
+                _delta.addedTypes.push_back(entry.typeId);
+                _addedSources.push_back(i);
+            }
+        }
+
+        // drop the removed particles while keeping the order of the others, then append the new ones
+        std::size_t next = 0;
+        for (std::size_t index = 0; index < nPrevious; ++index) {
+            if (_source[index] == noSource) {
+                _delta.removed.push_back(index);
+                _indices.erase(_ids[index]);
+            } else {
+                if (next != index) {
+                    _ids[next] = _ids[index];
+                    _types[next] = _types[index];
+                    _source[next] = _source[index];
+                    std::copy_n(_grid.begin() + 3 * index, 3, _grid.begin() + 3 * next);
+                    _indices[_ids[next]] = next;
+                }
+                ++next;
+            }
+        }
+        _ids.resize(next);
+        _types.resize(next);
+        _source.resize(next);
+        _grid.resize(3 * next);
+        for (std::size_t k = 0; k < _addedSources.size(); ++k) {
+            _indices[_delta.addedIds[k]] = _ids.size();
+            _ids.push_back(_delta.addedIds[k]);
+            _types.push_back(_delta.addedTypes[k]);
+            _source.push_back(_addedSources[k]);
+        }
+        // new particles start from the grid origin, i.e., their first difference is their grid coordinate
+        _grid.resize(3 * n, 0);
+
+        if (_keyframe) {
+            _delta.clear();
+            _delta.addedIds = _ids;
+            _delta.addedTypes = _types;
+        }
+
+        _words.resize(3 * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto &pos = snapshot[_source[i]].pos;
+            for (std::size_t d = 0; d < 3; ++d) {
+                auto q = quantize(pos[d], d);
+                auto &previous = _grid[3 * i + d];
+                _words[3 * i + d] = compact::zigzag(_keyframe ? q : q - previous);
+                previous = q;
+            }
+        }
+        ++_nFrames;
+    }
+
+    /**
+     * @return the encoded positions of the last frame, three words per particle
+     */
+    [[nodiscard]] const std::vector<std::uint32_t> &words() const {
+        return _words;
+    }
+
+    /**
+     * @return the change of the particle set in the last frame, the complete particle set on keyframes
+     */
+    [[nodiscard]] const ParticleSetDelta &delta() const {
+        return _delta;
+    }
+
+    /**
+     * @return whether the last frame was stored as keyframe
+     */
+    [[nodiscard]] bool keyframe() const {
+        return _keyframe;
+    }
+
+    /**
+     * @return the particle ids of the current particle set, in the order of the encoded positions
+     */
+    [[nodiscard]] const std::vector<ParticleId> &ids() const {
+        return _ids;
+    }
+
+    /**
+     * @return the particle types of the current particle set
+     */
+    [[nodiscard]] const std::vector<ParticleTypeId> &types() const {
+        return _types;
+    }
+
+    [[nodiscard]] scalar precision() const {
+        return _precision;
+    }
+
+    [[nodiscard]] const Vec3 &origin() const {
+        return _origin;
+    }
+
+    [[nodiscard]] std::size_t keyframeInterval() const {
+        return _keyframeInterval;
+    }
+
+private:
+    std::int32_t quantize(scalar x, std::size_t d) const {
+        auto q = static_cast<std::int64_t>(std::llround((x - _origin[d]) / _precision));
+        return static_cast<std::int32_t>(std::clamp(q, -compact::maxGridCoordinate, compact::maxGridCoordinate));
+    }
+
+    static constexpr std::size_t noSource = std::numeric_limits<std::size_t>::max();
+
+    scalar _precision;
+    Vec3 _origin;
+    std::size_t _keyframeInterval;
+    std::size_t _nFrames{0};
+    bool _keyframe{false};
+    ParticleSetDelta _delta;
+    std::vector<ParticleId> _ids;
+    std::vector<ParticleTypeId> _types;
+    std::unordered_map<ParticleId, std::size_t> _indices;
+    // index into the snapshot for each particle of the current order
+    std::vector<std::size_t> _source;
+    std::vector<std::size_t> _addedSources;
+    std::vector<std::int32_t> _grid;
+    std::vector<std::uint32_t> _words;
+};
+
+class CompactTrajectoryDecoder {
+public:
+    /**
+     * Creates a new decoder, precision, origin and keyframe interval have to match the ones of the encoder.
+     */
+    CompactTrajectoryDecoder(scalar precision, const Vec3 &origin, std::size_t keyframeInterval)
+            : _precision(precision), _origin(origin), _keyframeInterval(std::max<std::size_t>(1, keyframeInterval)) {}
+
+    /**
+     * Decodes the next frame.
+     * @param words the encoded positions, three words per particle
+     * @param nParticles the number of particles in this frame
+     * @param delta the change of the particle set as produced by the encoder
+     */
+    void decode(const std::uint32_t *words, std::size_t nParticles, const ParticleSetDelta &delta) {
+        bool keyframe = _nFrames % _keyframeInterval == 0;
+        if (keyframe) {
+            _ids = delta.addedIds;
+            _types = delta.addedTypes;
+            _grid.assign(3 * _ids.size(), 0);
+        } else {
+            applyDelta(delta);
+        }
+        if (nParticles != _ids.size()) {
+            throw std::runtime_error(fmt::format("Frame {} of the compact trajectory has {} particles but the current "
+                                                 "particle set has {}", _nFrames, nParticles, _ids.size()));
+        }
+        for (std::size_t i = 0; i < 3 * nParticles; ++i) {
+            auto value = compact::unzigzag(words[i]);
+            _grid[i] = keyframe ? value : _grid[i] + value;
+        }
+        ++_nFrames;
+    }
+
+    /**
+     * @return the number of particles in the last decoded frame
+     */
+    [[nodiscard]] std::size_t size() const {
+        return _ids.size();
+    }
+
+    /**
+     * @param i the particle index
+     * @return the reconstructed position of the i-th particle in the last decoded frame
+     */
+    [[nodiscard]] Vec3 position(std::size_t i) const {
+        return {_origin[0] + _precision * static_cast<scalar>(_grid[3 * i]),
+                _origin[1] + _precision * static_cast<scalar>(_grid[3 * i + 1]),
+                _origin[2] + _precision * static_cast<scalar>(_grid[3 * i + 2])};
+    }
+
+    [[nodiscard]] const std::vector<ParticleId> &ids() const {
+        return _ids;
+    }
+
+    [[nodiscard]] const std::vector<ParticleTypeId> &types() const {
+        return _types;
+    }
+
+private:
+    void applyDelta(const ParticleSetDelta &delta) {
+        for (std::size_t k = 0; k < delta.changed.size(); ++k) {
+            _types.at(delta.changed[k]) = delta.changedTypes.at(k);
+        }
+        auto removed = delta.removed.begin();
+        std::size_t next = 0;
+        for (std::size_t index = 0; index < _ids.size(); ++index) {
+            if (removed != delta.removed.end() && *removed == index) {
+                ++removed;
+                continue;
+            }
+            _ids[next] = _ids[index];
+            _types[next] = _types[index];
+            std::copy_n(_grid.begin() + 3 * index, 3, _grid.begin() + 3 * next);
+            ++next;
+        }
+        if (removed != delta.removed.end()) {
+            throw std::runtime_error(fmt::format("Frame {} of the compact trajectory removes particles that are not "
+                                                 "part of the current particle set", _nFrames));
+        }
+        _ids.resize(next);
+        _types.resize(next);
+        _grid.resize(3 * next);
+        _ids.insert(_ids.end(), delta.addedIds.begin(), delta.addedIds.end());
+        _types.insert(_types.end(), delta.addedTypes.begin(), delta.addedTypes.end());
+        _grid.resize(3 * _ids.size(), 0);
+    }
+
+    scalar _precision;
+    Vec3 _origin;
+    std::size_t _keyframeInterval;
+    std::size_t _nFrames{0};
+    std::vector<ParticleId> _ids;
+    std::vector<ParticleTypeId> _types;
+    std::vector<std::int32_t> _grid;
+};
+
+}
@@ -80,6 +80,10 @@ public:
         dataSet->append({1}, &t);
     }
 
+    void append(const std::vector<TimeStep> &times) {
+        if (!times.empty()) dataSet->append({times.size()}, times.data());
+    }
+
     void flush() {
         dataSet->flush();
     }
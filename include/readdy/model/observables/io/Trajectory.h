@@ -78,7 +78,7 @@ public:
 protected:
     void initializeDataSet(File &file, const std::string &dataSetName, unsigned int flushStride) override;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     struct Impl;
     std::unique_ptr<Impl> pimpl;
@@ -103,7 +103,7 @@ public:
 protected:
     void initializeDataSet(File &file, const std::string &dataSetName, unsigned int flushStride) override;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     struct Impl;
     std::unique_ptr<Impl> pimpl;
@@ -111,5 +111,38 @@ protected:
     bool useBlosc{true};
 };
 
+/**
+ * Trajectory in the compact format, see CompactTrajectoryCodec.h. Positions are quantized relative to the lower corner
+ * of the simulation box with grid spacing `precision` and delta encoded between keyframes, particle ids and types are
+ * only stored when the particle set changes. All data sets are compressed with blosc and bit shuffle.
+ */
+class CompactTrajectory : public Observable<std::vector<TrajectoryEntry>> {
+    using super = Observable<std::vector<TrajectoryEntry>>;
+public:
+
+    CompactTrajectory(Kernel *kernel, unsigned int stride, scalar precision, std::size_t keyframeInterval = 100);
+
+    ~CompactTrajectory() override;
+
+    CompactTrajectory(CompactTrajectory &&) noexcept;
+
+    void evaluate() override;
+
+    void flush() override;
+
+    std::string_view type() const override;
+
+protected:
+    void initializeDataSet(File &file, const std::string &dataSetName, unsigned int flushStride) override;
+
+    void write(result_type &snapshot, TimeStep t) override;
+
+    struct Impl;
+    std::unique_ptr<Impl> pimpl;
+
+    scalar precision;
+    std::size_t keyframeInterval;
+};
+
 }
 }
@@ -0,0 +1,235 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Dense type-pair table of second order potentials. The parameters of the built-in pair potentials are stored per
+ * potential kind so that force loops can dispatch with a single index lookup into inlined kernels instead of a hash
+ * map lookup and one virtual call per potential. User-defined potentials fall back to the virtual interface.
+ *
+ * @file PairPotentialTable.h
+ * @brief Compiled type-pair interaction table for order 2 potentials
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PotentialsOrder2.h"
+
+namespace readdy::model {
+class ParticleTypeRegistry;
+}
+
+namespace readdy::model::potentials {
+
+class PotentialRegistry;
+
+namespace pair {
+
+struct HarmonicRepulsionParameters {
+    scalar forceConstant;
+    scalar interactionDistance;
+    scalar cutoffSquared;
+
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij, scalar distSquared) const {
+        if (distSquared < cutoffSquared) {
+            const auto dist = std::sqrt(distSquared);
+            const auto delta = dist - interactionDistance;
+            energy += static_cast<scalar>(0.5) * delta * delta * forceConstant;
+            if (distSquared > 0) {
+                force += (forceConstant * delta) / dist * x_ij;
+            }
+        }
+    }
+};
+
+struct WeakInteractionPiecewiseHarmonicParameters {
+    scalar forceConstant;
+    scalar desiredParticleDistance;
+    scalar depthAtDesiredDistance;
+    scalar noInteractionDistance;
+    scalar cutoffSquared;
+
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij, scalar distSquared) const {
+        if (distSquared >= cutoffSquared) return;
+        const auto dist = std::sqrt(distSquared);
+        const auto halfLenPart2 = static_cast<scalar>(.5) * (noInteractionDistance - desiredParticleDistance);
+        const auto attractiveFactor = depthAtDesiredDistance / (halfLenPart2 * halfLenPart2);
+        scalar factor;
+        if (dist < desiredParticleDistance) {
+            const auto delta = dist - desiredParticleDistance;
+            energy += static_cast<scalar>(.5) * forceConstant * delta * delta - depthAtDesiredDistance;
+            factor = forceConstant * delta;
+        } else if (dist < desiredParticleDistance + halfLenPart2) {
+            const auto delta = dist - desiredParticleDistance;
+            energy += static_cast<scalar>(.5) * attractiveFactor * delta * delta - depthAtDesiredDistance;
+            factor = attractiveFactor * delta;
+        } else {
+            const auto delta = dist - noInteractionDistance;
+            energy += static_cast<scalar>(-.5) * attractiveFactor * delta * delta;
+            factor = -attractiveFactor * delta;
+        }
+        if (dist > 0 && factor != 0) {
+            force += factor * x_ij / dist;
+        }
+    }
+};
+
+struct LennardJonesParameters {
+    scalar m, n;
+    scalar k;
+    scalar sigma;
+    scalar energyShift;
+    scalar cutoffSquared;
+
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij, scalar distSquared) const {
+        if (distSquared < cutoffSquared) {
+            const auto r = std::sqrt(distSquared);
+            const auto sr = sigma / r;
+            const auto srM = std::pow(sr, m);
+            const auto srN = std::pow(sr, n);
+            energy += k * (srM - srN) - energyShift;
+            force += -1. * k / (sigma * sigma) * (m * srM * sr * sr - n * srN * sr * sr) * x_ij;
+        }
+    }
+};
+
+struct ScreenedElectrostaticsParameters {
+    scalar electrostaticStrength;
+    scalar inverseScreeningDepth;
+    scalar repulsionStrength;
+    scalar repulsionDistance;
+    scalar exponent;
+    scalar cutoffSquared;
+
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij, scalar distSquared) const {
+        if (distSquared < cutoffSquared) {
+            const auto distance = std::sqrt(distSquared);
+            const auto screening = electrostaticStrength * std::exp(-inverseScreeningDepth * distance);
+            const auto repulsion = repulsionStrength * std::pow(repulsionDistance / distance, exponent);
+            energy += screening / distance + repulsion;
+            auto forceFactor = screening * (inverseScreeningDepth / distance + 1. / distSquared);
+            forceFactor += exponent / distance * repulsion;
+            force += forceFactor * (-1. * x_ij / distance);
+        }
+    }
+};
+
+/**
+ * All order 2 potentials acting between one particular pair of particle types.
+ */
+struct TypePairPotentials {
+    /**
+     * Classification of the type pair for batched force evaluation, pairs that are subject to exactly one harmonic
+     * repulsion or one 12-6 Lennard-Jones potential can be evaluated by specialized kernels.
+     */
+    enum class Dispatch : std::uint8_t {
+        none, harmonicRepulsion, lennardJones126, generic
+    };
+
+    std::vector<HarmonicRepulsionParameters> harmonicRepulsion {};
+    std::vector<WeakInteractionPiecewiseHarmonicParameters> weakInteractionPiecewiseHarmonic {};
+    std::vector<LennardJonesParameters> lennardJones {};
+    std::vector<ScreenedElectrostaticsParameters> screenedElectrostatics {};
+    std::vector<const PotentialOrder2 *> userDefined {};
+    scalar maxCutoffSquared {0};
+    Dispatch dispatch {Dispatch::none};
+
+    [[nodiscard]] bool empty() const {
+        return maxCutoffSquared == 0 && userDefined.empty();
+    }
+
+    /**
+     * Evaluates all potentials of this type pair. The force acting on particle i is added to force.
+     * @param force the force on particle i
+     * @param energy the energy
+     * @param x_ij the shortest difference vector x_j - x_i
+     * @param distSquared its squared norm
+     */
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij, scalar distSquared) const {
+        for (const auto &p : harmonicRepulsion) p.calculateForceAndEnergy(force, energy, x_ij, distSquared);
+        for (const auto &p : weakInteractionPiecewiseHarmonic) p.calculateForceAndEnergy(force, energy, x_ij, distSquared);
+        for (const auto &p : lennardJones) p.calculateForceAndEnergy(force, energy, x_ij, distSquared);
+        for (const auto &p : screenedElectrostatics) p.calculateForceAndEnergy(force, energy, x_ij, distSquared);
+        for (const auto *potential : userDefined) {
+            if (distSquared < potential->getCutoffRadiusSquared()) {
+                potential->calculateForceAndEnergy(force, energy, x_ij);
+            }
+        }
+    }
+};
+
+}
+
+class PairPotentialTable {
+public:
+    PairPotentialTable() = default;
+
+    /**
+     * Compiles the order 2 potentials of the registry into a dense table indexed by particle type ids.
+     * @param potentials the potential registry
+     * @param types the particle type registry
+     */
+    PairPotentialTable(const PotentialRegistry &potentials, const ParticleTypeRegistry &types);
+
+    const pair::TypePairPotentials &operator()(ParticleTypeId t1, ParticleTypeId t2) const {
+        return _table[t1 * _nTypes + t2];
+    }
+
+    [[nodiscard]] std::size_t nTypes() const {
+        return _nTypes;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return _empty;
+    }
+
+    /**
+     * Whether the table has to be rebuilt because potentials or particle types were added since its construction.
+     */
+    [[nodiscard]] bool outdated(const PotentialRegistry &potentials, const ParticleTypeRegistry &types) const;
+
+private:
+    std::size_t _nTypes {0};
+    std::size_t _nRegisteredTypes {0};
+    std::size_t _potentialsVersion {0};
+    bool _empty {true};
+    std::vector<pair::TypePairPotentials> _table {};
+};
+
+}
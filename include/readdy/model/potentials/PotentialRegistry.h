@@ -338,6 +338,24 @@ public:
         return _potentialsO2;
     }
 
+    /**
+     * Counter that is incremented whenever an order 1 potential is registered, can be used to invalidate data
+     * derived from the order 1 potentials.
+     * @return the current version
+     */
+    std::size_t potentialsOrder1Version() const {
+        return _potentialsO1Version;
+    }
+
+    /**
+     * Counter that is incremented whenever an order 2 potential is registered, can be used to invalidate data
+     * derived from the order 2 potentials.
+     * @return the current version
+     */
+    std::size_t potentialsOrder2Version() const {
+        return _potentialsO2Version;
+    }
+
     const PotentialsO1Collection &potentialsOf(const std::string &type) const {
         return potentialsOf(_types->idOf(type));
     }
@@ -358,7 +376,9 @@ private:
 
     AltPotentialsO2Map _alternativeO2Registry{};
     PotentialsO1Map _potentialsO1{};
+    std::size_t _potentialsO1Version{0};
     PotentialsO2Map _potentialsO2{};
+    std::size_t _potentialsO2Version{0};
 
     OwnPotentialsO1Map _ownPotentialsO1{};
     OwnPotentialsO2Map _ownPotentialsP2{};
@@ -366,6 +386,7 @@ private:
     void _registerO1(PotentialOrder1 *potential) {
         auto typeId = potential->particleType();
         _potentialsO1[typeId].push_back(potential);
+        ++_potentialsO1Version;
     }
 
     void _registerO2(PotentialOrder2 *potential) {
@@ -373,6 +394,7 @@ private:
         auto type2Id = potential->particleType2();
         auto pp = std::tie(type1Id, type2Id);
         _potentialsO2[pp].push_back(potential);
+        ++_potentialsO2Version;
         _alternativeO2Registry[type1Id][type2Id].push_back(potential);
         if (type1Id != type2Id) {
             _alternativeO2Registry[type2Id][type1Id].push_back(potential);
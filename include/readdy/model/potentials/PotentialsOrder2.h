@@ -37,6 +37,8 @@
  * This header contains the declarations of order 2 potentials. Currently:
  *   - Harmonic repulsion
  *   - Weak interaction piecewise harmonic
+ *   - Lennard-Jones
+ *   - Screened electrostatics
  *
  * @file PotentialsOrder2.h
  * @brief Contains the declaration of order 2 potentials.
@@ -51,8 +53,11 @@
 
 namespace readdy::model::potentials {
 
+class PairPotentialTable;
+
 class HarmonicRepulsion : public PotentialOrder2 {
     using super = PotentialOrder2;
+    friend class PairPotentialTable;
 public:
     HarmonicRepulsion(ParticleTypeId type1, ParticleTypeId type2,
                       scalar forceConstant, scalar interactionDistance)
@@ -104,6 +109,7 @@ protected:
 
 class WeakInteractionPiecewiseHarmonic : public PotentialOrder2 {
     using super = PotentialOrder2;
+    friend class PairPotentialTable;
 public:
     std::string describe() const override;
 
@@ -113,6 +119,7 @@ public:
 
     private:
         friend class WeakInteractionPiecewiseHarmonic;
+        friend class readdy::model::potentials::PairPotentialTable;
 
         const scalar desiredParticleDistance, depthAtDesiredDistance, noInteractionDistance, noInteractionDistanceSquared;
     };
@@ -198,6 +205,7 @@ protected:
  */
 class LennardJones : public PotentialOrder2 {
     using super = PotentialOrder2;
+    friend class PairPotentialTable;
 public:
     /**
      * Constructs a Lennard-Jones-type potential between two particle types A and B (where possibly A = B) of the
@@ -273,6 +281,7 @@ protected:
 
 class ScreenedElectrostatics : public PotentialOrder2 {
     using super = PotentialOrder2;
+    friend class PairPotentialTable;
 public:
     ScreenedElectrostatics(ParticleTypeId type1, ParticleTypeId type2, scalar electrostaticStrength,
                            scalar inverseScreeningDepth, scalar repulsionStrength, scalar repulsionDistance,
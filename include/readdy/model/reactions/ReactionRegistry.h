@@ -269,6 +269,15 @@ public:
 
     std::string describe() const;
 
+    /**
+     * Counter that is incremented whenever a reaction is registered, can be used to invalidate data derived from
+     * the registered reactions.
+     * @return the current version
+     */
+    std::size_t version() const {
+        return _version;
+    }
+
 private:
     using OwnReactions = std::vector<std::shared_ptr<Reaction>>;
     using OwnReactionsO1Map = std::unordered_map<ParticleTypeId, OwnReactions>;
@@ -280,6 +289,7 @@ private:
 
     std::size_t _n_order1{0};
     std::size_t _n_order2{0};
+    std::size_t _version{0};
 
     const ParticleTypeRegistry *_types;
 
@@ -0,0 +1,145 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Dense type-pair table of second order reactions. The reactions of all ordered type pairs are stored contiguously
+ * in a flat array, together with a bitmask telling whether a type pair has any reactions at all and the largest educt
+ * distance per type pair. Pair loops can reject non-reacting pairs with a single load and skip pairs that are out of
+ * reach of all their reactions, instead of performing a hash map lookup per pair.
+ *
+ * @file ReactionTable.h
+ * @brief Compiled type-pair lookup table for order 2 reactions
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Reaction.h"
+
+namespace readdy::model {
+class ParticleTypeRegistry;
+}
+
+namespace readdy::model::reactions {
+
+class ReactionRegistry;
+
+class ReactionTable {
+public:
+    /**
+     * Contiguous range of the reactions of one type pair, in the order of ReactionRegistry::order2ByType.
+     */
+    class ReactionsView {
+    public:
+        using value_type = Reaction *;
+        using const_iterator = Reaction *const *;
+
+        ReactionsView(const_iterator begin, const_iterator end) : _begin(begin), _end(end) {}
+
+        [[nodiscard]] const_iterator begin() const {
+            return _begin;
+        }
+
+        [[nodiscard]] const_iterator end() const {
+            return _end;
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return static_cast<std::size_t>(_end - _begin);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return _begin == _end;
+        }
+
+        Reaction *operator[](std::size_t index) const {
+            return _begin[index];
+        }
+
+    private:
+        const_iterator _begin;
+        const_iterator _end;
+    };
+
+    ReactionTable() = default;
+
+    /**
+     * Compiles the order 2 reactions of the registry into a dense table indexed by particle type ids.
+     * @param reactions the reaction registry
+     * @param types the particle type registry
+     */
+    ReactionTable(const ReactionRegistry &reactions, const ParticleTypeRegistry &types);
+
+    [[nodiscard]] ReactionsView order2(ParticleTypeId t1, ParticleTypeId t2) const {
+        const auto index = t1 * _nTypes + t2;
+        return {_reactions.data() + _offsets[index], _reactions.data() + _offsets[index + 1]};
+    }
+
+    [[nodiscard]] bool hasOrder2(ParticleTypeId t1, ParticleTypeId t2) const {
+        const auto index = t1 * _nTypes + t2;
+        return ((_hasOrder2[index / 64] >> (index % 64)) & 1u) != 0;
+    }
+
+    /**
+     * The largest squared educt distance of the reactions of a type pair, zero if there are none.
+     */
+    [[nodiscard]] scalar maxEductDistanceSquared(ParticleTypeId t1, ParticleTypeId t2) const {
+        return _maxEductDistanceSquared[t1 * _nTypes + t2];
+    }
+
+    [[nodiscard]] std::size_t nTypes() const {
+        return _nTypes;
+    }
+
+    /**
+     * Whether the table has to be rebuilt because reactions or particle types were added since its construction.
+     */
+    [[nodiscard]] bool outdated(const ReactionRegistry &reactions, const ParticleTypeRegistry &types) const;
+
+private:
+    std::size_t _nTypes {0};
+    std::size_t _nRegisteredTypes {0};
+    std::size_t _reactionsVersion {0};
+    std::vector<Reaction *> _reactions {};
+    std::vector<std::size_t> _offsets {0};
+    std::vector<std::uint64_t> _hasOrder2 {};
+    std::vector<scalar> _maxEductDistanceSquared {};
+};
+
+}
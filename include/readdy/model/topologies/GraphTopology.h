@@ -195,6 +195,13 @@ public:
 
     [[nodiscard]] std::vector<VertexData::ParticleIndex> particleIndices() const;
 
+    /**
+     * Replaces the particle index of each vertex by its image under the given map, e.g., after the kernel reordered
+     * its particle data, and reconfigures the bonded potentials which refer to particle indices.
+     * @param oldToNew map from old to new particle indices
+     */
+    void remapParticleIndices(const std::vector<VertexData::ParticleIndex> &oldToNew);
+
     [[nodiscard]] TopologyTypeId type() const {
         return _topology_type;
     }
@@ -47,6 +47,8 @@
 #include <readdy/model/Kernel.h>
 
 #include "pool.h"
+#include "InteractionSnapshot.h"
+#include "ScratchArena.h"
 #include "CPUStateModel.h"
 #include "observables/CPUObservableFactory.h"
 #include "actions/CPUActionFactory.h"
@@ -96,7 +98,7 @@ public:
     };
 
     std::size_t getNThreads() {
-        return static_cast<std::size_t>(_pool.size());
+        return _pool.teamSize();
     }
 
     const model::actions::ActionFactory &actions() const override {
@@ -133,14 +135,70 @@ public:
         return _pool;
     }
 
+    /**
+     * The interaction snapshot of the current context, it is rebuilt if potentials, reactions or particle types were
+     * added since the last call. Must not be called concurrently, actions obtain it before dispatching their tasks.
+     * @return the snapshot
+     */
+    const InteractionSnapshot &interactions() {
+        if (_interactions.outdated(context())) {
+            _interactions = InteractionSnapshot(context());
+        }
+        return _interactions;
+    }
+
+    /**
+     * Seed of the counter-based random streams (see model::rnd::CounterBasedStream) used in parallel regions. It is
+     * taken from the configuration on initialize or drawn randomly if the configuration does not specify one.
+     * @return the seed
+     */
+    std::uint64_t seed() const {
+        return _seed;
+    }
+
+    /**
+     * Whether the configuration fixes the seed, in which case actions also avoid other sources of run to run
+     * variation, such as the order in which threads draw particle ids.
+     * @return true if the run is meant to be reproducible
+     */
+    bool reproducible() const {
+        return context().kernelConfiguration().cpu.seed != 0;
+    }
+
+    /**
+     * Each action that draws random numbers in a parallel region takes fresh epochs per invocation and keys its
+     * streams by (epoch, particle index), so that the draws neither depend on the number of threads nor on the
+     * scheduling. Must not be called concurrently.
+     * @param n the number of consecutive epochs to reserve
+     * @return the first reserved epoch
+     */
+    std::uint32_t nextRandomEpoch(std::uint32_t n = 1) {
+        const auto epoch = _randomEpoch;
+        _randomEpoch += n;
+        return epoch;
+    }
+
+    /**
+     * Arena for the per-step scratch buffers of the actions, see ScratchArena. Actions open a scope for the duration
+     * of their perform call. Must not be used from within parallel regions.
+     * @return the arena
+     */
+    ScratchArena &scratch() {
+        return _scratch;
+    }
+
 protected:
 
-    CPUStateModel::data_type _data;
+    CPUStateModel::soa_data_type _data;
     actions::CPUActionFactory _actions;
     observables::CPUObservableFactory _observables;
     actions::top::CPUTopologyActionFactory _topologyActionFactory;
     CPUStateModel _stateModel;
     thread_pool _pool;
+    InteractionSnapshot _interactions;
+    std::uint64_t _seed;
+    std::uint32_t _randomEpoch {0};
+    ScratchArena _scratch;
 };
 
 }
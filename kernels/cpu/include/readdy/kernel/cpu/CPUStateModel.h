@@ -56,7 +56,7 @@
 #include <readdy/model/observables/ReactionCounts.h>
 #include <readdy/common/index_persistent_vector.h>
 #include <readdy/api/KernelConfiguration.h>
-#include <readdy/kernel/cpu/data/DefaultDataContainer.h>
+#include <readdy/kernel/cpu/data/SoADataContainer.h>
 #include <readdy/kernel/cpu/nl/CellLinkedList.h>
 #include <readdy/kernel/cpu/nl/ContiguousCellLinkedList.h>
 #include <readdy/kernel/cpu/data/ObservableData.h>
@@ -67,6 +67,7 @@ class CPUStateModel : public readdy::model::StateModel {
 public:
 
     using data_type = readdy::kernel::cpu::data::DefaultDataContainer;
+    using soa_data_type = readdy::kernel::cpu::data::SoADataContainer;
     using particle_type = readdy::model::Particle;
     
     using topology = readdy::model::top::GraphTopology;
@@ -74,7 +75,7 @@ public:
     using topologies_vec = readdy::util::index_persistent_vector<topology_ref>;
     using neighbor_list = nl::CompactCellLinkedList;
 
-    CPUStateModel(data_type &data, const readdy::model::Context &context, thread_pool &pool,
+    CPUStateModel(soa_data_type &data, const readdy::model::Context &context, thread_pool &pool,
                   readdy::model::top::TopologyActionFactory const* taf);
 
     ~CPUStateModel() override = default;
@@ -87,18 +88,31 @@ public:
     void configure(const readdy::conf::cpu::Configuration &configuration) {
         const auto& nl = configuration.neighborList;
         _neighborListCellRadius = nl.cll_radius;
+        _neighborList->verlet() = nl.verletList;
+        _neighborListSkin = nl.verletList ? nl.skin : 0;
+        _neighborList->reorderInterval() = configuration.reorder.interval;
+        _neighborList->hilbertOrder() = configuration.reorder.hilbert;
+        if (_data.get().arraysEnabled() != configuration.structureOfArrays) {
+            _data.get().enableArrays(configuration.structureOfArrays);
+        }
     }
 
     std::vector<Vec3> getParticlePositions() const override;
 
     std::vector<particle_type> getParticles() const override;
 
+    void trajectorySnapshot(const std::vector<readdy::model::ParticleFlavor> &flavors,
+                            std::vector<readdy::model::observables::TrajectoryEntry> &entries) const override;
+
     void initializeNeighborList(scalar interactionDistance) override {
-        _neighborList->setUp(interactionDistance, _neighborListCellRadius);
+        _data.get().syncEntryPositions();
+        _neighborList->setUp(interactionDistance, _neighborListCellRadius, _neighborListSkin);
         _neighborList->update();
     };
 
     void updateNeighborList() override {
+        // the neighbor list only reads positions, forces may stay in the arrays
+        _data.get().syncEntryPositions();
         _neighborList->update();
     };
 
@@ -150,11 +164,32 @@ public:
         _observableData.time = t;
     };
 
+    /**
+     * @return the particle data, with positions and forces that were changed in the arrays written back
+     */
     data_type const *const getParticleData() const {
+        _data.get().syncEntries();
         return &_data.get();
     };
 
+    /**
+     * @return the particle data for writing, with positions and forces that were changed in the arrays written back;
+     *         the arrays are gathered again before their next use
+     */
     data_type *const getParticleData() {
+        _data.get().syncEntries();
+        _data.get().invalidateArrays();
+        return &_data.get();
+    };
+
+    /**
+     * @return the particle data with up to date arrays if it maintains structure of arrays, otherwise nullptr
+     */
+    soa_data_type *const getSoAParticleData() {
+        if (!_data.get().arraysEnabled()) {
+            return nullptr;
+        }
+        _data.get().syncArrays();
         return &_data.get();
     };
 
@@ -223,7 +258,7 @@ public:
     }
 
     particle_type getParticleForIndex(std::size_t index) const override {
-        return _data.get().getParticle(index);
+        return getParticleData()->getParticle(index);
     };
 
     ParticleTypeId getParticleType(std::size_t index) const override {
@@ -242,8 +277,7 @@ public:
 
     std::vector<readdy::model::top::GraphTopology *> getTopologies() override;
 
-    void toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                std::vector<std::size_t>::iterator end) const override;
+    [[nodiscard]] readdy::model::DenseParticleIndices denseParticleIndices() const override;
 
     void clear() override;
 
@@ -251,10 +285,13 @@ private:
     data::ObservableData _observableData;
     std::reference_wrapper<thread_pool> _pool;
     std::reference_wrapper<const readdy::model::Context> _context;
-    std::reference_wrapper<data_type> _data;
+    std::reference_wrapper<soa_data_type> _data;
     std::unique_ptr<neighbor_list> _neighborList;
     neighbor_list::cell_radius_type _neighborListCellRadius {1};
+    scalar _neighborListSkin {0};
     std::reference_wrapper<const readdy::model::top::TopologyActionFactory> _topologyActionFactory;
     topologies_vec _topologies{};
+    // keeps the topologies' particle indices valid when the particle data is reordered
+    readdy::signals::scoped_connection _reorderConnection;
 };
 }
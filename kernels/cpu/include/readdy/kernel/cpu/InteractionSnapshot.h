@@ -0,0 +1,164 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Immutable, flattened view on the potentials and reactions of a context. It is rebuilt only when potentials,
+ * reactions or particle types were added or the context was replaced, and shared by const reference across all tasks of the CPU actions, so
+ * that the per-step task setup neither copies nor hashes the registries.
+ *
+ * @file InteractionSnapshot.h
+ * @brief Flattened potentials and reactions shared by the CPU actions
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <readdy/model/Context.h>
+#include <readdy/model/potentials/PairPotentialTable.h>
+#include <readdy/model/reactions/ReactionTable.h>
+
+namespace readdy::kernel::cpu {
+
+class InteractionSnapshot {
+public:
+    using PotentialsO1Collection = model::potentials::PotentialRegistry::PotentialsO1Collection;
+    using ReactionsCollection = model::reactions::ReactionRegistry::ReactionsCollection;
+    using ReactionsView = model::reactions::ReactionTable::ReactionsView;
+
+    InteractionSnapshot() = default;
+
+    explicit InteractionSnapshot(const model::Context &context)
+            : _pairPotentials(context.potentials(), context.particleTypes()),
+              _reactionsO2(context.reactions(), context.particleTypes()),
+              _contextGeneration(context.generation()),
+              _potentialsO1Version(context.potentials().potentialsOrder1Version()),
+              _potentialsO2Version(context.potentials().potentialsOrder2Version()),
+              _reactionsVersion(context.reactions().version()),
+              _nRegisteredTypes(context.particleTypes().nTypes()) {
+        for (const auto &entry : context.particleTypes().typeMapping()) {
+            _nTypes = std::max(_nTypes, static_cast<std::size_t>(entry.second) + 1);
+        }
+        const auto &potentials = context.potentials();
+        const auto &reactions = context.reactions();
+        _potentialsO1.resize(_nTypes);
+        for (const auto &entry : potentials.potentialsOrder1()) {
+            _potentialsO1.at(entry.first) = entry.second;
+            _hasPotentialsO1 |= !entry.second.empty();
+        }
+        // reactions are referenced, the registry's collections stay valid as long as no reactions are added
+        _reactionsO1.resize(_nTypes, &noReactions());
+        for (const auto &entry : reactions.order1()) {
+            _reactionsO1.at(entry.first) = &entry.second;
+        }
+    }
+
+    InteractionSnapshot(const InteractionSnapshot &) = delete;
+    InteractionSnapshot &operator=(const InteractionSnapshot &) = delete;
+    InteractionSnapshot(InteractionSnapshot &&) = default;
+    InteractionSnapshot &operator=(InteractionSnapshot &&) = default;
+    ~InteractionSnapshot() = default;
+
+    /**
+     * Whether the snapshot does no longer reflect the context because the context was assigned to or something was
+     * registered since its creation.
+     */
+    [[nodiscard]] bool outdated(const model::Context &context) const {
+        return _contextGeneration != context.generation()
+               || _potentialsO1Version != context.potentials().potentialsOrder1Version()
+               || _potentialsO2Version != context.potentials().potentialsOrder2Version()
+               || _reactionsVersion != context.reactions().version()
+               || _nRegisteredTypes != context.particleTypes().nTypes();
+    }
+
+    [[nodiscard]] std::size_t nTypes() const {
+        return _nTypes;
+    }
+
+    [[nodiscard]] const model::potentials::PairPotentialTable &pairPotentials() const {
+        return _pairPotentials;
+    }
+
+    [[nodiscard]] const PotentialsO1Collection &potentialsOrder1(ParticleTypeId type) const {
+        return _potentialsO1[type];
+    }
+
+    [[nodiscard]] bool hasPotentialsOrder1() const {
+        return _hasPotentialsO1;
+    }
+
+    [[nodiscard]] const ReactionsCollection &reactionsOrder1(ParticleTypeId type) const {
+        return *_reactionsO1[type];
+    }
+
+    [[nodiscard]] ReactionsView reactionsOrder2(ParticleTypeId type1, ParticleTypeId type2) const {
+        return _reactionsO2.order2(type1, type2);
+    }
+
+    [[nodiscard]] bool hasReactionsOrder2(ParticleTypeId type1, ParticleTypeId type2) const {
+        return _reactionsO2.hasOrder2(type1, type2);
+    }
+
+    /**
+     * Squared distance beyond which no second order reaction between the two types can take place.
+     */
+    [[nodiscard]] scalar maxEductDistanceSquared(ParticleTypeId type1, ParticleTypeId type2) const {
+        return _reactionsO2.maxEductDistanceSquared(type1, type2);
+    }
+
+private:
+    static const ReactionsCollection &noReactions() {
+        static const ReactionsCollection empty {};
+        return empty;
+    }
+
+    model::potentials::PairPotentialTable _pairPotentials {};
+    std::vector<PotentialsO1Collection> _potentialsO1 {};
+    bool _hasPotentialsO1 {false};
+    std::vector<const ReactionsCollection *> _reactionsO1 {};
+    model::reactions::ReactionTable _reactionsO2 {};
+
+    std::size_t _nTypes {0};
+    std::uint64_t _contextGeneration {0};
+    std::size_t _potentialsO1Version {0};
+    std::size_t _potentialsO2Version {0};
+    std::size_t _reactionsVersion {0};
+    std::size_t _nRegisteredTypes {0};
+};
+
+}
@@ -0,0 +1,230 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Monotonic memory resource for the scratch buffers of the CPU actions. Allocations bump a pointer into a retained
+ * buffer and deallocations are no-ops; memory is reclaimed in one go when the outermost Scope ends. Whatever does not
+ * fit is taken from the upstream resource and released at the end of its scope, the buffer is then grown to the peak
+ * demand, so that after a few time steps the scratch buffers taken from the arena are served without going to the
+ * heap. Buffers that live elsewhere, e.g. inside the particle data or the neighbor list, are not covered by this.
+ *
+ * The arena is not thread safe, it is meant to be used by the thread running an action outside of parallel regions.
+ *
+ * @file ScratchArena.h
+ * @brief Per-step arena allocator for the scratch buffers of the CPU actions
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+
+namespace readdy::kernel::cpu {
+
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    /**
+     * RAII guard rewinding the arena to the state it had on construction.
+     */
+    class Scope {
+    public:
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        Scope(Scope &&rhs) noexcept : _arena(rhs._arena), _offset(rhs._offset), _demand(rhs._demand),
+                                      _nOverflow(rhs._nOverflow) {
+            rhs._arena = nullptr;
+        }
+
+        Scope &operator=(Scope &&) = delete;
+
+        ~Scope() {
+            if (_arena) {
+                _arena->rewind(_offset, _demand, _nOverflow);
+            }
+        }
+
+    private:
+        friend class ScratchArena;
+
+        Scope(ScratchArena *arena, std::size_t offset, std::size_t demand, std::size_t nOverflow)
+                : _arena(arena), _offset(offset), _demand(demand), _nOverflow(nOverflow) {}
+
+        ScratchArena *_arena;
+        std::size_t _offset;
+        std::size_t _demand;
+        std::size_t _nOverflow;
+    };
+
+    explicit ScratchArena(std::size_t initialCapacity = 0,
+                          std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+            : _upstream(upstream) {
+        reserve(initialCapacity);
+    }
+
+    ScratchArena(const ScratchArena &) = delete;
+
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    ScratchArena(ScratchArena &&) = delete;
+
+    ScratchArena &operator=(ScratchArena &&) = delete;
+
+    ~ScratchArena() override {
+        releaseOverflow(0);
+    }
+
+    /**
+     * Opens a scope, everything allocated until the returned guard is destroyed is released at once.
+     * @return the guard
+     */
+    [[nodiscard]] Scope scope() {
+        return {this, _offset, _demand, _overflow.size()};
+    }
+
+    /**
+     * @return size of the retained buffer in bytes
+     */
+    std::size_t capacity() const {
+        return _capacity;
+    }
+
+    /**
+     * @return bytes currently handed out, including the ones taken from the upstream resource
+     */
+    std::size_t used() const {
+        return _demand;
+    }
+
+    /**
+     * @return largest number of bytes that were handed out at once
+     */
+    std::size_t peak() const {
+        return _peak;
+    }
+
+    /**
+     * @return number of allocations that did not fit into the retained buffer
+     */
+    std::size_t nOverflowAllocations() const {
+        return _nOverflowAllocations;
+    }
+
+    /**
+     * Grows the retained buffer to at least the given size. Must only be called while nothing is allocated.
+     * @param capacity the capacity in bytes
+     */
+    void reserve(std::size_t capacity) {
+        if (capacity > _capacity && _demand == 0) {
+            _buffer = std::make_unique<std::byte[]>(capacity);
+            _capacity = capacity;
+        }
+    }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        auto *base = _buffer.get();
+        if (base) {
+            auto address = reinterpret_cast<std::uintptr_t>(base + _offset);
+            auto padding = (alignment - address % alignment) % alignment;
+            if (_offset + padding + bytes <= _capacity) {
+                void *ptr = base + _offset + padding;
+                _offset += padding + bytes;
+                bump(padding + bytes);
+                return ptr;
+            }
+        }
+        void *ptr = _upstream->allocate(bytes, alignment);
+        _overflow.push_back({ptr, bytes, alignment});
+        ++_nOverflowAllocations;
+        bump(bytes + alignment);
+        return ptr;
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct OverflowBlock {
+        void *ptr;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    void bump(std::size_t bytes) {
+        _demand += bytes;
+        _peak = std::max(_peak, _demand);
+    }
+
+    void releaseOverflow(std::size_t nKeep) {
+        while (_overflow.size() > nKeep) {
+            const auto &block = _overflow.back();
+            _upstream->deallocate(block.ptr, block.bytes, block.alignment);
+            _overflow.pop_back();
+        }
+    }
+
+    void rewind(std::size_t offset, std::size_t demand, std::size_t nOverflow) {
+        releaseOverflow(nOverflow);
+        _offset = offset;
+        _demand = demand;
+        if (_demand == 0 && _peak > _capacity) {
+            _buffer.reset();
+            _capacity = 0;
+            reserve(_peak);
+        }
+    }
+
+    std::pmr::memory_resource *_upstream;
+    std::unique_ptr<std::byte[]> _buffer;
+    std::size_t _capacity {0};
+    std::size_t _offset {0};
+    std::size_t _demand {0};
+    std::size_t _peak {0};
+    std::size_t _nOverflowAllocations {0};
+    std::vector<OverflowBlock> _overflow;
+};
+
+}
@@ -43,6 +43,8 @@
 #pragma once
 
 #include <readdy/model/actions/Actions.h>
+#include <readdy/model/potentials/PairPotentialTable.h>
+#include <readdy/kernel/cpu/actions/PairBatch.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
 #include <readdy/common/thread/barrier.h>
 
@@ -52,7 +54,6 @@ namespace cpu {
 namespace actions {
 class CPUCalculateForces : public readdy::model::actions::CalculateForces {
     using super = readdy::model::actions::CalculateForces;
-    using data_bounds = std::tuple<data::EntryDataContainer::iterator, data::EntryDataContainer::iterator>;
     using nl_bounds = std::tuple<std::size_t, std::size_t>;
     using top_bounds = std::tuple<CPUStateModel::topologies_vec::const_iterator, CPUStateModel::topologies_vec::const_iterator>;
 public:
@@ -63,22 +64,80 @@ public:
 
 protected:
 
+    /**
+     * Computes second order potentials for all particles in the cells nlBounds. Each pair is visited only once
+     * (half shell), the force is applied to the particle directly and its counterpart is written into the
+     * thread-local force buffer which is reduced after all threads have finished. The buffer is accumulated into
+     * and not cleared, as a thread can process several cell ranges. Only particles of the cells in nlBounds and their
+     * adjacent cells are written to. Neighbors are evaluated in batches, see PairBatch.
+     */
     template<bool COMPUTE_VIRIAL>
-    static void calculateOrder2(std::size_t, nl_bounds nlBounds, CPUStateModel::data_type *data,
-                                const CPUStateModel::neighbor_list &nl, std::promise<scalar> &energyPromise,
-                                std::promise<Matrix33> &virialPromise,
-                                model::potentials::PotentialRegistry::PotentialsO2Map pot2,
-                                model::Context::BoxSize box, model::Context::PeriodicBoundaryConditions pbc);
+    static std::tuple<scalar, Matrix33> calculateOrder2(
+            nl_bounds nlBounds, CPUStateModel::data_type *data, const CPUStateModel::neighbor_list &nl,
+            std::vector<Vec3> &forceBuffer, const model::potentials::PairPotentialTable &pot2,
+            const model::Context::BoxSize &box, const model::Context::PeriodicBoundaryConditions &pbc);
 
-    static void calculateTopologies(std::size_t /*tid*/, top_bounds topBounds, model::top::TopologyActionFactory *taf,
-                                    std::promise<scalar> &energyPromise);
+    /**
+     * Same as calculateOrder2, reading positions and types from the arrays of the particle data and accumulating the
+     * forces into its force arrays.
+     */
+    template<bool COMPUTE_VIRIAL>
+    static std::tuple<scalar, Matrix33> calculateOrder2OnArrays(
+            nl_bounds nlBounds, CPUStateModel::soa_data_type &data, const CPUStateModel::neighbor_list &nl,
+            std::vector<Vec3> &forceBuffer, const model::potentials::PairPotentialTable &pot2,
+            const model::Context::BoxSize &box, const model::Context::PeriodicBoundaryConditions &pbc);
+
+    /**
+     * Sizes the force buffers and the cell owners for the next pair traversal. The buffers are only zeroed if the
+     * previous reduction did not complete.
+     */
+    void prepareForceBuffers(std::size_t nParticles, std::size_t nCells, std::size_t nThreads);
+
+    /**
+     * Collects the threads which may have written to the buffer entries of the particles in a cell, i.e., the
+     * owners of the cell and of its adjacent cells, without duplicates.
+     */
+    static void cellWriters(std::size_t cell, const CPUStateModel::neighbor_list &nl,
+                            const std::vector<std::size_t> &cellOwner, std::vector<std::size_t> &writers);
+
+    /**
+     * Adds the buffered forces of the particles in the given cells and zeroes the consumed buffer entries. Per
+     * particle only the buffers of the cell's writers are visited.
+     */
+    static void reduceForceBuffers(nl_bounds cells, CPUStateModel::data_type *data,
+                                   const CPUStateModel::neighbor_list &nl, const std::vector<std::size_t> &cellOwner,
+                                   std::vector<std::vector<Vec3>> &forceBuffers);
+
+    static void reduceForceBuffers(nl_bounds cells, CPUStateModel::soa_data_type &data,
+                                   const CPUStateModel::neighbor_list &nl, const std::vector<std::size_t> &cellOwner,
+                                   std::vector<std::vector<Vec3>> &forceBuffers);
+
+    static scalar calculateTopologies(top_bounds topBounds, model::top::TopologyActionFactory *taf);
+
+    static scalar calculateOrder1(std::size_t begin, std::size_t end, CPUStateModel::data_type *data,
+                                  const InteractionSnapshot &interactions);
+
+    /**
+     * Resets the forces in the arrays of the particle data and applies the first order potentials.
+     */
+    static scalar calculateOrder1OnArrays(std::size_t begin, std::size_t end, CPUStateModel::soa_data_type &data,
+                                          const InteractionSnapshot &interactions);
 
+    static scalar calculateTopologiesOnArrays(top_bounds topBounds, CPUStateModel::soa_data_type &data,
+                                              model::top::TopologyActionFactory *taf);
 
-    static void calculateOrder1(std::size_t /*tid*/, data_bounds dataBounds,
-                                std::promise<scalar> &energyPromise, CPUStateModel::data_type *data,
-                                model::potentials::PotentialRegistry::PotentialsO1Map pot1);
+    /**
+     * Same as perform(), with the forces accumulated in the arrays of the particle data.
+     */
+    void performOnArrays(CPUStateModel::soa_data_type &data);
 
     CPUKernel *const kernel;
+    // per-thread buffers collecting the reaction forces of the half-shell pair traversal, reused across steps
+    std::vector<std::vector<Vec3>> _forceBuffers;
+    // whether all buffer entries are zero, which holds after each completed reduction
+    bool _forceBuffersClean{false};
+    // thread which processed the cell in the last pair traversal
+    std::vector<std::size_t> _cellOwner;
 };
 }
 }
@@ -58,6 +58,11 @@ public:
     void perform() override;
 
 private:
+    /**
+     * Same integration step as perform(), operating on the position and force arrays of the particle data.
+     */
+    void performOnArrays(CPUStateModel::soa_data_type &data);
+
     CPUKernel *const kernel;
 };
 }
@@ -46,6 +46,8 @@
 #pragma once
 
 
+#include <array>
+
 #include <readdy/model/actions/Actions.h>
 #include "../CPUKernel.h"
 
@@ -56,18 +58,20 @@ class CPUEvaluateTopologyReactions : public readdy::model::actions::top::Evaluat
 public:
     CPUEvaluateTopologyReactions(CPUKernel* kernel, readdy::scalar timeStep);
 
+    ~CPUEvaluateTopologyReactions() override;
+
     void perform() override;
 
 private:
     struct TREvent;
 
-    bool eventsDependent(const TREvent& evt1, const TREvent& evt2) const;
+    std::array<std::size_t, 2> eventKeys(const TREvent &event) const;
 
     using topology_reaction_events = std::vector<TREvent>;
 
     CPUKernel *const kernel;
 
-    topology_reaction_events gatherEvents();
+    void gatherEvents(topology_reaction_events &events);
 
     bool topologyDeactivated(std::ptrdiff_t index) const;
 
@@ -79,6 +83,10 @@ private:
 
     void handleTopologyTopologyReaction(CPUStateModel::topology_ref &t1, CPUStateModel::topology_ref &t2,
                                         const TREvent& event);
+
+    // event and topology buffers, reused across steps
+    topology_reaction_events _events;
+    std::vector<CPUStateModel::topology> _newTopologies;
 };
 
 
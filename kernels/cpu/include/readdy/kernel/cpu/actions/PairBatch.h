@@ -0,0 +1,212 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Batched evaluation of pair potentials. The neighbors of a particle are gathered into small contiguous lane buffers,
+ * difference vectors (minimum image convention), squared distances and the force factors of the specialized kernels
+ * are then computed in branch-free loops over the lanes which the compiler can map onto SIMD registers.
+ * Type pairs that are not covered by a specialized kernel are evaluated lane by lane through the pair potential
+ * table.
+ *
+ * @file PairBatch.h
+ * @brief Batched evaluation of pair potentials for the CPU kernel
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <array>
+
+#include <readdy/common/common.h>
+#include <readdy/common/numeric.h>
+#include <readdy/model/potentials/PairPotentialTable.h>
+
+namespace readdy::kernel::cpu::actions {
+
+template<std::size_t Width = 8>
+class PairBatch {
+    using Dispatch = model::potentials::pair::TypePairPotentials::Dispatch;
+public:
+    static constexpr std::size_t width = Width;
+
+    PairBatch(const model::potentials::PairPotentialTable &table, const std::array<scalar, 3> &box,
+              const std::array<bool, 3> &pbc) : _table(table), _box(box), _pbc(pbc) {}
+
+    /**
+     * Adds a neighbor to the batch.
+     * @return true if the batch is full and has to be evaluated
+     */
+    bool add(std::size_t index, const Vec3 &pos, ParticleTypeId type) {
+        _indices[_size] = index;
+        _x[_size] = pos.x;
+        _y[_size] = pos.y;
+        _z[_size] = pos.z;
+        _types[_size] = type;
+        ++_size;
+        return _size == Width;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Evaluates all pairs (i, j) for neighbors j in the batch and empties it. The force on particle i is added to
+     * forceI, the reaction forces on the neighbors are subtracted from their forceBuffer entries.
+     */
+    template<bool COMPUTE_VIRIAL>
+    void evaluate(const Vec3 &posI, ParticleTypeId typeI, Vec3 &forceI, std::vector<Vec3> &forceBuffer,
+                  scalar &energy, Matrix33 &virial) {
+        alignas(64) std::array<scalar, Width> dx, dy, dz, d2, factor, laneEnergy;
+        alignas(64) std::array<scalar, Width> hrK, hrR0, hrCut2;
+        alignas(64) std::array<scalar, Width> ljK, ljSigma2, ljShift, ljCut2;
+        std::array<const model::potentials::pair::TypePairPotentials *, Width> generic;
+
+        for (std::size_t k = 0; k < Width; ++k) {
+            hrK[k] = hrR0[k] = hrCut2[k] = 0;
+            ljK[k] = ljShift[k] = ljCut2[k] = 0;
+            ljSigma2[k] = 1;
+            generic[k] = nullptr;
+        }
+        for (std::size_t k = 0; k < _size; ++k) {
+            const auto &potentials = _table(typeI, _types[k]);
+            switch (potentials.dispatch) {
+                case Dispatch::harmonicRepulsion: {
+                    const auto &p = potentials.harmonicRepulsion.front();
+                    hrK[k] = p.forceConstant;
+                    hrR0[k] = p.interactionDistance;
+                    hrCut2[k] = p.cutoffSquared;
+                    break;
+                }
+                case Dispatch::lennardJones126: {
+                    const auto &p = potentials.lennardJones.front();
+                    ljK[k] = p.k;
+                    ljSigma2[k] = p.sigma * p.sigma;
+                    ljShift[k] = p.energyShift;
+                    ljCut2[k] = p.cutoffSquared;
+                    break;
+                }
+                case Dispatch::generic: {
+                    generic[k] = &potentials;
+                    break;
+                }
+                case Dispatch::none: break;
+            }
+        }
+
+        // difference vectors x_j - x_i in the minimum image convention, see bcs::shortestDifference
+        differences(dx, _x, posI.x, 0);
+        differences(dy, _y, posI.y, 1);
+        differences(dz, _z, posI.z, 2);
+        for (std::size_t k = 0; k < Width; ++k) {
+            d2[k] = dx[k] * dx[k] + dy[k] * dy[k] + dz[k] * dz[k];
+        }
+
+        // harmonic repulsion, lanes without harmonic repulsion have a vanishing cutoff and are masked out
+        for (std::size_t k = 0; k < Width; ++k) {
+            const auto dist = std::sqrt(d2[k]);
+            const auto delta = dist - hrR0[k];
+            const bool inRange = d2[k] < hrCut2[k];
+            laneEnergy[k] = inRange ? static_cast<scalar>(.5) * hrK[k] * delta * delta : 0;
+            factor[k] = inRange && d2[k] > 0 ? hrK[k] * delta / dist : 0;
+        }
+        // 12-6 Lennard-Jones
+        for (std::size_t k = 0; k < Width; ++k) {
+            const bool inRange = d2[k] < ljCut2[k];
+            const auto s2 = ljSigma2[k] / d2[k];
+            const auto s6 = s2 * s2 * s2;
+            const auto s12 = s6 * s6;
+            laneEnergy[k] += inRange ? ljK[k] * (s12 - s6) - ljShift[k] : 0;
+            factor[k] += inRange ? -ljK[k] / ljSigma2[k] * (12 * s12 - 6 * s6) * s2 : 0;
+        }
+
+        scalar fx {0}, fy {0}, fz {0}, e {0};
+        for (std::size_t k = 0; k < Width; ++k) {
+            fx += factor[k] * dx[k];
+            fy += factor[k] * dy[k];
+            fz += factor[k] * dz[k];
+            e += laneEnergy[k];
+        }
+
+        for (std::size_t k = 0; k < _size; ++k) {
+            Vec3 f {factor[k] * dx[k], factor[k] * dy[k], factor[k] * dz[k]};
+            if (generic[k] != nullptr && d2[k] < generic[k]->maxCutoffSquared) {
+                Vec3 x_ij {dx[k], dy[k], dz[k]};
+                generic[k]->calculateForceAndEnergy(f, e, x_ij, d2[k]);
+                fx += f.x;
+                fy += f.y;
+                fz += f.z;
+            }
+            if (f.x != 0 || f.y != 0 || f.z != 0) {
+                forceBuffer[_indices[k]] -= f;
+                if (COMPUTE_VIRIAL) {
+                    virial += math::outerProduct<Matrix33>(-1. * Vec3{dx[k], dy[k], dz[k]}, f);
+                }
+            }
+        }
+        forceI += Vec3{fx, fy, fz};
+        energy += e;
+        _size = 0;
+    }
+
+private:
+    void differences(std::array<scalar, Width> &out, const std::array<scalar, Width> &coords, scalar ref,
+                     std::size_t dim) const {
+        const auto box = _box[dim];
+        const auto halfBox = static_cast<scalar>(.5) * box;
+        if (_pbc[dim]) {
+            for (std::size_t k = 0; k < Width; ++k) {
+                const auto d = coords[k] - ref;
+                out[k] = d > halfBox ? d - box : (d <= -halfBox ? d + box : d);
+            }
+        } else {
+            for (std::size_t k = 0; k < Width; ++k) {
+                out[k] = coords[k] - ref;
+            }
+        }
+    }
+
+    const model::potentials::PairPotentialTable &_table;
+    const std::array<scalar, 3> &_box;
+    const std::array<bool, 3> &_pbc;
+
+    std::size_t _size {0};
+    std::array<std::size_t, Width> _indices {};
+    alignas(64) std::array<scalar, Width> _x {}, _y {}, _z {};
+    std::array<ParticleTypeId, Width> _types {};
+};
+
+}
@@ -0,0 +1,105 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Detailed balance reaction handler of the CPU kernel. Reversible reactions are performed as Monte Carlo moves that
+ * are accepted according to the energy difference, see readdy::model::actions::reactions::DetailedBalance. Events are
+ * gathered in parallel and the energies are evaluated in parallel over the cost balanced cells of the neighbor list,
+ * the events themselves are evaluated one after another.
+ *
+ * @file CPUDetailedBalance.h
+ * @brief Declaration of the CPU detailed balance reaction handler
+ * @author clonker
+ * @author chrisfroe
+ * @date 16.10.26
+ */
+
+#pragma once
+
+#include <readdy/model/actions/Actions.h>
+#include <readdy/kernel/cpu/CPUKernel.h>
+#include "ReactionUtils.h"
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+namespace reactions {
+
+class CPUDetailedBalance : public readdy::model::actions::reactions::DetailedBalance {
+    using super = readdy::model::actions::reactions::DetailedBalance;
+    using reversible_reaction = readdy::model::actions::reactions::ReversibleReactionConfig;
+    using reaction_t = readdy::model::reactions::Reaction;
+public:
+    CPUDetailedBalance(CPUKernel *kernel, scalar timeStep);
+
+    void perform() override;
+
+protected:
+    /**
+     * The educts of a reversible reaction event, required for restoring them if the move is rejected.
+     */
+    struct ParticleBackup {
+        std::uint8_t nParticles; // either 1 or 2
+        ParticleTypeId t1, t2;
+        Vec3 pos1, pos2;
+
+        ParticleBackup(const event_t &event, const reversible_reaction *revReaction, const reaction_t *reaction,
+                       const data_t *data);
+    };
+
+    // calculate first-order interactions and second-order non-bonded interactions
+    void calculateEnergies();
+
+    std::pair<data_t::DataUpdate, scalar>
+    performReversibleReactionEvent(const event_t &event, const reversible_reaction *reversibleReaction,
+                                   const reaction_t *reaction, record_t *record) const;
+
+    static data_t::DataUpdate generateBackwardUpdate(const ParticleBackup &particleBackup,
+                                                     const std::vector<data_t::size_type> &updateRecord);
+
+    std::pair<const reversible_reaction *, const reaction_t *> findReversibleReaction(const event_t &event) const;
+
+    CPUKernel *const kernel;
+    // buffers of the parallel gathering, reused across steps
+    EventBuffers _eventBuffers;
+    std::vector<event_t> _events;
+};
+
+}
+}
+}
+}
+}
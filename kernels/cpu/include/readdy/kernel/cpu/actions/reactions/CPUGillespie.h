@@ -66,6 +66,12 @@ public:
 
 protected:
     CPUKernel *const kernel;
+    // buffers of the parallel gathering, reused across steps
+    EventBuffers _eventBuffers;
+    std::vector<event_t> _events;
+    // new and decayed entries of a step, handed to the particle data and reused across steps
+    data_t::DataUpdate _update;
+    FirstOrderSampler _firstOrderSampler;
 };
 }
 }
@@ -42,6 +42,8 @@
 
 #pragma once
 #include <readdy/kernel/cpu/CPUKernel.h>
+#include <readdy/kernel/cpu/actions/reactions/Event.h>
+#include <readdy/kernel/cpu/actions/reactions/ReactionUtils.h>
 
 namespace readdy {
 namespace kernel {
@@ -58,6 +60,25 @@ public:
 
 protected:
     CPUKernel *const kernel;
+    // per-thread event buffers, reused across steps
+    std::vector<std::vector<Event>> _threadEvents;
+    // all events of a step in shuffled order, the accepted ones and the first ids of their products
+    std::vector<Event> _events;
+    std::vector<Event> _accepted;
+    std::vector<ParticleId> _firstIds;
+    // a particle is claimed by an accepted event of the current step if its stamp equals _claimEpoch
+    std::vector<std::uint32_t> _claimed;
+    std::uint32_t _claimEpoch{0};
+    // per-thread results of performing the accepted events, merged in thread order
+    struct ThreadUpdate {
+        data::EntryDataContainer::EntriesUpdate newParticles;
+        std::vector<data::EntryDataContainer::size_type> decayedEntries;
+        std::vector<readdy::model::reactions::ReactionRecord> records;
+    };
+    std::vector<ThreadUpdate> _threadUpdates;
+    // merged update handed to the particle data, it keeps its capacity across steps
+    data::EntryDataContainer::DataUpdate _update;
+    FirstOrderSampler _firstOrderSampler;
 };
 }
 }
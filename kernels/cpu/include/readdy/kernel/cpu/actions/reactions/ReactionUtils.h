@@ -44,6 +44,7 @@
 
 #pragma once
 #include <cmath>
+#include <optional>
 #include <readdy/model/RandomProvider.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
 #include <readdy/common/logging.h>
@@ -75,24 +76,97 @@ inline bool shouldPerformEvent(const readdy::scalar rate, const readdy::scalar t
     return approximated ? performReactionEvent<true>(rate, timestep) : performReactionEvent<false>(rate, timestep);
 }
 
+/**
+ * Variant of shouldPerformEvent which takes the uniform number in (0, 1) from the caller, e.g., from a
+ * counter-based stream.
+ */
+inline bool shouldPerformEvent(const readdy::scalar rate, const readdy::scalar timestep, bool approximated,
+                               const readdy::scalar uniform) {
+    return approximated ? uniform < rate * timestep : uniform < 1 - std::exp(-rate * timestep);
+}
+
+/**
+ * Buffers of gatherEventsParallel, kept by the reaction handlers so that they are reused across steps.
+ */
+struct EventBuffers {
+    // events of the particle ranges and cell chunks in the order of gathering
+    std::vector<std::vector<event_t>> chunkEvents;
+    // total rate and offset of the cumulative rates of each buffer of chunkEvents
+    std::vector<scalar> chunkRates;
+    std::vector<scalar> rateOffsets;
+    // bounds for scheduling the cell chunks one by one
+    std::vector<std::size_t> chunkIndices;
+};
+
+/**
+ * Gathers the events of all particles and pairs in parallel into events, in the same order as the serial
+ * gatherEvents. The particles are split statically over the threads, the pairs along the cost balanced cell chunks of
+ * the neighbor list, each range is gathered into a buffer of buffers.chunkEvents.
+ */
+void gatherEventsParallel(CPUKernel *kernel, EventBuffers &buffers, std::vector<event_t> &events,
+                          bool firstOrder = true);
+
+/**
+ * Handles the events in Gillespie order.
+ * @param firstOrderInAdvance whether the first order events were already decided on, e.g., by a FirstOrderSampler,
+ *                            so that only the second order events are subject to a draw
+ */
 data_t::DataUpdate handleEventsGillespie(
         CPUKernel* kernel, readdy::scalar timeStep,
         bool filterEventsInAdvance, bool approximateRate,
-        std::vector<event_t> &&events, std::vector<record_t> *maybeRecords, reaction_counts_map *maybeCounts);
+        std::vector<event_t> &events, std::vector<record_t> *maybeRecords, reaction_counts_map *maybeCounts,
+        bool firstOrderInAdvance = false);
+
+/**
+ * Handles the events in Gillespie order, the new and decayed entries are written into update, which is cleared
+ * first, so that a buffer kept across steps can be passed. The event index lives in the kernel's scratch arena.
+ */
+void handleEventsGillespie(
+        CPUKernel* kernel, readdy::scalar timeStep,
+        bool filterEventsInAdvance, bool approximateRate,
+        std::vector<event_t> &events, data_t::DataUpdate &update, std::vector<record_t> *maybeRecords,
+        reaction_counts_map *maybeCounts, bool firstOrderInAdvance = false);
 
+/**
+ * Samples the first order events of a time step without a random number per particle: for each type and reaction
+ * the number of reacting particles is drawn from a binomial distribution, which are then picked uniformly among
+ * the active particles of that type. This has the same distribution as one draw per particle and reaction. The
+ * particles are grouped by type with a counting sort over the particle data, the buffers are reused across calls.
+ */
+class FirstOrderSampler {
+public:
+    /**
+     * Appends the sampled events to events, the draws of each type and reaction are keyed by (epoch, type, reaction
+     * index) so that they do not depend on the number of threads.
+     */
+    void sample(CPUKernel *kernel, scalar timeStep, bool approximateRate, std::uint32_t epoch,
+                std::vector<event_t> &events);
+
+private:
+    std::vector<std::size_t> _positions;
+    std::vector<std::size_t> _offsets;
+    std::vector<event_t::index_type> _indices;
+};
+
+/**
+ * Appends the first order events of the given particles and the second order events of the pairs in the cells
+ * [cellBegin, cellEnd) of the neighbor list to events. The cumulative rates start at alpha, which is increased by the
+ * rates of all appended events.
+ */
 template<typename ParticleIndexCollection>
 void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &particles, const neighbor_list* nl,
-                  const data_t *data, readdy::scalar &alpha, std::vector<event_t> &events) {
+                  const data_t *data, readdy::scalar &alpha, std::vector<event_t> &events,
+                  std::size_t cellBegin, std::size_t cellEnd) {
     const auto &box = kernel->context().boxSize();
     const auto &pbc = kernel->context().periodicBoundaryConditions();
-    const auto& reaction_registry = kernel->context().reactions();
+    const auto &interactions = kernel->interactions();
     for (const auto index : particles) {
         const auto &entry = data->entry_at(index);
         // this being false should really not happen, though
         if (!entry.deactivated) {
             // order 1
             {
-                const auto &reactions = kernel->context().reactions().order1ByType(entry.type);
+                const auto &reactions = interactions.reactionsOrder1(entry.type);
                 for (auto it = reactions.begin(); it != reactions.end(); ++it) {
                     const auto rate = (*it)->rate();
                     if (rate > 0) {
@@ -108,7 +182,7 @@ void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &partic
     }
 
     // order 2
-    for(std::size_t cell = 0; cell < nl->nCells(); ++cell) {
+    for(std::size_t cell = cellBegin; cell < cellEnd; ++cell) {
         for(auto particleIt = nl->particlesBegin(cell); particleIt != nl->particlesEnd(cell); ++particleIt) {
             const auto &idx1 = *particleIt;
             const auto &entry = data->entry_at(idx1);
@@ -120,9 +194,10 @@ void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &partic
                 if(idx1 > idx2) return;
                 const auto &neighbor = data->entry_at(idx2);
                 if(!neighbor.deactivated) {
-                    const auto &reactions = kernel->context().reactions().order2ByType(entry.type, neighbor.type);
-                    if (!reactions.empty()) {
-                        const auto distSquared = bcs::distSquared(neighbor.pos, entry.pos, box, pbc);
+                    if (!interactions.hasReactionsOrder2(entry.type, neighbor.type)) return;
+                    const auto distSquared = bcs::distSquared(neighbor.pos, entry.pos, box, pbc);
+                    if (distSquared < interactions.maxEductDistanceSquared(entry.type, neighbor.type)) {
+                        const auto reactions = interactions.reactionsOrder2(entry.type, neighbor.type);
                         for (auto itReactions = reactions.begin(); itReactions < reactions.end(); ++itReactions) {
                             const auto &react = *itReactions;
                             const auto rate = react->rate();
@@ -143,10 +218,54 @@ void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &partic
     }
 }
 
+template<typename ParticleIndexCollection>
+void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &particles, const neighbor_list* nl,
+                  const data_t *data, readdy::scalar &alpha, std::vector<event_t> &events) {
+    gatherEvents(kernel, particles, nl, data, alpha, events, 0, nl->nCells());
+}
+
+/**
+ * Number of new particle ids that performing the reaction requires.
+ */
+template<typename Reaction>
+std::size_t nProductIds(const Reaction* reaction) {
+    switch(reaction->type()) {
+        case reaction_type::Decay: return 0;
+        case reaction_type::Fission: return 2;
+        default: return 1;
+    }
+}
+
+/**
+ * In reproducible runs, reserves the ids of the products of a reaction from the global id counter, so that they only
+ * depend on the order in which the events are performed and not on the id block left over in the calling thread.
+ * @return the first of nProductIds(reaction) reserved ids, or nothing if the ids can be taken from the thread's block
+ */
+template<typename Reaction>
+std::optional<readdy::ParticleId> reserveProductIds(const CPUKernel *kernel, const Reaction *reaction) {
+    if (!kernel->reproducible()) {
+        return std::nullopt;
+    }
+    return readdy::model::Particle::reserveIds(nProductIds(reaction));
+}
+
+/**
+ * Performs a reaction on the educts idx1 and idx2 (which coincide for first order reactions). Only the entries idx1
+ * and idx2 are modified, new and decayed entries are appended to the given buffers, so that reactions on disjoint
+ * educts can be performed concurrently.
+ * @param stream if not null, random numbers are drawn from it instead of the thread's generator
+ * @param ids if not null, the first of nProductIds(reaction) ids reserved for this reaction, otherwise the ids are
+ *            taken from the thread's id block
+ */
 template<typename Reaction>
 void performReaction(data_t* data, const readdy::model::Context& context, data_t::size_type idx1, data_t::size_type idx2,
                      data_t::EntriesUpdate& newEntries, std::vector<data_t::size_type>& decayedEntries,
-                     Reaction* reaction, record_t* record) {
+                     Reaction* reaction, record_t* record, readdy::model::rnd::CounterBasedStream *stream = nullptr,
+                     const readdy::ParticleId *ids = nullptr) {
+    std::size_t nIds = 0;
+    auto nextId = [&]() {
+        return ids ? *ids + nIds++ : readdy::model::Particle::nextThreadLocalId();
+    };
 
     const auto &pbc = context.periodicBoundaryConditions().data();
     const auto &box = context.boxSize().data();
@@ -168,7 +287,7 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
         }
         case reaction_type::Conversion: {
             entry1.type = reaction->products()[0];
-            entry1.id = readdy::model::Particle::nextId();
+            data->reassignId(idx1, nextId());
             if(record) record->products[0] = entry1.id;
             break;
         }
@@ -176,11 +295,11 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             if (entry1.type == reaction->educts()[1]) {
                 // p1 is the catalyst
                 entry2.type = reaction->products()[0];
-                entry2.id = readdy::model::Particle::nextId();
+                data->reassignId(idx2, nextId());
             } else {
                 // p2 is the catalyst
                 entry1.type = reaction->products()[0];
-                entry1.id = readdy::model::Particle::nextId();
+                data->reassignId(idx1, nextId());
             }
             if(record) {
                 record->products[0] = entry1.id;
@@ -189,17 +308,17 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             break;
         }
         case reaction_type::Fission: {
-            auto n3 = readdy::model::rnd::normal3<readdy::scalar>(0, 1);
+            auto n3 = stream ? stream->normal3() : readdy::model::rnd::normal3<readdy::scalar>(0, 1);
             n3 /= std::sqrt(n3 * n3);
 
             //readdy::model::Particle p (, reaction->products()[1]);
-            const auto id = readdy::model::Particle::nextId();
+            const auto id = nextId();
             newEntries.emplace_back(bcs::applyPBC(entry1.pos - reaction->weight2() * reaction->productDistance() * n3,
                                                   box, pbc),
                                     reaction->products()[1], id);
 
             entry1.type = reaction->products()[0];
-            entry1.id = readdy::model::Particle::nextId();
+            data->reassignId(idx1, nextId());
             data->displace(idx1, reaction->weight1() * reaction->productDistance() * n3);
             if(record) {
                 record->products[0] = entry1.id;
@@ -213,10 +332,10 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             const auto difference = bcs::shortestDifference(e1Pos, e2Pos, box, pbc);
             if (reaction->educts()[0] == entry1.type) {
                 newEntries.emplace_back(bcs::applyPBC(entry1.pos + reaction->weight1() * difference, box, pbc),
-                                        reaction->products()[0], readdy::model::Particle::nextId());
+                                        reaction->products()[0], nextId());
             } else {
                 newEntries.emplace_back(bcs::applyPBC(entry1.pos + reaction->weight2() * difference, box, pbc),
-                                        reaction->products()[0], readdy::model::Particle::nextId());
+                                        reaction->products()[0], nextId());
             }
             decayedEntries.push_back(idx1);
             decayedEntries.push_back(idx2);
@@ -44,7 +44,11 @@
 
 #pragma once
 
+#include <limits>
 #include <functional>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
 #include <readdy/model/Context.h>
 #include <readdy/common/thread/Config.h>
 #include <readdy/common/signals.h>
@@ -66,6 +70,13 @@ public:
 
     using iterator = typename Entries::iterator;
     using const_iterator = typename Entries::const_iterator;
+    // signal carrying the map from old to new entry indices after the entries were reordered
+    using reorder_signal_type = signals::signal<void(const std::vector<size_type> &)>;
+
+    /**
+     * new index of entries that were dropped during a reorder
+     */
+    static constexpr size_type removedIndex = std::numeric_limits<size_type>::max();
 
     DataContainer(const readdy::model::Context &context, thread_pool &pool)
             : _context(context), _pool(pool) {};
@@ -82,9 +93,11 @@ public:
         return size() == getNDeactivated();
     };
 
-    void clear() {
+    virtual void clear() {
         _entries.clear();
         _blanks.clear();
+        _idIndex.clear();
+        ++_particleSetVersion;
     };
 
     void addParticle(const Particle &particle) {
@@ -124,44 +137,49 @@ public:
     };
 
     void removeParticle(const Particle &particle) {
-        auto it_entries = begin();
-        std::size_t idx = 0;
-        for(; it_entries != end(); ++it_entries, ++idx) {
-            if(!it_entries->deactivated && it_entries->id == particle.id()) {
-                _blanks.push_back(idx);
-                it_entries->deactivated = true;
-                return;
-            }
+        const auto idx = findIndexForId(particle.id());
+        if(idx != removedIndex) {
+            removeParticle(idx);
+        } else {
+            log::error("Tried to remove particle ({}) which did not exist or was already deactivated!", particle);
         }
-        log::error("Tried to remove particle ({}) which did not exist or was already deactivated!", particle);
     };
 
-    void removeParticle(size_type index) {
+    virtual void removeParticle(size_type index) {
         auto& p = *(_entries.begin() + index);
         if(!p.deactivated) {
+            unindexEntry(index);
             _blanks.push_back(index);
             p.deactivated = true;
+            ++_particleSetVersion;
         } else {
             log::error("Tried to remove particle (index={}), that was already removed!", index);
         }
     };
 
-    void removeEntry(size_type index) {
+    virtual void removeEntry(size_type index) {
         auto &entry = _entries.at(index);
         if(!entry.deactivated) {
+            unindexEntry(index);
             entry.deactivated = true;
             _blanks.push_back(index);
+            ++_particleSetVersion;
         } else {
             log::critical("Tried removing particle {} which was already deactivated!", index);
         }
     };
 
+    /**
+     * Looks up the index of the active entry with the given id. The id to index map behind this lookup is built on
+     * first use and maintained by the container from then on. Ids that were changed in place through reassignId
+     * are picked up by rebuilding the map once on the next lookup. Lookups may be issued concurrently.
+     * @param id the particle id
+     * @return the entry index
+     */
     size_type getIndexForId(ParticleId id) const {
-        auto find_it = std::find_if(_entries.begin(), _entries.end(), [id](const T& e) {
-            return !e.deactivated && e.id == id;
-        });
-        if(find_it != _entries.end()) {
-            return static_cast<size_type>(std::distance(_entries.begin(), find_it));
+        const auto index = findIndexForId(id);
+        if(index != removedIndex) {
+            return index;
         }
         throw std::out_of_range("requested id was not to be found in particle data");
     };
@@ -198,6 +216,17 @@ public:
         return _entries.at(index);
     }
 
+    /**
+     * Changes the id of an entry in place. Can be called concurrently for distinct entries, e.g., when reactions are
+     * performed in parallel, the id to index map is then rebuilt on the next lookup.
+     * @param index the entry index
+     * @param id the new id
+     */
+    void reassignId(size_type index, ParticleId id) {
+        _entries.at(index).id = id;
+        _idIndexStale.store(true, std::memory_order_relaxed);
+    }
+
     const T &centry_at(size_type index) const {
         return _entries.at(index);
     }
@@ -210,7 +239,12 @@ public:
         return _blanks.size();
     }
 
-    virtual std::vector<size_type> update(DataUpdate &&) = 0;
+    /**
+     * Applies the update: new entries are placed into the removed ones first, then into blanks or appended.
+     * @return the indices at which the new entries were placed, in their order; the buffer is owned by the container
+     *         and valid until the next call to update
+     */
+    virtual const std::vector<size_type> &update(DataUpdate &&) = 0;
 
     virtual void displace(size_type entry, const Particle::Position &delta) = 0;
 
@@ -230,12 +264,101 @@ public:
         return _blanks;
     }
 
+    /**
+     * Counter that is incremented whenever particles are added, removed or replaced. Positions may change
+     * without affecting it.
+     * @return the current version of the particle set
+     */
+    std::size_t particleSetVersion() const {
+        return _particleSetVersion;
+    }
+
+    /**
+     * Fired after the entries were reordered with the map from old to new indices, so that indices kept outside of
+     * this container (e.g., in topologies) can be updated. Dropped entries are mapped to removedIndex.
+     * @return the reorder signal
+     */
+    reorder_signal_type &reorderSignal() {
+        return _reorderSignal;
+    }
+
 protected:
+    /**
+     * @return the index of the active entry with the given id or removedIndex if there is none
+     */
+    size_type findIndexForId(ParticleId id) const {
+        std::lock_guard<std::mutex> lock(_idIndexMutex);
+        const auto stale = _idIndexStale.exchange(false, std::memory_order_relaxed);
+        if(!_idIndexBuilt || stale) {
+            rebuildIdIndex();
+        }
+        auto it = _idIndex.find(id);
+        return it != _idIndex.end() ? it->second : removedIndex;
+    }
+
+    /**
+     * Builds the id to index map from the active entries, to be called with the map's mutex held.
+     */
+    void rebuildIdIndex() const {
+        _idIndex.clear();
+        _idIndex.reserve(_entries.size());
+        for(size_type i = 0; i < _entries.size(); ++i) {
+            if(!_entries[i].deactivated) {
+                _idIndex[_entries[i].id] = i;
+            }
+        }
+        _idIndexBuilt = true;
+    }
+
+    /**
+     * Records the entry at the given index in the id to index map, to be called after an entry was placed.
+     */
+    void indexEntry(size_type index) {
+        if(_idIndexBuilt && !_entries[index].deactivated) {
+            _idIndex[_entries[index].id] = index;
+        }
+    }
+
+    /**
+     * Removes the entry at the given index from the id to index map, to be called before it is deactivated or
+     * overwritten.
+     */
+    void unindexEntry(size_type index) {
+        if(_idIndexBuilt) {
+            auto it = _idIndex.find(_entries[index].id);
+            if(it != _idIndex.end() && it->second == index) {
+                _idIndex.erase(it);
+            }
+        }
+    }
+
+    /**
+     * Moves the id to index map along with a reorder of the entries.
+     */
+    void remapIdIndex(const std::vector<size_type> &oldToNew) {
+        for(auto it = _idIndex.begin(); it != _idIndex.end();) {
+            if(it->second < oldToNew.size() && oldToNew[it->second] != removedIndex) {
+                it->second = oldToNew[it->second];
+                ++it;
+            } else {
+                it = _idIndex.erase(it);
+            }
+        }
+    }
+
     std::reference_wrapper<const readdy::model::Context> _context;
     std::reference_wrapper<thread_pool> _pool;
 
     std::vector<size_type> _blanks {};
+    std::vector<size_type> _updateIndices {};
     Entries _entries {};
+    std::size_t _particleSetVersion {0};
+    reorder_signal_type _reorderSignal {};
+    // exact as long as it is built and not stale, mutators other than reassignId keep it up to date
+    mutable std::unordered_map<ParticleId, size_type> _idIndex {};
+    mutable bool _idIndexBuilt {false};
+    mutable std::atomic<bool> _idIndexStale {false};
+    mutable std::mutex _idIndexMutex {};
 };
 
 struct Entry {
@@ -255,8 +378,6 @@ struct Entry {
 
     Entry &operator=(Entry &&) noexcept = default;
 
-    virtual ~Entry() = default;
-
     Vec3 force;
     Vec3 pos;
     std::ptrdiff_t topology_index{-1};
@@ -45,8 +45,13 @@
 
 #pragma once
 
+#include <cmath>
+#include <tuple>
+#include <algorithm>
+
 #include <readdy/model/Particle.h>
 #include <readdy/kernel/cpu/pool.h>
+#include <readdy/common/space_filling_curve.h>
 #include <readdy/common/boundary_condition_operations.h>
 #include "DataContainer.h"
 
@@ -77,25 +82,31 @@ public:
     };
 
     size_type addEntry(Entry &&entry) override {
+        ++_particleSetVersion;
         if(!_blanks.empty()) {
             const auto idx = _blanks.back();
             _blanks.pop_back();
             _entries.at(idx) = std::move(entry);
+            indexEntry(idx);
             return idx;
         }
 
         _entries.push_back(std::move(entry));
+        indexEntry(_entries.size()-1);
         return _entries.size()-1;
     }
 
     void addParticles(const std::vector<Particle> &particles) override {
+        ++_particleSetVersion;
         for(const auto& p : particles) {
             if(!_blanks.empty()) {
                 const auto idx = _blanks.back();
                 _blanks.pop_back();
                 _entries.at(idx) = Entry(p);
+                indexEntry(idx);
             } else {
                 _entries.emplace_back(p);
+                indexEntry(_entries.size()-1);
             }
         }
     }
@@ -104,6 +115,7 @@ public:
     addTopologyParticles(const std::vector<Particle> &topologyParticles) override {
         std::vector<size_type> indices;
         indices.reserve(topologyParticles.size());
+        ++_particleSetVersion;
         for(const auto& p : topologyParticles) {
             if(!_blanks.empty()) {
                 const auto idx = _blanks.back();
@@ -114,28 +126,37 @@ public:
                 _entries.emplace_back(p);
                 indices.push_back(_entries.size()-1);
             }
+            indexEntry(indices.back());
         }
         return indices;
     }
 
-    std::vector<size_type> update(DataUpdate &&update) override {
+    const std::vector<size_type> &update(DataUpdate &&update) override {
         auto &&newEntries = std::move(std::get<0>(update));
         auto &&removedEntries = std::move(std::get<1>(update));
+        if(!newEntries.empty() || !removedEntries.empty()) {
+            ++_particleSetVersion;
+        }
 
+        auto &newIndices = _updateIndices;
+        newIndices.clear();
         auto it_del = removedEntries.begin();
         for(auto&& newEntry : newEntries) {
             if(it_del != removedEntries.end()) {
+                unindexEntry(*it_del);
                 _entries.at(*it_del) = std::move(newEntry);
+                indexEntry(*it_del);
+                newIndices.push_back(*it_del);
                 ++it_del;
             } else {
-                addEntry(std::move(newEntry));
+                newIndices.push_back(addEntry(std::move(newEntry)));
             }
         }
         while(it_del != removedEntries.end()) {
             removeEntry(*it_del);
             ++it_del;
         }
-        return {};
+        return newIndices;
     }
 
     void displace(size_type index, const Particle::Position &delta) override {
@@ -145,58 +166,61 @@ public:
                          _context.get().periodicBoundaryConditions().data());
     };
 
-    /*void hilbertSort(scalar gridWidth) {
-        if(!empty()) {
-            using indices_it = std::vector<std::size_t>::iterator;
-            std::vector<std::size_t> hilbert_indices;
-            std::vector<std::size_t> indices(size());
-
-            const auto grainSize = size() / _pool.get().size();
-            std::iota(indices.begin(), indices.end(), 0);
-            hilbert_indices.resize(size());
-
-            auto worker = [&](std::size_t, const_iterator begin, const_iterator end, indices_it hilbert_begin) {
-                {
-                    auto it = begin;
-                    auto hilbert_it = hilbert_begin;
-                    for (; it != end; ++it, ++hilbert_it) {
-                        if (!it->deactivated) {
-                            const auto integer_coordinates = project(it->pos, gridWidth);
-                            *hilbert_it = 1 + static_cast<std::size_t>(hilbert_c2i(3, CHAR_BIT, integer_coordinates.data()));
-                        } else {
-                            *hilbert_it = 0;
-                        }
-                    }
+    /**
+     * Reorders the entries along a space filling curve of a grid with the given cell widths, so that particles which
+     * are close in space are also close in memory. Deactivated entries are dropped. Afterwards the reorder signal is
+     * fired with the map from old to new indices.
+     * @param gridWidth the widths of the grid cells along which the entries are ordered
+     * @param hilbert whether to use the Hilbert curve, otherwise the Morton curve is used
+     */
+    virtual void reorder(const Vec3 &gridWidth, bool hilbert) {
+        const auto &box = _context.get().boxSize();
+        std::array<std::uint64_t, 3> nCells {};
+        std::uint64_t maxCells = 1;
+        for (std::size_t d = 0; d < 3; ++d) {
+            nCells[d] = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(box[d] / gridWidth[d])));
+            maxCells = std::max(maxCells, nCells[d]);
+        }
+        unsigned int nBits = 1;
+        while (nBits < util::sfc::maxBits && (std::uint64_t{1} << nBits) < maxCells) ++nBits;
+
+        // pairs of curve index and entry index, deactivated entries are sorted to the back
+        std::vector<std::tuple<std::uint64_t, size_type>> keys(_entries.size());
+        _pool.get().parallel_for(0, _entries.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto &entry = _entries[i];
+                if (entry.deactivated) {
+                    keys[i] = std::make_tuple(std::numeric_limits<std::uint64_t>::max(), i);
+                    continue;
                 }
-            };
-            {
-                std::vector<util::thread::joining_future<void>> futures;
-                futures.reserve(_pool.get().size());
-                auto data_it = begin();
-                auto hilberts_it = hilbert_indices.begin();
-                for (std::size_t i = 0; i < _pool.get().size() - 1; ++i) {
-                    futures.emplace_back(_pool.get().push(worker, data_it, data_it + grainSize, hilberts_it));
-                    data_it += grainSize;
-                    hilberts_it += grainSize;
+                std::array<std::uint64_t, 3> cell {};
+                for (std::size_t d = 0; d < 3; ++d) {
+                    const auto x = std::floor((entry.pos[d] + .5 * box[d]) / gridWidth[d]);
+                    cell[d] = std::min(static_cast<std::uint64_t>(std::max<scalar>(x, 0)), nCells[d] - 1);
                 }
-                futures.emplace_back(_pool.get().push(worker, data_it, end(), hilberts_it));
-            }
-            {
-                std::sort(indices.begin(), indices.end(),
-                          [&hilbert_indices](std::size_t i, std::size_t j) -> bool {
-                              return hilbert_indices[i] < hilbert_indices[j];
-                          });
+                const auto index = hilbert ? util::sfc::hilbertIndex(cell, nBits) : util::sfc::mortonIndex(cell, nBits);
+                keys[i] = std::make_tuple(index, i);
             }
-
-            blanks_moved_to_front();
-            std::vector<std::size_t> inverseIndices(indices.size());
-            for(std::size_t i = 0; i < indices.size(); ++i) {
-                inverseIndices[indices[i]] = i;
-            }
-            reorderSignal->fire_signal(inverseIndices);
-            readdy::util::collections::reorder_destructive(inverseIndices.begin(), inverseIndices.end(), begin());
+        });
+        std::sort(keys.begin(), keys.end());
+
+        const auto nActive = static_cast<std::size_t>(std::count_if(_entries.begin(), _entries.end(), [](const auto &e) {
+            return !e.deactivated;
+        }));
+        std::vector<size_type> oldToNew(_entries.size(), removedIndex);
+        Entries reordered;
+        reordered.reserve(_entries.capacity());
+        for (std::size_t i = 0; i < nActive; ++i) {
+            const auto oldIndex = std::get<1>(keys[i]);
+            oldToNew[oldIndex] = i;
+            reordered.push_back(std::move(_entries[oldIndex]));
         }
-    };*/
+        _entries = std::move(reordered);
+        _blanks.clear();
+        remapIdIndex(oldToNew);
+        ++_particleSetVersion;
+        _reorderSignal.fire_signal(oldToNew);
+    }
 
 };
 
@@ -0,0 +1,336 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * Structure of arrays variant of the particle data. The entries are kept as in the DefaultDataContainer so that
+ * all actions operating on the DataContainer interface keep working. If the arrays are enabled (see
+ * conf::cpu::Configuration::structureOfArrays), positions, forces and types are additionally held in contiguous
+ * arrays together with a bitmask of active particles. Actions operating on the arrays write positions and forces
+ * there only and report it via arrayPositionsChanged() / arrayForcesChanged(), the entries are brought up to date
+ * lazily by syncEntries() once someone accesses them. Conversely, whoever hands out the entries for writing calls
+ * invalidateArrays(), and the arrays are gathered again by syncArrays() before their next use. Structural changes
+ * through the container keep both sides current. While disabled, the container behaves exactly like the
+ * DefaultDataContainer.
+ *
+ * @file SoADataContainer.h
+ * @brief Structure of arrays particle store for the CPU kernel
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "DefaultDataContainer.h"
+
+namespace readdy::kernel::cpu::data {
+
+class SoADataContainer : public DefaultDataContainer {
+    using super = DefaultDataContainer;
+public:
+    using mask_block = std::uint64_t;
+    static constexpr std::size_t maskBlockSize = 8 * sizeof(mask_block);
+
+    SoADataContainer(const model::Context &context, thread_pool &pool) : DefaultDataContainer(context, pool) {};
+
+    explicit SoADataContainer(EntryDataContainer *entryDataContainer) : DefaultDataContainer(entryDataContainer) {
+        enableArrays(true);
+    }
+
+    /**
+     * Switches the maintenance of the arrays on or off. Enabling gathers the current entries, disabling releases
+     * the arrays.
+     * @param enabled whether the arrays are maintained
+     */
+    void enableArrays(bool enabled) {
+        syncEntries();
+        _arraysEnabled = enabled;
+        if (enabled) {
+            gather();
+        } else {
+            for (auto *array : {&_x, &_y, &_z, &_fx, &_fy, &_fz}) {
+                std::vector<scalar>().swap(*array);
+            }
+            std::vector<ParticleTypeId>().swap(_types);
+            std::vector<mask_block>().swap(_active);
+        }
+    }
+
+    [[nodiscard]] bool arraysEnabled() const {
+        return _arraysEnabled;
+    }
+
+    void reserve(std::size_t n) override {
+        super::reserve(n);
+        if (!_arraysEnabled) return;
+        for (auto *array : {&_x, &_y, &_z, &_fx, &_fy, &_fz}) {
+            array->reserve(n);
+        }
+        _types.reserve(n);
+        _active.reserve(nMaskBlocks(n));
+    }
+
+    size_type addEntry(Entry &&entry) override {
+        syncEntries();
+        auto idx = super::addEntry(std::move(entry));
+        if (_arraysEnabled) {
+            resizeArrays();
+            gatherEntry(idx);
+        }
+        return idx;
+    }
+
+    void addParticles(const std::vector<Particle> &particles) override {
+        syncEntries();
+        super::addParticles(particles);
+        if (_arraysEnabled) gather();
+    }
+
+    std::vector<size_type> addTopologyParticles(const std::vector<Particle> &topologyParticles) override {
+        syncEntries();
+        auto indices = super::addTopologyParticles(topologyParticles);
+        if (_arraysEnabled) {
+            resizeArrays();
+            for (auto idx : indices) {
+                gatherEntry(idx);
+            }
+        }
+        return indices;
+    }
+
+    const std::vector<size_type> &update(DataUpdate &&update) override {
+        syncEntries();
+        const auto &result = super::update(std::move(update));
+        if (_arraysEnabled) gather();
+        return result;
+    }
+
+    void reorder(const Vec3 &gridWidth, bool hilbert) override {
+        syncEntries();
+        super::reorder(gridWidth, hilbert);
+        if (_arraysEnabled) gather();
+    }
+
+    void clear() override {
+        super::clear();
+        _pendingPositions = false;
+        _pendingForces = false;
+        if (_arraysEnabled) resizeArrays();
+    }
+
+    using super::removeParticle;
+
+    void removeParticle(size_type index) override {
+        super::removeParticle(index);
+        deactivate(index);
+    }
+
+    void removeEntry(size_type index) override {
+        super::removeEntry(index);
+        deactivate(index);
+    }
+
+    void displace(size_type index, const Particle::Position &delta) override {
+        syncEntryPositions();
+        super::displace(index, delta);
+        if (!_arraysEnabled) return;
+        const auto &pos = _entries[index].pos;
+        _x[index] = pos.x;
+        _y[index] = pos.y;
+        _z[index] = pos.z;
+    }
+
+    /**
+     * Copies positions, forces, types and the activity of all entries into the arrays, in parallel.
+     */
+    void gather() {
+        _arraysOutdated = false;
+        resizeArrays();
+        // each task works on whole mask blocks so that no two tasks write into the same block
+        forEachBlockRange([this](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                gatherEntry(i);
+            }
+        });
+    }
+
+    /**
+     * Writes the positions stored in the arrays back into the entries.
+     */
+    void scatterPositions() {
+        _pendingPositions = false;
+        forEachBlockRange([this](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                _entries[i].pos = {_x[i], _y[i], _z[i]};
+            }
+        });
+    }
+
+    /**
+     * Writes the forces stored in the arrays back into the entries.
+     */
+    void scatterForces() {
+        _pendingForces = false;
+        forEachBlockRange([this](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                _entries[i].force = {_fx[i], _fy[i], _fz[i]};
+            }
+        });
+    }
+
+    /**
+     * Marks the positions in the arrays as newer than the ones in the entries.
+     */
+    void arrayPositionsChanged() {
+        _pendingPositions = true;
+    }
+
+    /**
+     * Marks the forces in the arrays as newer than the ones in the entries.
+     */
+    void arrayForcesChanged() {
+        _pendingForces = true;
+    }
+
+    /**
+     * Writes positions and forces that were changed in the arrays back into the entries.
+     */
+    void syncEntries() {
+        syncEntryPositions();
+        if (_pendingForces) scatterForces();
+    }
+
+    /**
+     * Writes positions that were changed in the arrays back into the entries, e.g., before the neighbor list reads
+     * them.
+     */
+    void syncEntryPositions() {
+        if (_pendingPositions) scatterPositions();
+    }
+
+    /**
+     * Marks the arrays as outdated because the entries were handed out for writing.
+     */
+    void invalidateArrays() {
+        _arraysOutdated = _arraysEnabled;
+    }
+
+    /**
+     * Gathers the arrays if the entries may have been written since the last gather.
+     */
+    void syncArrays() {
+        if (_arraysOutdated) gather();
+    }
+
+    bool active(size_type index) const {
+        return (_active[index / maskBlockSize] >> (index % maskBlockSize)) & 1u;
+    }
+
+    const std::vector<mask_block> &activeMask() const {
+        return _active;
+    }
+
+    scalar *x() { return _x.data(); }
+    scalar *y() { return _y.data(); }
+    scalar *z() { return _z.data(); }
+    scalar *fx() { return _fx.data(); }
+    scalar *fy() { return _fy.data(); }
+    scalar *fz() { return _fz.data(); }
+    const scalar *x() const { return _x.data(); }
+    const scalar *y() const { return _y.data(); }
+    const scalar *z() const { return _z.data(); }
+    const scalar *fx() const { return _fx.data(); }
+    const scalar *fy() const { return _fy.data(); }
+    const scalar *fz() const { return _fz.data(); }
+
+    const ParticleTypeId *types() const {
+        return _types.data();
+    }
+
+private:
+    static std::size_t nMaskBlocks(std::size_t n) {
+        return (n + maskBlockSize - 1) / maskBlockSize;
+    }
+
+    void resizeArrays() {
+        const auto n = _entries.size();
+        for (auto *array : {&_x, &_y, &_z, &_fx, &_fy, &_fz}) {
+            array->resize(n);
+        }
+        _types.resize(n);
+        _active.resize(nMaskBlocks(n));
+    }
+
+    void deactivate(size_type i) {
+        // during an update entries can be removed before the arrays were resized to the new entries
+        if (_arraysEnabled && i / maskBlockSize < _active.size()) {
+            _active[i / maskBlockSize] &= ~(mask_block{1} << (i % maskBlockSize));
+        }
+    }
+
+    void gatherEntry(size_type i) {
+        const auto &entry = _entries[i];
+        _x[i] = entry.pos.x;
+        _y[i] = entry.pos.y;
+        _z[i] = entry.pos.z;
+        _fx[i] = entry.force.x;
+        _fy[i] = entry.force.y;
+        _fz[i] = entry.force.z;
+        _types[i] = entry.type;
+        const auto bit = mask_block{1} << (i % maskBlockSize);
+        auto &block = _active[i / maskBlockSize];
+        block = entry.deactivated ? block & ~bit : block | bit;
+    }
+
+    template<typename F>
+    void forEachBlockRange(const F &f) {
+        const auto n = _entries.size();
+        _pool.get().parallel_for(0, nMaskBlocks(n), [&f, n](std::size_t, std::size_t blockBegin, std::size_t blockEnd) {
+            f(blockBegin * maskBlockSize, std::min(blockEnd * maskBlockSize, n));
+        });
+    }
+
+    std::vector<scalar> _x {}, _y {}, _z {};
+    std::vector<scalar> _fx {}, _fy {}, _fz {};
+    std::vector<ParticleTypeId> _types {};
+    std::vector<mask_block> _active {};
+    bool _arraysEnabled {false};
+    bool _arraysOutdated {false};
+    bool _pendingPositions {false};
+    bool _pendingForces {false};
+};
+
+}
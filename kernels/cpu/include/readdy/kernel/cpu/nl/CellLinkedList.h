@@ -62,7 +62,14 @@ public:
     CellLinkedList(data_type &data, const readdy::model::Context &context,
                    thread_pool &pool);
 
-    void setUp(scalar cutoff, cell_radius_type radius);
+    /**
+     * Sets up the cell structure. The cell width is chosen such that all particles within a distance of
+     * cutoff + skin are found in the adjacent cells of the given radius.
+     * @param cutoff the interaction distance
+     * @param radius the cell radius
+     * @param skin additional distance used for Verlet lists
+     */
+    void setUp(scalar cutoff, cell_radius_type radius, scalar skin = 0);
 
     virtual void update() = 0;
 
@@ -131,12 +138,21 @@ public:
         return _cellIndex.size();
     };
 
+    scalar cutoff() const {
+        return _cutoff;
+    };
+
+    scalar skin() const {
+        return _skin;
+    };
+
 protected:
     virtual void setUpBins() = 0;
 
     bool _isSetUp{false};
 
     scalar _cutoff{0};
+    scalar _skin{0};
     std::uint8_t _radius;
 
     Vec3 _cellSize{0, 0, 0};
@@ -167,12 +183,18 @@ public:
     CompactCellLinkedList(data_type &data, const readdy::model::Context &context, thread_pool &pool);
 
     void update() override {
-        setUpBins();
+        if (!_verlet || verletListInvalid()) {
+            setUpBins();
+        }
     };
 
     void clear() override {
         _head.resize(0);
         _list.resize(0);
+        _verletList.clear();
+        _verletReferencePositions.clear();
+        _chunks.clear();
+        ++_binsVersion;
         _isSetUp = false;
     };
 
@@ -200,6 +222,51 @@ public:
         return _serial;
     };
 
+    /**
+     * Toggles the Verlet list mode. If enabled, each particle keeps a list of neighbors within cutoff + skin, which
+     * is only rebuilt once a particle has moved farther than skin / 2 or the particle set has changed.
+     * @return reference to the flag
+     */
+    bool &verlet() {
+        return _verlet;
+    };
+
+    const bool &verlet() const {
+        return _verlet;
+    };
+
+    /**
+     * Number of bin fills after which the particle data is reordered along a space filling curve of the cells, right
+     * before filling the bins. Zero disables the reordering.
+     * @return reference to the interval
+     */
+    std::size_t &reorderInterval() {
+        return _reorderInterval;
+    };
+
+    std::size_t reorderInterval() const {
+        return _reorderInterval;
+    };
+
+    /**
+     * Whether the reordering uses a Hilbert curve, otherwise a Morton curve.
+     * @return reference to the flag
+     */
+    bool &hilbertOrder() {
+        return _hilbertOrder;
+    };
+
+    bool hilbertOrder() const {
+        return _hilbertOrder;
+    };
+
+    /**
+     * @return the number of times the Verlet lists have been (re)built
+     */
+    std::size_t nVerletRebuilds() const {
+        return _nVerletRebuilds;
+    };
+
     template<typename Function>
     void forEachNeighbor(std::size_t particle, const Function &function) const {
         forEachNeighbor(particle, cellOfParticle(particle), function);
@@ -208,21 +275,63 @@ public:
     template<typename Function>
     void forEachNeighbor(std::size_t particle, std::size_t cell, const Function &function) const;
 
+    /**
+     * Half-shell variant of forEachNeighbor: when invoked for every particle of every cell, each unordered pair of
+     * neighboring particles is visited exactly once. Within the particle's own cell only neighbors with larger index
+     * are visited, of the adjacent cells only the ones with larger cell index.
+     * @param particle the particle
+     * @param cell the cell of the particle
+     * @param function the function that is called for each neighbor index
+     */
+    template<typename Function>
+    void forEachNeighborHalf(std::size_t particle, std::size_t cell, const Function &function) const;
+
     bool cellEmpty(std::size_t index) const {
         return (*_head.at(index)).load() == 0;
     };
+
+    /**
+     * Splits the cells into at most nChunks contiguous ranges of roughly equal estimated pair work, which can be
+     * scheduled dynamically over the thread pool. The cost of a cell is estimated as its number of particles times the
+     * number of particles in the cell and its adjacent cells. The split is cached until the bins are filled again.
+     * @param nChunks the requested number of chunks
+     * @return the chunk boundaries, starting at 0 and ending at nCells()
+     */
+    const std::vector<std::size_t> &costBalancedChunks(std::size_t nChunks) const;
 protected:
     void setUpBins() override;
 
     template<bool serial>
     void fillBins();
 
+    void fillVerletList();
+
+    bool verletListInvalid() const;
+
     HEAD _head;
     // particles, 1-indexed
     LIST _list;
 
     bool _serial{false};
 
+    bool _verlet{false};
+    // neighbors within cutoff + skin per particle index
+    std::vector<std::vector<std::size_t>> _verletList;
+    // positions at the time of the last Verlet list build
+    std::vector<Vec3> _verletReferencePositions;
+    // particle set version of the data container at the time of the last Verlet list build
+    std::size_t _verletDataVersion{0};
+    std::size_t _nVerletRebuilds{0};
+
+    std::size_t _reorderInterval{0};
+    std::size_t _nBinFillsSinceReorder{0};
+    bool _hilbertOrder{true};
+
+    // incremented whenever the bins are (re)filled, invalidates the cached chunks
+    std::size_t _binsVersion{0};
+    mutable std::size_t _chunksVersion{0};
+    mutable std::vector<std::size_t> _chunks;
+    mutable std::vector<std::size_t> _cellCostPrefix;
 };
 
 class BoxIterator {
@@ -304,6 +413,11 @@ inline BoxIterator CompactCellLinkedList::particlesEnd(std::size_t /*cellIndex*/
 template<typename Function>
 inline void CompactCellLinkedList::forEachNeighbor(std::size_t particle, std::size_t cell,
                                                    const Function &function) const {
+    if (_verlet) {
+        const auto &neighbors = _verletList[particle];
+        std::for_each(neighbors.begin(), neighbors.end(), function);
+        return;
+    }
     std::for_each(particlesBegin(cell), particlesEnd(cell), [&function, particle](auto x) {
         if (x != particle) function(x);
     });
@@ -312,6 +426,25 @@ inline void CompactCellLinkedList::forEachNeighbor(std::size_t particle, std::si
     }
 }
 
+template<typename Function>
+inline void CompactCellLinkedList::forEachNeighborHalf(std::size_t particle, std::size_t cell,
+                                                       const Function &function) const {
+    if (_verlet) {
+        for (const auto neighbor : _verletList[particle]) {
+            if (neighbor > particle) function(neighbor);
+        }
+        return;
+    }
+    std::for_each(particlesBegin(cell), particlesEnd(cell), [&function, particle](auto x) {
+        if (x > particle) function(x);
+    });
+    // adjacent cells are stored sorted, skip the ones with smaller cell index
+    for (auto itNeighCell = std::upper_bound(neighborsBegin(cell), neighborsEnd(cell), cell);
+         itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+        std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), function);
+    }
+}
+
 }
 }
 }
@@ -44,6 +44,7 @@
 
 #pragma once
 #include <readdy/model/observables/Observables.h>
+#include <readdy/kernel/cpu/nl/CellLinkedList.h>
 
 namespace readdy {
 namespace kernel {
@@ -122,6 +123,28 @@ protected:
     CPUKernel *const kernel;
 };
 
+/**
+ * Radial distribution function on a cell linked list of its own, the cutoff being the last bin border. The pairs are
+ * collected over cost balanced cell chunks into per-thread histograms. Only particles inside the simulation box are
+ * taken into account, as in all cell list based computations of this kernel.
+ */
+class CPURadialDistribution : public readdy::model::observables::RadialDistribution {
+public:
+    CPURadialDistribution(CPUKernel *kernel, Stride stride, const std::vector<scalar> &binBorders,
+                          const std::vector<std::string> &typeCountFrom, const std::vector<std::string> &typeCountTo,
+                          scalar particleToDensity);
+
+    void evaluate() override;
+
+protected:
+    CPUKernel *const kernel;
+    std::unique_ptr<nl::CompactCellLinkedList> cellList;
+    // bit 0: type is counted from, bit 1: type is counted to; indexed by type id
+    std::vector<std::uint8_t> typeMask;
+    // one histogram per thread, stored contiguously
+    std::vector<std::size_t> threadCounts;
+};
+
 class CPUReactions : public readdy::model::observables::Reactions {
 public:
     CPUReactions(CPUKernel* kernel, unsigned int stride);
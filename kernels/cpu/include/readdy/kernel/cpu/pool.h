@@ -45,13 +45,123 @@
 
 #pragma once
 
-#include <readdy/common/thread/ctpl.h>
+#include <chrono>
+#include <string>
+
+#include <readdy/common/Timer.h>
+#include <readdy/common/thread/fork_join.h>
 
 namespace readdy {
 namespace kernel {
 namespace cpu {
 
-using thread_pool = ctpl::thread_pool;
+/**
+ * The CPU kernel's thread pool, a persistent fork-join team on which the actions run their data parallel loops, see
+ * parallel_for and parallel_reduce.
+ */
+class thread_pool {
+public:
+    thread_pool() : thread_pool(1) {}
+
+    explicit thread_pool(int nThreads) : _team(static_cast<std::size_t>(std::max(nThreads, 1))) {}
+
+    /**
+     * Changes the team size, must not be called from within a parallel region.
+     */
+    void resize_wait(std::size_t n) {
+        _team.resize(n);
+    }
+
+    /**
+     * Invokes f(tid, begin, end) on a static partition of [begin, end) over the fork-join team.
+     */
+    template<typename F>
+    void parallel_for(std::size_t begin, std::size_t end, const F &f) {
+        _team.parallel_for(begin, end, f);
+    }
+
+    /**
+     * Static partition of [begin, end) over the fork-join team, the partial results of f(tid, begin, end) are
+     * combined with reduce in a deterministic order.
+     */
+    template<typename T, typename F, typename R>
+    T parallel_reduce(std::size_t begin, std::size_t end, T init, const F &f, const R &reduce) {
+        return _team.parallel_reduce(begin, end, std::move(init), f, reduce);
+    }
+
+    /**
+     * Dynamically scheduled loop over the chunks given by bounds (see fork_join::parallel_for_dynamic), meant for
+     * inhomogeneous work such as cost balanced cell ranges. If a timerName is given and util::Timer::measureDetailed()
+     * is set, the time each thread spent processing chunks is recorded in the performance data
+     * "<timerName>.thread<tid>" of util::Timer. Otherwise no time is taken and nothing is allocated.
+     */
+    template<typename F>
+    void parallel_for_balanced(const std::vector<std::size_t> &bounds, const F &f, const char *timerName = nullptr) {
+        if (timerName == nullptr || !util::Timer::measureDetailed()) {
+            _team.parallel_for_dynamic(bounds, f);
+        } else {
+            _busy.assign(teamSize(), {});
+            _team.parallel_for_dynamic(bounds, [this, &f](std::size_t tid, std::size_t begin, std::size_t end) {
+                const auto t0 = std::chrono::steady_clock::now();
+                f(tid, begin, end);
+                _busy[tid].seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            });
+            recordBusyTimes(timerName);
+        }
+    }
+
+    /**
+     * Dynamically scheduled reduction over the chunks given by bounds, the partial results are combined in chunk
+     * order (see fork_join::parallel_reduce_dynamic). Per-thread timings are recorded like in parallel_for_balanced.
+     */
+    template<typename T, typename F, typename R>
+    T parallel_reduce_balanced(const std::vector<std::size_t> &bounds, T init, const F &f, const R &reduce,
+                               const char *timerName = nullptr) {
+        if (timerName == nullptr || !util::Timer::measureDetailed()) {
+            return _team.parallel_reduce_dynamic(bounds, std::move(init), f, reduce);
+        }
+        _busy.assign(teamSize(), {});
+        auto result = _team.parallel_reduce_dynamic(
+                bounds, std::move(init), [this, &f](std::size_t tid, std::size_t begin, std::size_t end) {
+                    const auto t0 = std::chrono::steady_clock::now();
+                    auto partial = f(tid, begin, end);
+                    _busy[tid].seconds += std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - t0).count();
+                    return partial;
+                }, reduce);
+        recordBusyTimes(timerName);
+        return result;
+    }
+
+    /**
+     * The number of chunks per thread which balanced loops should aim for. More chunks give the dynamic scheduling
+     * more freedom to even out the load at the price of more synchronization on the shared chunk counter.
+     */
+    static constexpr std::size_t chunksPerThread = 4;
+
+    /**
+     * @return the size of the fork-join team, i.e., the maximal number of distinct tids in parallel regions
+     */
+    std::size_t teamSize() const {
+        return _team.size();
+    }
+
+private:
+    void recordBusyTimes(const char *timerName) {
+        for (std::size_t tid = 0; tid < _busy.size(); ++tid) {
+            util::Timer::performanceData(std::string(timerName) + ".thread" + std::to_string(tid))
+                    .record(_busy[tid].seconds);
+        }
+    }
+
+    // padded to a cache line so that threads do not write into the same line
+    struct alignas(64) BusyTime {
+        double seconds {0};
+    };
+
+    util::thread::fork_join _team;
+    std::vector<BusyTime> _busy;
+};
 
 }
 }
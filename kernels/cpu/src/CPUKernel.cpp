@@ -58,7 +58,8 @@ readdy::model::Kernel *CPUKernel::create() {
 CPUKernel::CPUKernel() : readdy::model::Kernel(name), _pool(readdy_default_n_threads()),
                          _data(_context, _pool), _actions(this),
                          _observables(this), _topologyActionFactory(_context, _data),
-                         _stateModel(_data, _context, _pool, &_topologyActionFactory) {}
+                         _stateModel(_data, _context, _pool, &_topologyActionFactory),
+                         _seed(readdy::model::rnd::randomlySeededGenerator<std::mt19937_64>()()) {}
 
 void CPUKernel::initialize() {
     readdy::model::Kernel::initialize();
@@ -68,6 +69,12 @@ void CPUKernel::initialize() {
     const auto &configuration = fullConfiguration.cpu;
     // thread config
     setNThreads(static_cast<std::uint32_t>(configuration.threadConfig.getNThreads()));
+    if (configuration.seed != 0) {
+        // the serial parts draw from the calling thread's generator, seed it as well
+        _seed = configuration.seed;
+        readdy::model::rnd::seedThreadGenerator(_seed);
+    }
+    _randomEpoch = 0;
     {
         // state model config
         _stateModel.configure(configuration);
@@ -80,6 +87,7 @@ void CPUKernel::initialize() {
     _stateModel.resetReactionCounts();
     _stateModel.resetTopologyReactionCounts();
     _stateModel.virial() = Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+    _interactions = InteractionSnapshot(context());
 }
 
 }
@@ -44,6 +44,7 @@
 
 
 #include <future>
+#include <numeric>
 #include <readdy/kernel/cpu/CPUStateModel.h>
 
 namespace readdy::kernel::cpu {
@@ -77,9 +78,46 @@ std::vector<readdy::model::Particle> CPUStateModel::getParticles() const {
     return result;
 }
 
-CPUStateModel::CPUStateModel(data_type &data, const readdy::model::Context &context, thread_pool &pool,
+void CPUStateModel::trajectorySnapshot(const std::vector<readdy::model::ParticleFlavor> &flavors,
+                                       std::vector<readdy::model::observables::TrajectoryEntry> &entries) const {
+    const auto &data = *getParticleData();
+    auto &pool = _pool.get();
+    // both passes use the same static partition, the active entries of thread tid go to [offsets[tid], offsets[tid+1])
+    std::vector<std::size_t> offsets(pool.teamSize() + 1, 0);
+    pool.parallel_for(0, data.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+        std::size_t nActive = 0;
+        for (auto i = begin; i < end; ++i) {
+            if (!data.entry_at(i).deactivated) ++nActive;
+        }
+        offsets[tid + 1] = nActive;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    entries.resize(offsets.back());
+    pool.parallel_for(0, data.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+        auto out = offsets[tid];
+        for (auto i = begin; i < end; ++i) {
+            const auto &entry = data.entry_at(i);
+            if (!entry.deactivated) {
+                auto &target = entries[out++];
+                target.typeId = entry.type;
+                target.id = entry.id;
+                target.flavor = flavors[entry.type];
+                target.pos = entry.pos;
+            }
+        }
+    });
+}
+
+CPUStateModel::CPUStateModel(soa_data_type &data, const readdy::model::Context &context, thread_pool &pool,
                              readdy::model::top::TopologyActionFactory const *const taf)
-        : _pool(pool), _context(context), _topologyActionFactory(*taf), _data(data) {
+        : _pool(pool), _context(context), _topologyActionFactory(*taf), _data(data),
+          _reorderConnection(data.reorderSignal().connect([this](const std::vector<std::size_t> &oldToNew) {
+              for (auto &top : _topologies) {
+                  if (!top->isDeactivated()) {
+                      top->remapParticleIndices(oldToNew);
+                  }
+              }
+          })) {
     _neighborList = std::make_unique<neighbor_list>(_data.get(), _context.get(), _pool.get());
 }
 
@@ -143,18 +181,9 @@ void CPUStateModel::resetReactionCounts() {
     }
 }
 
-void CPUStateModel::toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                           std::vector<std::size_t>::iterator end) const {
+readdy::model::DenseParticleIndices CPUStateModel::denseParticleIndices() const {
     const auto &blanks = _data.get().blanks();
-    std::transform(begin, end, begin, [&blanks](const std::size_t &ix) {
-        auto result = ix;
-        for(auto blankIx : blanks) {
-            if(blankIx < ix) {
-                --result;
-            }
-        }
-        return result;
-    });
+    return {blanks.begin(), blanks.end()};
 }
 
 void CPUStateModel::clear() {
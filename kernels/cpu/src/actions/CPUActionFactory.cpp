@@ -47,6 +47,7 @@
 #include <readdy/kernel/cpu/actions/CPUEvaluateCompartments.h>
 #include <readdy/kernel/cpu/actions/reactions/CPUGillespie.h>
 #include <readdy/kernel/cpu/actions/reactions/CPUUncontrolledApproximation.h>
+#include <readdy/kernel/cpu/actions/reactions/CPUDetailedBalance.h>
 #include <readdy/kernel/cpu/actions/CPUEvaluateTopologyReactions.h>
 #include <readdy/kernel/cpu/actions/CPUBreakBonds.h>
 #include <readdy/kernel/cpu/actions/CPUMiscActions.h>
@@ -110,7 +111,7 @@ CPUActionFactory::evaluateTopologyReactions(scalar timeStep) const {
 
 std::unique_ptr<model::actions::reactions::DetailedBalance>
 CPUActionFactory::detailedBalance(scalar timeStep) const {
-    throw std::invalid_argument("DetailedBalance reaction handler not implemented for CPU");
+    return {std::make_unique<reactions::CPUDetailedBalance>(kernel, timeStep)};
 }
 
 std::unique_ptr<model::actions::top::BreakBonds>
@@ -40,6 +40,7 @@
  */
 
 #include "readdy/kernel/cpu/actions/CPUCalculateForces.h"
+#include <algorithm>
 
 namespace readdy::kernel::cpu::actions {
 
@@ -48,6 +49,10 @@ void CPUCalculateForces::perform() {
     const auto &ctx = kernel->context();
 
     auto &stateModel = kernel->getCPUKernelStateModel();
+    if (auto soa = stateModel.getSoAParticleData()) {
+        performOnArrays(*soa);
+        return;
+    }
     auto neighborList = stateModel.getNeighborList();
     auto data = stateModel.getParticleData();
     auto taf = kernel->getTopologyActionFactory();
@@ -56,170 +61,143 @@ void CPUCalculateForces::perform() {
     stateModel.energy() = 0;
     stateModel.virial() = Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
 
-    const auto &potOrder1 = ctx.potentials().potentialsOrder1();
-    const auto &potOrder2 = ctx.potentials().potentialsOrder2();
-    if (!potOrder1.empty() || !potOrder2.empty() || !stateModel.topologies().empty()) {
-        {
-            // todo maybe optimize this by transposing data structure
-            std::for_each(data->begin(), data->end(), [](auto &entry) {
-                entry.force = {0, 0, 0};
-            });
+    const auto &interactions = kernel->interactions();
+    const auto hasPotOrder1 = interactions.hasPotentialsOrder1();
+    const auto hasPotOrder2 = !interactions.pairPotentials().empty();
+    if (hasPotOrder1 || hasPotOrder2 || !topologies.empty()) {
+        auto &pool = data->pool();
+        const auto nParticles = data->size();
+        const auto sum = [](scalar lhs, scalar rhs) { return lhs + rhs; };
+
+        pool.parallel_for(0, nParticles, [data](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto it = data->begin() + begin; it != data->begin() + end; ++it) {
+                it->force = {0, 0, 0};
+            }
+        });
+        if (hasPotOrder1) {
+            stateModel.energy() += pool.parallel_reduce(
+                    0, nParticles, static_cast<scalar>(0), [&](std::size_t, std::size_t begin, std::size_t end) {
+                        return calculateOrder1(begin, end, data, interactions);
+                    }, sum);
         }
-        {
-            auto &pool = data->pool();
-            std::vector<std::promise<scalar>> promises;
-            std::vector<std::promise<Matrix33>> virialPromises;
-            // 1st order pot + topologies = 2*pool size
-            // 2nd order pot <= nl.nCells
-            size_t nThreads = pool.size();
-            auto numberTasks = (!potOrder1.empty() ? nThreads : 0)
-                               + (!potOrder2.empty() ? nThreads : 0)
-                               + (!topologies.empty() ? nThreads : 0);
-            {
-                size_t nCells = neighborList->nCells();
-                promises.reserve(numberTasks);
-                virialPromises.reserve(!potOrder2.empty() ? nThreads : 0);
-                if (!potOrder1.empty()) {
-                    // 1st order pot
-                    std::vector<std::function<void(std::size_t)>> tasks;
-                    tasks.reserve(nThreads);
-
-                    const std::size_t grainSize = data->size() / nThreads;
-                    auto it = data->begin();
-                    for (auto i = 0_z; i < nThreads - 1; ++i) {
-                        auto itNext = std::min(it + grainSize, data->end());
-                        if (it != itNext) {
-                            promises.emplace_back();
-                            auto dataBounds = std::make_tuple(it, itNext);
-                            tasks.push_back(pool.pack(calculateOrder1, dataBounds, std::ref(promises.back()), data,
-                                                      ctx.potentials().potentialsOrder1()));
-                        }
-                        it = itNext;
-                    }
-                    if (it != data->end()) {
-                        promises.emplace_back();
-                        auto dataBounds = std::make_tuple(it, data->end());
-                        tasks.push_back(pool.pack(calculateOrder1, dataBounds, std::ref(promises.back()), data,
-                                                  ctx.potentials().potentialsOrder1()));
-                    }
-                    {
-                        auto futures = pool.pushAll(std::move(tasks));
-                        std::vector<util::thread::joining_future<void>> joiningFutures;
-                        std::transform(futures.begin(), futures.end(), std::back_inserter(joiningFutures),
-                                       [](auto &&future) {
-                                           return util::thread::joining_future<void>{std::move(future)};
-                                       });
-                    }
-                }
-                if (!topologies.empty()) {
-                    std::vector<std::function<void(std::size_t)>> tasks;
-                    tasks.reserve(nThreads);
-                    const std::size_t grainSize = topologies.size() / nThreads;
-                    auto it = topologies.cbegin();
-                    for (auto i = 0_z; i < nThreads - 1; ++i) {
-                        auto itNext = std::min(it + grainSize, topologies.cend());
-                        if (it != itNext) {
-                            promises.emplace_back();
-                            auto bounds = std::make_tuple(it, itNext);
-                            tasks.push_back(
-                                    pool.pack(calculateTopologies, bounds, taf, std::ref(promises.back())));
-                        }
-                        it = itNext;
-                    }
-                    if (it != topologies.cend()) {
-                        promises.emplace_back();
-                        auto bounds = std::make_tuple(it, topologies.cend());
-                        tasks.push_back(pool.pack(calculateTopologies, bounds, taf, std::ref(promises.back())));
-                    }
-                    {
-                        auto futures = pool.pushAll(std::move(tasks));
-                        std::vector<util::thread::joining_future<void>> joiningFutures;
-                        std::transform(futures.begin(), futures.end(), std::back_inserter(joiningFutures),
-                                       [](auto &&future) {
-                                           return util::thread::joining_future<void>{std::move(future)};
-                                       });
-                    }
-                }
-                if (!potOrder2.empty()) {
-                    std::vector<std::function<void(std::size_t)>> tasks;
-                    tasks.reserve(nThreads);
-                    auto granularity = nThreads;
-                    const std::size_t grainSize = nCells / granularity;
-                    auto it = 0_z;
-                    for (auto i = 0_z; i < granularity - 1; ++i) {
-                        auto itNext = std::min(it + grainSize, nCells);
-                        if (it != itNext) {
-                            promises.emplace_back();
-                            virialPromises.emplace_back();
-                            if(ctx.recordVirial()) {
-                                tasks.push_back(pool.pack(
-                                        calculateOrder2<true>, std::make_tuple(it, itNext), data,
-                                        std::cref(*neighborList), std::ref(promises.back()),
-                                        std::ref(virialPromises.back()), ctx.potentials().potentialsOrder2(),
-                                        ctx.boxSize(), ctx.periodicBoundaryConditions()
-                                ));
-                            } else {
-                                tasks.push_back(pool.pack(
-                                        calculateOrder2<false>, std::make_tuple(it, itNext), data,
-                                        std::cref(*neighborList), std::ref(promises.back()),
-                                        std::ref(virialPromises.back()), ctx.potentials().potentialsOrder2(),
-                                        ctx.boxSize(), ctx.periodicBoundaryConditions()
-                                ));
-                            }
+        if (!topologies.empty()) {
+            stateModel.energy() += pool.parallel_reduce(
+                    0, topologies.size(), static_cast<scalar>(0), [&](std::size_t, std::size_t begin, std::size_t end) {
+                        return calculateTopologies(std::make_tuple(topologies.cbegin() + begin,
+                                                                   topologies.cbegin() + end), taf);
+                    }, sum);
+        }
+        if (hasPotOrder2) {
+            const auto &pot2 = interactions.pairPotentials();
+            const auto &box = ctx.boxSize();
+            const auto &pbc = ctx.periodicBoundaryConditions();
+            prepareForceBuffers(nParticles, neighborList->nCells(), pool.teamSize());
+
+            using result_type = std::tuple<scalar, Matrix33>;
+            const result_type zero {0, Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}}};
+            // the cells are split into ranges of similar pair work which are handed out dynamically
+            const auto &chunks = neighborList->costBalancedChunks(thread_pool::chunksPerThread * pool.teamSize());
+            auto [energy, virial] = pool.parallel_reduce_balanced(
+                    chunks, zero, [&](std::size_t tid, std::size_t begin, std::size_t end) {
+                        std::fill(_cellOwner.begin() + begin, _cellOwner.begin() + end, tid);
+                        auto bounds = std::make_tuple(begin, end);
+                        if (ctx.recordVirial()) {
+                            return calculateOrder2<true>(bounds, data, *neighborList, _forceBuffers[tid], pot2,
+                                                         box, pbc);
                         }
-                        it = itNext;
-                    }
-                    if (it != nCells) {
-                        promises.emplace_back();
-                        virialPromises.emplace_back();
-                        if(ctx.recordVirial()) {
-                            tasks.push_back(pool.pack(
-                                    calculateOrder2<true>, std::make_tuple(it, nCells), data, std::cref(*neighborList),
-                                    std::ref(promises.back()), std::ref(virialPromises.back()),
-                                    ctx.potentials().potentialsOrder2(), ctx.boxSize(), ctx.periodicBoundaryConditions()
-                            ));
-                        } else {
-                            tasks.push_back(pool.pack(
-                                    calculateOrder2<false>, std::make_tuple(it, nCells), data, std::cref(*neighborList),
-                                    std::ref(promises.back()), std::ref(virialPromises.back()),
-                                    ctx.potentials().potentialsOrder2(), ctx.boxSize(), ctx.periodicBoundaryConditions()
-                            ));
+                        return calculateOrder2<false>(bounds, data, *neighborList, _forceBuffers[tid], pot2,
+                                                      box, pbc);
+                    }, [](result_type lhs, const result_type &rhs) {
+                        return result_type{std::get<0>(lhs) + std::get<0>(rhs), std::get<1>(lhs) + std::get<1>(rhs)};
+                    }, "CPUCalculateForces::order2");
+            stateModel.energy() += energy;
+            stateModel.virial() += virial;
+
+            // add the counterpart forces collected by the threads
+            pool.parallel_for(0, neighborList->nCells(), [&](std::size_t, std::size_t begin, std::size_t end) {
+                reduceForceBuffers(std::make_tuple(begin, end), data, *neighborList, _cellOwner, _forceBuffers);
+            });
+            _forceBuffersClean = true;
+        }
+    }
+}
+
+void CPUCalculateForces::performOnArrays(CPUStateModel::soa_data_type &data) {
+    const auto &ctx = kernel->context();
+
+    auto &stateModel = kernel->getCPUKernelStateModel();
+    auto neighborList = stateModel.getNeighborList();
+    auto taf = kernel->getTopologyActionFactory();
+    auto &topologies = stateModel.topologies();
+
+    stateModel.energy() = 0;
+    stateModel.virial() = Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+
+    const auto &interactions = kernel->interactions();
+    const auto hasPotOrder1 = interactions.hasPotentialsOrder1();
+    const auto hasPotOrder2 = !interactions.pairPotentials().empty();
+    if (hasPotOrder1 || hasPotOrder2 || !topologies.empty()) {
+        auto &pool = data.pool();
+        const auto nParticles = data.size();
+        const auto sum = [](scalar lhs, scalar rhs) { return lhs + rhs; };
+
+        // resetting the forces and applying the first order potentials is a single pass over the arrays
+        stateModel.energy() += pool.parallel_reduce(
+                0, nParticles, static_cast<scalar>(0), [&](std::size_t, std::size_t begin, std::size_t end) {
+                    return calculateOrder1OnArrays(begin, end, data, interactions);
+                }, sum);
+        if (!topologies.empty()) {
+            stateModel.energy() += pool.parallel_reduce(
+                    0, topologies.size(), static_cast<scalar>(0), [&](std::size_t, std::size_t begin, std::size_t end) {
+                        return calculateTopologiesOnArrays(std::make_tuple(topologies.cbegin() + begin,
+                                                                           topologies.cbegin() + end), data, taf);
+                    }, sum);
+        }
+        if (hasPotOrder2) {
+            const auto &pot2 = interactions.pairPotentials();
+            const auto &box = ctx.boxSize();
+            const auto &pbc = ctx.periodicBoundaryConditions();
+            prepareForceBuffers(nParticles, neighborList->nCells(), pool.teamSize());
+
+            using result_type = std::tuple<scalar, Matrix33>;
+            const result_type zero {0, Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}}};
+            const auto &chunks = neighborList->costBalancedChunks(thread_pool::chunksPerThread * pool.teamSize());
+            auto [energy, virial] = pool.parallel_reduce_balanced(
+                    chunks, zero, [&](std::size_t tid, std::size_t begin, std::size_t end) {
+                        std::fill(_cellOwner.begin() + begin, _cellOwner.begin() + end, tid);
+                        auto bounds = std::make_tuple(begin, end);
+                        if (ctx.recordVirial()) {
+                            return calculateOrder2OnArrays<true>(bounds, data, *neighborList, _forceBuffers[tid],
+                                                                 pot2, box, pbc);
                         }
-                    }
-                    {
-                        auto futures = pool.pushAll(std::move(tasks));
-                        std::vector<util::thread::joining_future<void>> joiningFutures;
-                        std::transform(futures.begin(), futures.end(), std::back_inserter(joiningFutures),
-                                       [](auto &&future) {
-                                           return util::thread::joining_future<void>{std::move(future)};
-                                       });
-                    }
-                }
-            }
+                        return calculateOrder2OnArrays<false>(bounds, data, *neighborList, _forceBuffers[tid],
+                                                              pot2, box, pbc);
+                    }, [](result_type lhs, const result_type &rhs) {
+                        return result_type{std::get<0>(lhs) + std::get<0>(rhs), std::get<1>(lhs) + std::get<1>(rhs)};
+                    }, "CPUCalculateForces::order2");
+            stateModel.energy() += energy;
+            stateModel.virial() += virial;
 
-            {
-                for (auto &f : promises) {
-                    stateModel.energy() += f.get_future().get();
-                }
-            }
-            {
-                for (auto &f : virialPromises) {
-                    stateModel.virial() += f.get_future().get();
-                }
-            }
+            pool.parallel_for(0, neighborList->nCells(), [&](std::size_t, std::size_t begin, std::size_t end) {
+                reduceForceBuffers(std::make_tuple(begin, end), data, *neighborList, _cellOwner, _forceBuffers);
+            });
+            _forceBuffersClean = true;
         }
+        // the entries are updated once somebody reads them
+        data.arrayForcesChanged();
     }
 }
 
 template<bool COMPUTE_VIRIAL>
-void CPUCalculateForces::calculateOrder2(std::size_t, nl_bounds nlBounds,
-                                         CPUStateModel::data_type *data, const CPUStateModel::neighbor_list &nl,
-                                         std::promise<scalar> &energyPromise, std::promise<Matrix33> &virialPromise,
-                                         model::potentials::PotentialRegistry::PotentialsO2Map pot2,
-                                         model::Context::BoxSize box, model::Context::PeriodicBoundaryConditions pbc) {
+std::tuple<scalar, Matrix33> CPUCalculateForces::calculateOrder2(
+        nl_bounds nlBounds, CPUStateModel::data_type *data, const CPUStateModel::neighbor_list &nl,
+        std::vector<Vec3> &forceBuffer, const model::potentials::PairPotentialTable &pot2,
+        const model::Context::BoxSize &box, const model::Context::PeriodicBoundaryConditions &pbc) {
     scalar energyUpdate = 0.0;
     Matrix33 virialUpdate{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
 
+    PairBatch<> batch (pot2, box, pbc);
+
     for (auto cell = std::get<0>(nlBounds); cell < std::get<1>(nlBounds); ++cell) {
         for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
             auto &entry = data->entry_at(*particleIt);
@@ -228,48 +206,147 @@ void CPUCalculateForces::calculateOrder2(std::size_t, nl_bounds nlBounds,
                 continue;
             }
 
-            nl.forEachNeighbor(*particleIt, cell, [&](auto neighborIndex) {
-                auto &neighbor = data->entry_at(neighborIndex);
+            nl.forEachNeighborHalf(*particleIt, cell, [&](auto neighborIndex) {
+                const auto &neighbor = data->entry_at(neighborIndex);
                 if (!neighbor.deactivated) {
-                    auto &force = entry.force;
-                    const auto &myPos = entry.pos;
-
-                    scalar mySecondOrderEnergy = 0.;
-                    auto potit = pot2.find(std::tie(entry.type, neighbor.type));
-                    if (potit != pot2.end()) {
-                        auto x_ij = bcs::shortestDifference(myPos, neighbor.pos, box.data(), pbc.data());
-                        auto distSquared = x_ij * x_ij;
-                        for (const auto &potential : potit->second) {
-                            if (distSquared < potential->getCutoffRadiusSquared()) {
-                                Vec3 forceUpdate{0, 0, 0};
-                                potential->calculateForceAndEnergy(forceUpdate, mySecondOrderEnergy, x_ij);
-                                force += forceUpdate;
-                                if(COMPUTE_VIRIAL && *particleIt < neighborIndex) {
-                                    virialUpdate += math::outerProduct<Matrix33>(-1.*x_ij, forceUpdate);
-                                }
-                            }
-                        }
+                    if (pot2(entry.type, neighbor.type).empty()) return;
+                    if (batch.add(neighborIndex, neighbor.pos, neighbor.type)) {
+                        batch.template evaluate<COMPUTE_VIRIAL>(entry.pos, entry.type, entry.force, forceBuffer,
+                                                                energyUpdate, virialUpdate);
                     }
+                } else {
+                    log::critical("disabled neighbour");
+                }
+            });
+            if (!batch.empty()) {
+                batch.template evaluate<COMPUTE_VIRIAL>(entry.pos, entry.type, entry.force, forceBuffer,
+                                                        energyUpdate, virialUpdate);
+            }
+        }
 
-                    // The contribution of second order potentials must be halved since we parallelize over particles.
-                    // Thus every particle pair potential is seen twice
-                    energyUpdate += 0.5 * mySecondOrderEnergy;
+    }
+
+    return std::make_tuple(energyUpdate, virialUpdate);
+}
+
+template<bool COMPUTE_VIRIAL>
+std::tuple<scalar, Matrix33> CPUCalculateForces::calculateOrder2OnArrays(
+        nl_bounds nlBounds, CPUStateModel::soa_data_type &data, const CPUStateModel::neighbor_list &nl,
+        std::vector<Vec3> &forceBuffer, const model::potentials::PairPotentialTable &pot2,
+        const model::Context::BoxSize &box, const model::Context::PeriodicBoundaryConditions &pbc) {
+    scalar energyUpdate = 0.0;
+    Matrix33 virialUpdate{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+
+    PairBatch<> batch (pot2, box, pbc);
+
+    const auto *x = data.x(), *y = data.y(), *z = data.z();
+    auto *fx = data.fx(), *fy = data.fy(), *fz = data.fz();
+    const auto *types = data.types();
+
+    for (auto cell = std::get<0>(nlBounds); cell < std::get<1>(nlBounds); ++cell) {
+        for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
+            const auto i = *particleIt;
+            if (!data.active(i)) {
+                log::critical("deactivated particle in neighbor list!");
+                continue;
+            }
+            const Vec3 pos {x[i], y[i], z[i]};
+            const auto type = types[i];
+            Vec3 force {fx[i], fy[i], fz[i]};
+
+            nl.forEachNeighborHalf(i, cell, [&](auto neighborIndex) {
+                if (data.active(neighborIndex)) {
+                    const auto neighborType = types[neighborIndex];
+                    if (pot2(type, neighborType).empty()) return;
+                    if (batch.add(neighborIndex, {x[neighborIndex], y[neighborIndex], z[neighborIndex]},
+                                  neighborType)) {
+                        batch.template evaluate<COMPUTE_VIRIAL>(pos, type, force, forceBuffer, energyUpdate,
+                                                                virialUpdate);
+                    }
                 } else {
                     log::critical("disabled neighbour");
                 }
             });
+            if (!batch.empty()) {
+                batch.template evaluate<COMPUTE_VIRIAL>(pos, type, force, forceBuffer, energyUpdate, virialUpdate);
+            }
+            fx[i] = force.x;
+            fy[i] = force.y;
+            fz[i] = force.z;
         }
+    }
 
+    return std::make_tuple(energyUpdate, virialUpdate);
+}
+
+void CPUCalculateForces::prepareForceBuffers(std::size_t nParticles, std::size_t nCells, std::size_t nThreads) {
+    _forceBuffers.resize(nThreads);
+    for (auto &buffer : _forceBuffers) {
+        // the reduction zeroes what it consumed, so clean buffers only need to be grown
+        if (_forceBuffersClean) {
+            buffer.resize(nParticles);
+        } else {
+            buffer.assign(nParticles, {0, 0, 0});
+        }
     }
+    // cleared again once the reduction went through
+    _forceBuffersClean = false;
+    _cellOwner.resize(nCells);
+}
 
-    energyPromise.set_value(energyUpdate);
-    virialPromise.set_value(virialUpdate);
+void CPUCalculateForces::cellWriters(std::size_t cell, const CPUStateModel::neighbor_list &nl,
+                                     const std::vector<std::size_t> &cellOwner, std::vector<std::size_t> &writers) {
+    writers.assign(1, cellOwner[cell]);
+    for (auto it = nl.neighborsBegin(cell); it != nl.neighborsEnd(cell); ++it) {
+        const auto owner = cellOwner[*it];
+        if (std::find(writers.begin(), writers.end(), owner) == writers.end()) {
+            writers.push_back(owner);
+        }
+    }
+}
 
+void CPUCalculateForces::reduceForceBuffers(nl_bounds cells, CPUStateModel::soa_data_type &data,
+                                            const CPUStateModel::neighbor_list &nl,
+                                            const std::vector<std::size_t> &cellOwner,
+                                            std::vector<std::vector<Vec3>> &forceBuffers) {
+    auto *fx = data.fx(), *fy = data.fy(), *fz = data.fz();
+    std::vector<std::size_t> writers;
+    for (auto cell = std::get<0>(cells); cell < std::get<1>(cells); ++cell) {
+        if (nl.cellEmpty(cell)) continue;
+        cellWriters(cell, nl, cellOwner, writers);
+        for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
+            const auto i = *particleIt;
+            for (const auto t : writers) {
+                auto &buffered = forceBuffers[t][i];
+                fx[i] += buffered.x;
+                fy[i] += buffered.y;
+                fz[i] += buffered.z;
+                buffered = {0, 0, 0};
+            }
+        }
+    }
 }
 
-void CPUCalculateForces::calculateTopologies(std::size_t, top_bounds topBounds,
-                                             model::top::TopologyActionFactory *taf,
-                                             std::promise<scalar> &energyPromise) {
+void CPUCalculateForces::reduceForceBuffers(nl_bounds cells, CPUStateModel::data_type *data,
+                                            const CPUStateModel::neighbor_list &nl,
+                                            const std::vector<std::size_t> &cellOwner,
+                                            std::vector<std::vector<Vec3>> &forceBuffers) {
+    std::vector<std::size_t> writers;
+    for (auto cell = std::get<0>(cells); cell < std::get<1>(cells); ++cell) {
+        if (nl.cellEmpty(cell)) continue;
+        cellWriters(cell, nl, cellOwner, writers);
+        for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
+            auto &force = data->entry_at(*particleIt).force;
+            for (const auto t : writers) {
+                auto &buffered = forceBuffers[t][*particleIt];
+                force += buffered;
+                buffered = {0, 0, 0};
+            }
+        }
+    }
+}
+
+scalar CPUCalculateForces::calculateTopologies(top_bounds topBounds, model::top::TopologyActionFactory *taf) {
     scalar energyUpdate = 0.0;
     for (auto it = std::get<0>(topBounds); it != std::get<1>(topBounds); ++it) {
         const auto &top = *it;
@@ -289,28 +366,77 @@ void CPUCalculateForces::calculateTopologies(std::size_t, top_bounds topBounds,
         }
     }
 
-    energyPromise.set_value(energyUpdate);
+    return energyUpdate;
 }
 
-void CPUCalculateForces::calculateOrder1(std::size_t, data_bounds dataBounds,
-                                         std::promise<scalar> &energyPromise, CPUStateModel::data_type *data,
-                                         model::potentials::PotentialRegistry::PotentialsO1Map pot1) {
+scalar CPUCalculateForces::calculateOrder1(std::size_t begin, std::size_t end, CPUStateModel::data_type *data,
+                                           const InteractionSnapshot &interactions) {
     scalar energyUpdate = 0.0;
 
-    for (auto it = std::get<0>(dataBounds); it != std::get<1>(dataBounds); ++it) {
+    for (auto it = data->begin() + begin; it != data->begin() + end; ++it) {
         auto &entry = *it;
         if (!entry.deactivated) {
             auto &force = entry.force;
-            force = {0., 0., 0.};
             const auto &myPos = entry.pos;
-            auto find_it = pot1.find(entry.type);
-            if (find_it != pot1.end()) {
-                for (const auto &potential : find_it->second) {
-                    potential->calculateForceAndEnergy(force, energyUpdate, myPos);
-                }
+            for (const auto *potential : interactions.potentialsOrder1(entry.type)) {
+                potential->calculateForceAndEnergy(force, energyUpdate, myPos);
+            }
+        }
+    }
+    return energyUpdate;
+}
+
+scalar CPUCalculateForces::calculateOrder1OnArrays(std::size_t begin, std::size_t end,
+                                                   CPUStateModel::soa_data_type &data,
+                                                   const InteractionSnapshot &interactions) {
+    scalar energyUpdate = 0.0;
+
+    const auto *x = data.x(), *y = data.y(), *z = data.z();
+    auto *fx = data.fx(), *fy = data.fy(), *fz = data.fz();
+    const auto *types = data.types();
+    for (auto i = begin; i < end; ++i) {
+        Vec3 force {0, 0, 0};
+        if (data.active(i)) {
+            const Vec3 pos {x[i], y[i], z[i]};
+            for (const auto *potential : interactions.potentialsOrder1(types[i])) {
+                potential->calculateForceAndEnergy(force, energyUpdate, pos);
+            }
+        }
+        fx[i] = force.x;
+        fy[i] = force.y;
+        fz[i] = force.z;
+    }
+    return energyUpdate;
+}
+
+scalar CPUCalculateForces::calculateTopologiesOnArrays(top_bounds topBounds, CPUStateModel::soa_data_type &data,
+                                                       model::top::TopologyActionFactory *taf) {
+    // the topology potentials operate on the entries, so only the entries of the particles of the topologies are
+    // brought up to date and their forces are copied back afterwards
+    auto *x = data.x(), *y = data.y(), *z = data.z();
+    auto *fx = data.fx(), *fy = data.fy(), *fz = data.fz();
+    for (auto it = std::get<0>(topBounds); it != std::get<1>(topBounds); ++it) {
+        if ((*it)->isDeactivated()) continue;
+        for (const auto &v : (*it)->graph().vertices()) {
+            if (!v.deactivated()) {
+                auto &entry = data.entry_at(v->particleIndex);
+                entry.pos = {x[v->particleIndex], y[v->particleIndex], z[v->particleIndex]};
+                entry.force = {fx[v->particleIndex], fy[v->particleIndex], fz[v->particleIndex]};
+            }
+        }
+    }
+    const auto energyUpdate = calculateTopologies(topBounds, taf);
+    for (auto it = std::get<0>(topBounds); it != std::get<1>(topBounds); ++it) {
+        if ((*it)->isDeactivated()) continue;
+        for (const auto &v : (*it)->graph().vertices()) {
+            if (!v.deactivated()) {
+                const auto &force = data.entry_at(v->particleIndex).force;
+                fx[v->particleIndex] = force.x;
+                fy[v->particleIndex] = force.y;
+                fz[v->particleIndex] = force.z;
             }
         }
     }
-    energyPromise.set_value(energyUpdate);
+    return energyUpdate;
 }
 }
@@ -42,6 +42,8 @@
  * @date 07.07.16
  */
 
+#include <array>
+
 #include <readdy/kernel/cpu/actions/CPUEulerBDIntegrator.h>
 
 namespace readdy {
@@ -52,55 +54,107 @@ namespace actions {
 namespace rnd = readdy::model::rnd;
 
 void CPUEulerBDIntegrator::perform() {
+    if (auto soa = kernel->getCPUKernelStateModel().getSoAParticleData()) {
+        performOnArrays(*soa);
+        return;
+    }
     auto data = kernel->getCPUKernelStateModel().getParticleData();
     const auto size = data->size();
 
     const auto &context = kernel->context();
-    using iter_t = data::EntryDataContainer::iterator;
 
     const auto dt = timeStep();
 
-    auto worker = [&context, data, dt](std::size_t, std::size_t beginIdx, iter_t entry_begin, iter_t entry_end)  {
+    // the noise of each particle is drawn from a counter-based stream keyed by its index, so that it does not depend on
+    // the number of threads
+    const auto epoch = kernel->nextRandomEpoch();
+    const auto seed = kernel->seed();
+
+    // besides moving the particles, each chunk reports its largest squared drift speed for adaptive time stepping
+    auto &pool = kernel->pool();
+    const auto maxDriftSpeedSquared = pool.parallel_reduce(0, size, scalar(0), [&context, data, dt, epoch, seed](
+            std::size_t, std::size_t begin, std::size_t end) {
+        scalar chunkMax = 0;
         const auto kbt = context.kBT();
-        std::size_t idx = beginIdx;
         const auto &box = context.boxSize().data();
         const auto &pbc = context.periodicBoundaryConditions().data();
-        for (auto it = entry_begin; it != entry_end; ++it, ++idx) {
-            if(!it->deactivated) {
-                const scalar D = context.particleTypes().diffusionConstantOf(it->type);
-                const auto randomDisplacement = std::sqrt(2. * D * dt) * rnd::normal3<readdy::scalar>(0, 1);
-                const auto deterministicDisplacement = it->force * dt * D / kbt;
-                it->pos += randomDisplacement + deterministicDisplacement;
-                bcs::fixPosition(it->pos, box, pbc);
+        // the normal numbers are generated in batches, which keeps the Philox and Box-Muller loop free of branches
+        constexpr std::size_t batchSize = 64;
+        std::array<Vec3, batchSize> noise;
+        for (auto batchBegin = begin; batchBegin < end; batchBegin += batchSize) {
+            const auto batchEnd = std::min(end, batchBegin + batchSize);
+            const auto entries = data->begin() + batchBegin;
+            for (std::size_t i = 0; i < batchEnd - batchBegin; ++i) {
+                noise[i] = rnd::CounterBasedStream(seed, epoch, static_cast<std::uint64_t>(batchBegin + i)).normal3();
             }
-        }
-    };
-
-    std::vector<util::thread::joining_future<void>> waitingFutures;
-    waitingFutures.reserve(kernel->getNThreads());
-    auto &pool  = kernel->pool();
-    {
-        auto it = data->begin();
-        std::vector<std::function<void(std::size_t)>> executables;
-        executables.reserve(kernel->getNThreads());
-
-        auto granularity = kernel->getNThreads();
-        const std::size_t grainSize = size / granularity;
-
-        std::size_t idx = 0;
-        for (auto i = 0_z; i < granularity-1; ++i) {
-            auto itNext = it + grainSize;
-            if(it != itNext) {
-                waitingFutures.emplace_back(pool.push(worker, idx, it, itNext));
+            for (std::size_t i = 0; i < batchEnd - batchBegin; ++i) {
+                auto &entry = entries[i];
+                if (!entry.deactivated) {
+                    const scalar D = context.particleTypes().diffusionConstantOf(entry.type);
+                    const auto randomDisplacement = std::sqrt(2. * D * dt) * noise[i];
+                    const auto deterministicDisplacement = entry.force * dt * D / kbt;
+                    const auto driftVelocity = entry.force * D / kbt;
+                    chunkMax = std::max(chunkMax, driftVelocity * driftVelocity);
+                    entry.pos += randomDisplacement + deterministicDisplacement;
+                    bcs::fixPosition(entry.pos, box, pbc);
+                }
             }
-            it = itNext;
-            idx += grainSize;
         }
-        if(it != data->end()) {
-            waitingFutures.emplace_back(pool.push(worker, idx, it, data->end()));
+        return chunkMax;
+    }, [](scalar lhs, scalar rhs) { return std::max(lhs, rhs); });
+    _maxDriftSpeed = std::sqrt(maxDriftSpeedSquared);
+}
+
+void CPUEulerBDIntegrator::performOnArrays(CPUStateModel::soa_data_type &data) {
+    const auto &context = kernel->context();
+    const auto dt = timeStep();
+    const auto epoch = kernel->nextRandomEpoch();
+    const auto seed = kernel->seed();
+
+    // the arrays are split along whole blocks of the activity mask, the noise is keyed by the particle index as above
+    auto &pool = kernel->pool();
+    const auto size = data.size();
+    constexpr auto blockSize = CPUStateModel::soa_data_type::maskBlockSize;
+    const auto nBlocks = (size + blockSize - 1) / blockSize;
+    const auto maxDriftSpeedSquared = pool.parallel_reduce(0, nBlocks, scalar(0), [&context, &data, size, dt, epoch, seed](
+            std::size_t, std::size_t blockBegin, std::size_t blockEnd) {
+        scalar chunkMax = 0;
+        const auto kbt = context.kBT();
+        const auto &box = context.boxSize().data();
+        const auto &pbc = context.periodicBoundaryConditions().data();
+        auto *x = data.x(), *y = data.y(), *z = data.z();
+        const auto *fx = data.fx(), *fy = data.fy(), *fz = data.fz();
+        const auto *types = data.types();
+        const auto &mask = data.activeMask();
+        std::array<Vec3, blockSize> noise;
+        for (auto block = blockBegin; block < blockEnd; ++block) {
+            const auto begin = block * blockSize;
+            const auto end = std::min(size, begin + blockSize);
+            for (std::size_t i = 0; i < end - begin; ++i) {
+                noise[i] = rnd::CounterBasedStream(seed, epoch, static_cast<std::uint64_t>(begin + i)).normal3();
+            }
+            for (auto i = begin; i < end; ++i) {
+                if ((mask[block] >> (i - begin)) & 1u) {
+                    const scalar D = context.particleTypes().diffusionConstantOf(types[i]);
+                    const auto noiseScale = std::sqrt(2. * D * dt);
+                    const Vec3 force {fx[i], fy[i], fz[i]};
+                    const auto driftVelocity = force * D / kbt;
+                    chunkMax = std::max(chunkMax, driftVelocity * driftVelocity);
+                    Vec3 pos {x[i], y[i], z[i]};
+                    pos += noiseScale * noise[i - begin] + force * dt * D / kbt;
+                    bcs::fixPosition(pos, box, pbc);
+                    x[i] = pos.x;
+                    y[i] = pos.y;
+                    z[i] = pos.z;
+                }
+            }
         }
-    }
+        return chunkMax;
+    }, [](scalar lhs, scalar rhs) { return std::max(lhs, rhs); });
+    _maxDriftSpeed = std::sqrt(maxDriftSpeedSquared);
 
+    // the entries are updated once somebody reads them
+    data.arrayPositionsChanged();
 }
 
 CPUEulerBDIntegrator::CPUEulerBDIntegrator(CPUKernel *kernel, scalar timeStep)
@@ -72,6 +72,8 @@ struct CPUEvaluateTopologyReactions::TREvent {
     ReactionId reactionId{0};
 };
 
+CPUEvaluateTopologyReactions::~CPUEvaluateTopologyReactions() = default;
+
 template<bool approximated>
 bool performReactionEvent(scalar rate, scalar timeStep);
 
@@ -96,18 +98,20 @@ void CPUEvaluateTopologyReactions::perform() {
 
     if (!topologies.empty()) {
 
-        auto events = gatherEvents();
+        auto &events = _events;
+        gatherEvents(events);
 
         if (!events.empty()) {
 
-            std::vector<readdy::model::top::GraphTopology> new_topologies;
+            auto &new_topologies = _newTopologies;
+            new_topologies.clear();
 
             {
                 auto shouldEval = [this](const TREvent &event) {
                     return performReactionEvent<false>(event.rate, timeStep());
                 };
-                auto depending = [this](const TREvent &e1, const TREvent &e2) {
-                    return eventsDependent(e1, e2);
+                auto keys = [this](const TREvent &event) {
+                    return eventKeys(event);
                 };
                 auto eval = [&](const TREvent &event) {
                     auto &topology = topologies.at(event.topology_idx);
@@ -139,21 +143,8 @@ void CPUEvaluateTopologyReactions::perform() {
                         }
                     }
                 };
-
-                /*auto postPerform = [&](const TREvent &event, std::size_t nDeactivated) {
-                    for(auto it = events.begin(); it < events.end() - nDeactivated; ++it) {
-                        if (eventsDependent(event, *it)) {
-                            //log::critical("here ya go ye filth: {}", sss.str());
-                            std::stringstream ss;
-                            for(auto _it = events.begin(); _it < events.end() - nDeactivated; ++_it) {
-                                ss << fmt::format("\tEvent: {}({}) + {}({})", _it->topology_idx, _it->idx1, _it->topology_idx2, _it->idx2) << "\n";
-                            }
-                            throw std::logic_error(fmt::format("events list contained event that shouldve been deactivated (t11={}, t12={}, t21={}, t22={}), (ix11={}, ix12={}, ix21={}, ix22={})\nlist:\n{}",
-                                                               event.topology_idx, event.topology_idx2, it->topology_idx, it->topology_idx2, event.idx1, event.idx2, it->idx1, it->idx2, ss.str()));
-                        }
-                    }
-                };*/
-                algo::performEvents(events, shouldEval, depending, eval);
+                auto scope = kernel->scratch().scope();
+                algo::performEventsIndexed(&kernel->scratch(), events, shouldEval, keys, eval);
             }
 
             if (!new_topologies.empty()) {
@@ -194,8 +185,8 @@ void CPUEvaluateTopologyReactions::handleStructuralReactionEvent(CPUStateModel::
                                                            kernel);
 }
 
-CPUEvaluateTopologyReactions::topology_reaction_events CPUEvaluateTopologyReactions::gatherEvents() {
-    topology_reaction_events events;
+void CPUEvaluateTopologyReactions::gatherEvents(topology_reaction_events &events) {
+    events.clear();
     const auto &topology_types = kernel->context().topologyRegistry();
     {
         rate_t current_cumulative_rate = 0;
@@ -228,7 +219,7 @@ CPUEvaluateTopologyReactions::topology_reaction_events CPUEvaluateTopologyReacti
             const auto &top_registry = context.topologyRegistry();
             const auto &box = context.boxSize().data();
             const auto &pbc = context.periodicBoundaryConditions().data();
-            const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+            const auto &data = *model.getParticleData();
             const auto &nl = *kernel->getCPUKernelStateModel().getNeighborList();
             const auto &topologies = kernel->getCPUKernelStateModel().topologies();
 
@@ -325,7 +316,6 @@ CPUEvaluateTopologyReactions::topology_reaction_events CPUEvaluateTopologyReacti
             }
         }
     }
-    return events;
 }
 
 void CPUEvaluateTopologyReactions::handleTopologyParticleReaction(CPUStateModel::topology_ref &topology,
@@ -427,15 +417,17 @@ void CPUEvaluateTopologyReactions::handleTopologyTopologyReaction(CPUStateModel:
     t1->configure();
 }
 
-bool CPUEvaluateTopologyReactions::eventsDependent(const CPUEvaluateTopologyReactions::TREvent &evt1,
-                                                   const CPUEvaluateTopologyReactions::TREvent &evt2) const {
-    if (evt1.topology_idx == evt2.topology_idx || evt1.topology_idx == evt2.topology_idx2) {
-        return true;
+std::array<std::size_t, 2>
+CPUEvaluateTopologyReactions::eventKeys(const CPUEvaluateTopologyReactions::TREvent &event) const {
+    // topologies get even keys, particles that are not part of a topology odd ones
+    const auto topologyKey = 2 * event.topology_idx;
+    if (!event.spatial) {
+        return {{topologyKey, topologyKey}};
+    }
+    if (event.topology_idx2 >= 0) {
+        return {{topologyKey, 2 * static_cast<std::size_t>(event.topology_idx2)}};
     }
-    auto tpWithSameP = evt1.topology_idx2 < 0 && evt2.topology_idx2 < 0 && evt1.idx2 == evt2.idx2;
-    if (tpWithSameP) return true;
-    return evt1.topology_idx2 >= 0 &&
-           (evt1.topology_idx2 == evt2.topology_idx || evt1.topology_idx2 == evt2.topology_idx2);
+    return {{topologyKey, 2 * static_cast<std::size_t>(event.idx2) + 1}};
 }
 
 bool CPUEvaluateTopologyReactions::topologyDeactivated(std::ptrdiff_t index) const {
@@ -0,0 +1,430 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * << detailed description >>
+ *
+ * @file CPUDetailedBalance.cpp
+ * @brief Implementation of the CPU detailed balance reaction handler
+ * @author clonker
+ * @author chrisfroe
+ * @date 16.10.26
+ */
+
+#include <readdy/kernel/cpu/actions/reactions/CPUDetailedBalance.h>
+#include <readdy/common/algorithm.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+namespace reactions {
+
+namespace rrt = readdy::model::actions::reactions;
+
+CPUDetailedBalance::CPUDetailedBalance(CPUKernel *const kernel, scalar timeStep) : super(timeStep), kernel(kernel) {
+    searchReversibleReactions(kernel->context());
+}
+
+CPUDetailedBalance::ParticleBackup::ParticleBackup(const event_t &event, const reversible_reaction *revReaction,
+                                                   const reaction_t *reaction, const data_t *data) {
+    switch (revReaction->reversibleType) {
+        case rrt::FusionFission: {
+            nParticles = event.nEducts;
+            t1 = event.t1;
+            t2 = event.t2;
+            pos1 = data->entry_at(event.idx1).pos;
+            pos2 = data->entry_at(event.idx2).pos;
+            break;
+        }
+        case rrt::ConversionConversion: {
+            nParticles = 1;
+            t1 = event.t1;
+            pos1 = data->entry_at(event.idx1).pos;
+            break;
+        }
+        case rrt::EnzymaticEnzymatic: {
+            nParticles = 1;
+            // find out which particle is the catalyst in A + C -> B + C
+            if (event.t1 == reaction->educts()[1]) {
+                t1 = event.t2;
+                pos1 = data->entry_at(event.idx2).pos;
+            } else if (event.t2 == reaction->educts()[1]) {
+                t1 = event.t1;
+                pos1 = data->entry_at(event.idx1).pos;
+            } else {
+                throw std::runtime_error(
+                        fmt::format("None of the event's particles could be identified as catalyst, method: {} file: {}",
+                                    "ParticleBackup::ParticleBackup", "CPUDetailedBalance.cpp"));
+            }
+            break;
+        }
+        default:
+            throw std::runtime_error(fmt::format("Unknown type of reversible reaction, method: {} file: {}",
+                                                 "ParticleBackup::ParticleBackup", "CPUDetailedBalance.cpp"));
+    }
+}
+
+void CPUDetailedBalance::perform() {
+    const auto &ctx = kernel->context();
+    if (ctx.reactions().nOrder1() == 0 && ctx.reactions().nOrder2() == 0) {
+        return;
+    }
+
+    auto &stateModel = kernel->getCPUKernelStateModel();
+    if (ctx.recordReactionsWithPositions()) {
+        stateModel.reactionRecords().clear();
+    }
+    if (ctx.recordReactionCounts()) {
+        stateModel.resetReactionCounts();
+    }
+
+    auto data = stateModel.getParticleData();
+    auto nl = stateModel.getNeighborList();
+
+    gatherEventsParallel(kernel, _eventBuffers, _events);
+
+    // the events refer to particle indices, which must not be permuted by the neighbor list updates in between
+    const auto reorderInterval = nl->reorderInterval();
+    nl->reorderInterval() = 0;
+
+    const auto approximateRate = false;
+
+    auto shouldEval = [&](const event_t &event) {
+        return shouldPerformEvent(event.rate, timeStep(), approximateRate);
+    };
+
+    auto keys = [](const event_t &event) {
+        return std::array<std::size_t, 2>{{event.idx1, event.nEducts == 2 ? event.idx2 : event.idx1}};
+    };
+
+    auto eval = [&](const event_t &event) {
+        const reaction_t *reaction;
+        const reversible_reaction *revReaction;
+        std::tie(revReaction, reaction) = findReversibleReaction(event);
+
+        if (revReaction != nullptr) {
+            // Perform detailed balance method for reversible reaction event
+            const auto particleBackup = ParticleBackup(event, revReaction, reaction, data);
+            const auto energyBefore = stateModel.energy();
+
+            record_t record;
+            data_t::DataUpdate forwardUpdate;
+            scalar interactionEnergy; // only relevant for FusionFission
+            std::tie(forwardUpdate, interactionEnergy) = performReversibleReactionEvent(
+                    event, revReaction, reaction, ctx.recordReactionsWithPositions() ? &record : nullptr);
+            const auto &updateRecord = data->update(std::move(forwardUpdate));
+            auto backwardUpdate = generateBackwardUpdate(particleBackup, updateRecord);
+            stateModel.updateNeighborList();
+            calculateEnergies();
+
+            scalar boltzmannFactor = 1.;
+            scalar prefactor = 1.;
+            switch (revReaction->reversibleType) {
+                case rrt::FusionFission: {
+                    // the sign of interactionEnergy was determined in performReversibleReactionEvent
+                    boltzmannFactor = std::exp(
+                            -1. / ctx.kBT() * ((stateModel.energy() - interactionEnergy) - energyBefore));
+                    break;
+                }
+                case rrt::ConversionConversion: {
+                    boltzmannFactor = std::exp(-1. / ctx.kBT() * (stateModel.energy() - energyBefore));
+                    break;
+                }
+                case rrt::EnzymaticEnzymatic: {
+                    if (reaction->educts() == revReaction->lhsTypes) {
+                        // forward
+                        prefactor = revReaction->acceptancePrefactor;
+                    } else {
+                        prefactor = 1. / revReaction->acceptancePrefactor;
+                    }
+                    boltzmannFactor = std::exp(-1. / ctx.kBT() * (stateModel.energy() - energyBefore));
+                    break;
+                }
+                default:
+                    throw std::runtime_error(fmt::format("Unknown type of reversible reaction, method: {} file: {}",
+                                                         "CPUDetailedBalance::perform::eval",
+                                                         "CPUDetailedBalance.cpp"));
+            }
+            const scalar acceptance = std::min(static_cast<scalar>(1.), prefactor * boltzmannFactor);
+            log::trace("Acceptance for current event is {}", acceptance);
+
+            if (readdy::model::rnd::uniform_real<scalar>() < acceptance) {
+                if (ctx.recordReactionsWithPositions()) {
+                    stateModel.reactionRecords().push_back(record);
+                }
+                if (ctx.recordReactionCounts()) {
+                    stateModel.reactionCounts().at(reaction->id())++;
+                }
+            } else {
+                data->update(std::move(backwardUpdate));
+                stateModel.updateNeighborList();
+                calculateEnergies();
+                // the summation order of the energies may differ after restoring the educts at other indices
+                const auto tolerance = static_cast<scalar>(1e-8)
+                                       * std::max(static_cast<scalar>(1), std::abs(energyBefore));
+                if (std::abs(energyBefore - stateModel.energy()) > tolerance) {
+                    log::warn("reaction move was rejected but energy of state is different "
+                              "after rollback, was {}, is now {}", energyBefore, stateModel.energy());
+                }
+            }
+        } else {
+            // Perform vanilla Doi model with direct update to data structure
+            data_t::EntriesUpdate newParticles;
+            std::vector<data_t::size_type> decayedEntries;
+            const auto ids = reserveProductIds(kernel, reaction);
+            if (ctx.recordReactionsWithPositions()) {
+                record_t record;
+                record.id = reaction->id();
+                performReaction(data, ctx, event.idx1, event.idx2, newParticles, decayedEntries, reaction, &record,
+                                nullptr, ids ? &*ids : nullptr);
+                bcs::fixPosition(record.where, ctx.boxSize().data(), ctx.periodicBoundaryConditions().data());
+                stateModel.reactionRecords().push_back(record);
+            } else {
+                performReaction(data, ctx, event.idx1, event.idx2, newParticles, decayedEntries, reaction, nullptr,
+                                nullptr, ids ? &*ids : nullptr);
+            }
+            if (ctx.recordReactionCounts()) {
+                stateModel.reactionCounts().at(reaction->id())++;
+            }
+            data->update(std::make_pair(std::move(newParticles), std::move(decayedEntries)));
+            stateModel.updateNeighborList();
+            calculateEnergies();
+        }
+    };
+
+    calculateEnergies();
+    auto scope = kernel->scratch().scope();
+    algo::performEventsIndexed(&kernel->scratch(), _events, shouldEval, keys, eval);
+
+    nl->reorderInterval() = reorderInterval;
+}
+
+data_t::DataUpdate CPUDetailedBalance::generateBackwardUpdate(const ParticleBackup &particleBackup,
+                                                              const std::vector<data_t::size_type> &updateRecord) {
+    // the entries that were created by the forward update
+    std::vector<data_t::size_type> decayedEntries = updateRecord;
+    data_t::EntriesUpdate newParticles{};
+    if (particleBackup.nParticles == 1) {
+        newParticles.emplace_back(readdy::model::Particle(particleBackup.pos1, particleBackup.t1));
+    } else if (particleBackup.nParticles == 2) {
+        newParticles.emplace_back(readdy::model::Particle(particleBackup.pos1, particleBackup.t1));
+        newParticles.emplace_back(readdy::model::Particle(particleBackup.pos2, particleBackup.t2));
+    } else {
+        throw std::runtime_error(
+                fmt::format("Particle backup can only contain information on one or two particles, method: {} file: {}",
+                            "CPUDetailedBalance::generateBackwardUpdate", "CPUDetailedBalance.cpp"));
+    }
+    return std::make_pair(std::move(newParticles), std::move(decayedEntries));
+}
+
+std::pair<data_t::DataUpdate, scalar> CPUDetailedBalance::performReversibleReactionEvent(
+        const event_t &event, const reversible_reaction *reversibleReaction, const reaction_t *reaction,
+        record_t *record) const {
+    if (reversibleReaction == nullptr) {
+        throw std::runtime_error(fmt::format("Reaction is not reversible, method: {} file: {}",
+                                             "CPUDetailedBalance::performReversibleReactionEvent",
+                                             "CPUDetailedBalance.cpp"));
+    }
+
+    const auto data = kernel->getCPUKernelStateModel().getParticleData();
+    const auto &ctx = kernel->context();
+    const auto &box = ctx.boxSize().data();
+    const auto &pbc = ctx.periodicBoundaryConditions().data();
+
+    // new entries are created instead of re-using the educts' ones, so that all educts end up in the decayed
+    // entries, which is required for constructing the backward update
+    data_t::EntriesUpdate newParticles{};
+    std::vector<data_t::size_type> decayedEntries{};
+
+    const auto ids = reserveProductIds(kernel, reaction);
+    std::size_t nIds = 0;
+    auto nextId = [&ids, &nIds]() {
+        return ids ? *ids + nIds++ : readdy::model::Particle::nextThreadLocalId();
+    };
+
+    auto fillRecord = [&](const data::Entry &educt1, const data::Entry &educt2, const Vec3 &where) {
+        if (record) {
+            record->id = reaction->id();
+            record->type = static_cast<int>(reaction->type());
+            record->where = where;
+            bcs::fixPosition(record->where, box, pbc);
+            record->educts[0] = educt1.id;
+            record->educts[1] = educt2.id;
+            record->types_from[0] = educt1.type;
+            record->types_from[1] = educt2.type;
+        }
+    };
+
+    scalar energyDelta = 0;
+    switch (reversibleReaction->reversibleType) {
+        case rrt::FusionFission: {
+            if (event.nEducts == 1) {
+                // backward reaction C --> A + B
+                const auto &entry1 = data->entry_at(event.idx1);
+                auto n3 = readdy::model::rnd::normal3<readdy::scalar>(0, 1);
+                n3 /= std::sqrt(n3 * n3);
+                const auto distance = reversibleReaction->drawFissionDistance();
+                Vec3 difference(distance, 0, 0); // orientation does not matter for energy
+                scalar energyGain = 0.; // calculate U_AB
+                for (const auto &p : reversibleReaction->lhsPotentials) {
+                    energyGain += p->calculateEnergy(difference);
+                }
+                energyDelta = energyGain;
+                newParticles.emplace_back(bcs::applyPBC(entry1.pos - reaction->weight2() * distance * n3, box, pbc),
+                                          reaction->products()[1], nextId());
+                newParticles.emplace_back(bcs::applyPBC(entry1.pos + reaction->weight1() * distance * n3, box, pbc),
+                                          reaction->products()[0], nextId());
+                decayedEntries.push_back(event.idx1);
+                fillRecord(entry1, entry1, entry1.pos);
+            } else if (event.nEducts == 2) {
+                // forward reaction A + B --> C
+                const auto &entry1 = data->entry_at(event.idx1);
+                const auto &entry2 = data->entry_at(event.idx2);
+                const auto difference = bcs::shortestDifference(entry1.pos, entry2.pos, box, pbc);
+                scalar energyLoss = 0.; // calculate U_AB
+                for (const auto &p : reversibleReaction->lhsPotentials) {
+                    energyLoss += p->calculateEnergy(difference);
+                }
+                energyDelta = -1. * energyLoss;
+                const auto weight = reaction->educts()[0] == entry1.type ? reaction->weight1() : reaction->weight2();
+                newParticles.emplace_back(bcs::applyPBC(entry1.pos + weight * difference, box, pbc),
+                                          reaction->products()[0], nextId());
+                decayedEntries.push_back(event.idx1);
+                decayedEntries.push_back(event.idx2);
+                fillRecord(entry1, entry2, (entry1.pos + entry2.pos) / 2.);
+            }
+            break;
+        }
+        case rrt::ConversionConversion: {
+            const auto &entry = data->entry_at(event.idx1);
+            newParticles.emplace_back(entry.pos, reaction->products()[0], nextId());
+            decayedEntries.push_back(event.idx1);
+            fillRecord(entry, entry, entry.pos);
+            break;
+        }
+        case rrt::EnzymaticEnzymatic: {
+            // find out which particle is the catalyst in A + C -> B + C
+            const auto catalystFirst = event.t1 == reaction->educts()[1];
+            const auto catalystIdx = catalystFirst ? event.idx1 : event.idx2;
+            const auto eductIdx = catalystFirst ? event.idx2 : event.idx1;
+            const auto &eductEntry = data->entry_at(eductIdx);
+            const auto &catalystEntry = data->entry_at(catalystIdx);
+            newParticles.emplace_back(eductEntry.pos, reaction->products()[0], nextId());
+            decayedEntries.push_back(eductIdx);
+            fillRecord(eductEntry, catalystEntry, (eductEntry.pos + catalystEntry.pos) / 2.);
+            break;
+        }
+        default:
+            throw std::runtime_error(fmt::format("Unknown type of reversible reaction, method: {} file: {}",
+                                                 "CPUDetailedBalance::performReversibleReactionEvent",
+                                                 "CPUDetailedBalance.cpp"));
+    }
+
+    return std::make_pair(std::make_pair(std::move(newParticles), std::move(decayedEntries)), energyDelta);
+}
+
+void CPUDetailedBalance::calculateEnergies() {
+    const auto &ctx = kernel->context();
+    auto &stateModel = kernel->getCPUKernelStateModel();
+    const auto &data = *stateModel.getParticleData();
+    const auto &nl = *stateModel.getNeighborList();
+    const auto &interactions = kernel->interactions();
+    const auto &box = ctx.boxSize().data();
+    const auto &pbc = ctx.periodicBoundaryConditions().data();
+    auto &pool = kernel->pool();
+    const auto sum = [](scalar lhs, scalar rhs) { return lhs + rhs; };
+
+    scalar energy = 0;
+    if (interactions.hasPotentialsOrder1()) {
+        energy += pool.parallel_reduce(0, data.size(), static_cast<scalar>(0),
+                                       [&](std::size_t, std::size_t begin, std::size_t end) {
+            scalar energyUpdate = 0;
+            for (auto i = begin; i < end; ++i) {
+                const auto &entry = data.entry_at(i);
+                if (!entry.deactivated) {
+                    for (const auto &potential : interactions.potentialsOrder1(entry.type)) {
+                        energyUpdate += potential->calculateEnergy(entry.pos);
+                    }
+                }
+            }
+            return energyUpdate;
+        }, sum);
+    }
+    const auto &pot2 = interactions.pairPotentials();
+    if (!pot2.empty()) {
+        // each pair is visited once, the cells are handed out in ranges of similar pair work
+        const auto &chunks = nl.costBalancedChunks(thread_pool::chunksPerThread * pool.teamSize());
+        energy += pool.parallel_reduce_balanced(chunks, static_cast<scalar>(0),
+                                                [&](std::size_t, std::size_t begin, std::size_t end) {
+            scalar energyUpdate = 0;
+            Vec3 force;
+            for (auto cell = begin; cell < end; ++cell) {
+                for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
+                    const auto &entry = data.entry_at(*particleIt);
+                    nl.forEachNeighborHalf(*particleIt, cell, [&](auto neighborIndex) {
+                        const auto &neighbor = data.entry_at(neighborIndex);
+                        const auto &potentials = pot2(entry.type, neighbor.type);
+                        if (!neighbor.deactivated && !potentials.empty()) {
+                            const auto x_ij = bcs::shortestDifference(entry.pos, neighbor.pos, box, pbc);
+                            potentials.calculateForceAndEnergy(force, energyUpdate, x_ij, x_ij * x_ij);
+                        }
+                    });
+                }
+            }
+            return energyUpdate;
+        }, sum, "CPUDetailedBalance::calculateEnergies");
+    }
+    stateModel.energy() = energy;
+}
+
+std::pair<const CPUDetailedBalance::reversible_reaction *, const CPUDetailedBalance::reaction_t *>
+CPUDetailedBalance::findReversibleReaction(const event_t &event) const {
+    const auto &interactions = kernel->interactions();
+    const auto &reaction = event.nEducts == 1
+                           ? interactions.reactionsOrder1(event.t1)[event.reactionIndex]
+                           : interactions.reactionsOrder2(event.t1, event.t2)[event.reactionIndex];
+    auto findIt = _reversibleReactionsMap.find(reaction->id());
+    if (findIt != _reversibleReactionsMap.end()) {
+        return std::make_pair(findIt->second.get(), reaction);
+    }
+    return std::make_pair(nullptr, reaction);
+}
+
+}
+}
+}
+}
+}
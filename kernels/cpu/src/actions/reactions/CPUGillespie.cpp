@@ -57,39 +57,23 @@ void CPUGillespie::perform() {
     }
     auto &stateModel = kernel->getCPUKernelStateModel();
     auto data = stateModel.getParticleData();
-    const auto nl = stateModel.getNeighborList();
 
     if(ctx.recordReactionCounts()) {
         stateModel.resetReactionCounts();
     }
 
-    scalar alpha = 0.0;
-    std::vector<event_t> events;
-    gatherEvents(kernel, readdy::util::range<event_t::index_type>(0, data->size()), nl, data, alpha, events);
+    const auto sampleFirstOrder = ctx.kernelConfiguration().cpu.sampleFirstOrderReactions;
+    gatherEventsParallel(kernel, _eventBuffers, _events, !sampleFirstOrder);
+    if (sampleFirstOrder) {
+        _firstOrderSampler.sample(kernel, timeStep(), false, kernel->nextRandomEpoch(), _events);
+    }
     if(ctx.recordReactionsWithPositions()) {
         stateModel.reactionRecords().clear();
-        if(ctx.recordReactionCounts()) {
-            auto &counts = stateModel.reactionCounts();
-            auto particlesUpdate = handleEventsGillespie(kernel, timeStep(), false, false, std::move(events),
-                                                         &stateModel.reactionRecords(), &counts);
-            data->update(std::move(particlesUpdate));
-        } else {
-            auto particlesUpdate = handleEventsGillespie(kernel, timeStep(), false, false, std::move(events),
-                                                         &stateModel.reactionRecords(), nullptr);
-            data->update(std::move(particlesUpdate));
-        }
-    } else {
-        if(ctx.recordReactionCounts()) {
-            auto &counts = stateModel.reactionCounts();
-            auto particlesUpdate = handleEventsGillespie(kernel, timeStep(), false, false, std::move(events),
-                                                         nullptr, &counts);
-            data->update(std::move(particlesUpdate));
-        } else {
-            auto particlesUpdate = handleEventsGillespie(kernel, timeStep(), false, false, std::move(events),
-                                                         nullptr, nullptr);
-            data->update(std::move(particlesUpdate));
-        }
     }
+    auto *records = ctx.recordReactionsWithPositions() ? &stateModel.reactionRecords() : nullptr;
+    auto *counts = ctx.recordReactionCounts() ? &stateModel.reactionCounts() : nullptr;
+    handleEventsGillespie(kernel, timeStep(), false, false, _events, _update, records, counts, sampleFirstOrder);
+    data->update(std::move(_update));
 }
 
 }
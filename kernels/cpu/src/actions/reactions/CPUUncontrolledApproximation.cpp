@@ -60,17 +60,18 @@ using data_iter_t = data_t::const_iterator;
 using neighbor_list = CPUStateModel::neighbor_list;
 using nl_bounds = std::tuple<std::size_t, std::size_t>;
 using entry_type = data_t::Entries::value_type;
+namespace rnd = readdy::model::rnd;
 
-using event_future_t = std::future<std::vector<event_t>>;
-using event_promise_t = std::promise<std::vector<event_t>>;
 
 CPUUncontrolledApproximation::CPUUncontrolledApproximation(CPUKernel *kernel, readdy::scalar timeStep)
         : super(timeStep), kernel(kernel) {}
 
-void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_bounds nlBounds,
-                const CPUKernel *const kernel, scalar dt, bool approximateRate, const neighbor_list &nl,
-                event_promise_t &events, std::promise<std::size_t> &n_events) {
-    std::vector<event_t> eventsUpdate;
+// appends the events of the particles [begin, end) and of the pairs in the cells nlBounds to eventsUpdate, the
+// first order draws are keyed by (epoch, particle index), the pair draws by (epoch + 1, particle indices)
+void findEvents(data_iter_t begin, data_iter_t end, nl_bounds nlBounds, const CPUKernel *const kernel,
+                const InteractionSnapshot &interactions, scalar dt, bool approximateRate, const neighbor_list &nl,
+                std::uint32_t epoch, std::vector<event_t> &eventsUpdate) {
+    const auto seed = kernel->seed();
     const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
     const auto &box = kernel->context().boxSize().data();
     const auto &pbc = kernel->context().periodicBoundaryConditions().data();
@@ -81,10 +82,11 @@ void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_boun
         if (!entry.deactivated) {
             // order 1
             {
-                const auto &reactions = kernel->context().reactions().order1ByType(entry.type);
+                const auto &reactions = interactions.reactionsOrder1(entry.type);
+                rnd::CounterBasedStream stream(seed, epoch, static_cast<std::uint64_t>(index));
                 for (auto it_reactions = reactions.begin(); it_reactions != reactions.end(); ++it_reactions) {
                     const auto rate = (*it_reactions)->rate();
-                    if (rate > 0 && shouldPerformEvent(rate, dt, approximateRate)) {
+                    if (rate > 0 && shouldPerformEvent(rate, dt, approximateRate, stream.uniform())) {
                         eventsUpdate.emplace_back(1, (*it_reactions)->nProducts(), index, index, rate, 0,
                                                   static_cast<event_t::reaction_index_type>(it_reactions -
                                                                                             reactions.begin()),
@@ -106,15 +108,17 @@ void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_boun
                 // Making sure that every pair of particles is only seen once
                 if (*particleIt > neighborIdx) {
                     const auto &neighbor = data.entry_at(neighborIdx);
-                    if(!neighbor.deactivated) {
-                        const auto &reactions = kernel->context().reactions().order2ByType(entry.type, neighbor.type);
-                        if (!reactions.empty()) {
-                            const auto distSquared = bcs::distSquared(neighbor.pos, entry.pos, box, pbc);
+                    if(!neighbor.deactivated && interactions.hasReactionsOrder2(entry.type, neighbor.type)) {
+                        const auto distSquared = bcs::distSquared(neighbor.pos, entry.pos, box, pbc);
+                        if (distSquared < interactions.maxEductDistanceSquared(entry.type, neighbor.type)) {
+                            const auto reactions = interactions.reactionsOrder2(entry.type, neighbor.type);
+                            rnd::CounterBasedStream stream(seed, epoch + 1, static_cast<std::uint32_t>(*particleIt),
+                                                           static_cast<std::uint32_t>(neighborIdx));
                             for (auto it_reactions = reactions.begin(); it_reactions < reactions.end(); ++it_reactions) {
                                 const auto &react = *it_reactions;
                                 const auto rate = react->rate();
                                 if (rate > 0 && distSquared < react->eductDistanceSquared()
-                                    && shouldPerformEvent(rate, dt, approximateRate)) {
+                                    && shouldPerformEvent(rate, dt, approximateRate, stream.uniform())) {
                                     const auto reaction_index = static_cast<event_t::reaction_index_type>(it_reactions -
                                                                                                           reactions.begin());
                                     eventsUpdate.emplace_back(2, react->nProducts(), *particleIt, neighborIdx,
@@ -128,12 +132,11 @@ void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_boun
         }
     }
 
-    n_events.set_value(eventsUpdate.size());
-    events.set_value(std::move(eventsUpdate));
 }
 
 void CPUUncontrolledApproximation::perform() {
     const auto &ctx = kernel->context();
+    const auto &interactions = kernel->interactions();
     auto &stateModel = kernel->getCPUKernelStateModel();
     auto nl = stateModel.getNeighborList();
     auto &data = nl->data();
@@ -147,111 +150,150 @@ void CPUUncontrolledApproximation::perform() {
         stateModel.resetReactionCounts();
     }
 
+    // epochs of the first order draws, the pair draws, the shuffle and the reactions' products
+    const auto epoch = kernel->nextRandomEpoch(4);
+
     // gather events
-    std::vector<std::promise<std::size_t>> n_events_promises(kernel->getNThreads());
-    std::vector<event_promise_t> promises(kernel->getNThreads());
     {
-
         auto &pool = kernel->pool();
-
-        std::vector<std::function<void(std::size_t)>> executables;
-        executables.reserve(kernel->getNThreads());
-
-        std::size_t grainSize = data.size() / kernel->getNThreads();
-        std::size_t nlGrainSize = nl->nCells() / kernel->getNThreads();
-
-        auto it = data.cbegin();
-        std::size_t it_nl = 0;
-        for (auto i = 0U; i < kernel->getNThreads()-1 ; ++i) {
-            auto itNext = std::min(it+grainSize, data.cend());
-
-            auto nlNext = std::min(it_nl + nlGrainSize, nl->nCells());
-            auto bounds_nl = std::make_tuple(it_nl, nlNext);
-
-            pool.push(findEvents, it, itNext, bounds_nl, kernel, timeStep(), false, std::cref(*nl),
-                      std::ref(promises.at(i)), std::ref(n_events_promises.at(i)));
-
-            it = itNext;
-            it_nl = nlNext;
+        const auto nThreads = pool.teamSize();
+        _threadEvents.resize(nThreads);
+        for (auto &threadEvents : _threadEvents) {
+            threadEvents.clear();
         }
-        pool.push(findEvents, it, data.cend(), std::make_tuple(it_nl, nl->nCells()), kernel, timeStep(), false,
-                  std::cref(*nl), std::ref(promises.back()), std::ref(n_events_promises.back()));
+        const auto noCells = std::make_tuple(0_z, 0_z);
+        // first order events have uniform cost per particle, the cells are scheduled by their estimated pair work
+        if (ctx.kernelConfiguration().cpu.sampleFirstOrderReactions) {
+            _firstOrderSampler.sample(kernel, timeStep(), false, epoch, _threadEvents.front());
+        } else {
+            pool.parallel_for(0, data.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+                findEvents(data.cbegin() + begin, data.cbegin() + end, noCells, kernel, interactions, timeStep(),
+                           false, *nl, epoch, _threadEvents[tid]);
+            });
+        }
+        const auto &chunks = nl->costBalancedChunks(thread_pool::chunksPerThread * nThreads);
+        pool.parallel_for_balanced(chunks, [&](std::size_t tid, std::size_t begin, std::size_t end) {
+            findEvents(data.cend(), data.cend(), std::make_tuple(begin, end), kernel, interactions, timeStep(), false,
+                       *nl, epoch, _threadEvents[tid]);
+        }, "CPUUncontrolledApproximation::findEvents");
     }
 
     // collect events
-    std::vector<event_t> events;
+    auto &events = _events;
+    events.clear();
     {
         std::size_t n_events = 0;
-        for (auto &&f : n_events_promises) {
-            n_events += f.get_future().get();
+        for (const auto &threadEvents : _threadEvents) {
+            n_events += threadEvents.size();
         }
         events.reserve(n_events);
-        for (auto &&f : promises) {
-            auto eventUpdate = std::move(f.get_future().get());
-            auto mBegin = std::make_move_iterator(eventUpdate.begin());
-            auto mEnd = std::make_move_iterator(eventUpdate.end());
-            events.insert(events.end(), mBegin, mEnd);
+        for (const auto &threadEvents : _threadEvents) {
+            events.insert(events.end(), threadEvents.begin(), threadEvents.end());
         }
+        // the gathered order depends on the scheduling, bring it into a canonical one before shuffling
+        std::sort(events.begin(), events.end(), [](const event_t &lhs, const event_t &rhs) {
+            return std::tie(lhs.nEducts, lhs.idx1, lhs.idx2, lhs.reactionIndex)
+                   < std::tie(rhs.nEducts, rhs.idx1, rhs.idx2, rhs.reactionIndex);
+        });
     }
 
     // shuffle reactions
-    std::shuffle(events.begin(), events.end(), std::mt19937(std::random_device()()));
+    std::shuffle(events.begin(), events.end(), rnd::CounterBasedStream(kernel->seed(), epoch + 2, 0, 0));
 
-    // execute reactions
+    // resolve conflicts: in shuffled order, an event is accepted if none of its educts was claimed before
+    auto &accepted = _accepted;
+    accepted.clear();
     {
-        data_t::EntriesUpdate newParticles{};
-        std::vector<data_t::size_type> decayedEntries{};
+        if (++_claimEpoch == 0) {
+            std::fill(_claimed.begin(), _claimed.end(), 0);
+            _claimEpoch = 1;
+        }
+        _claimed.resize(data.size(), 0);
+        for (const auto &event : events) {
+            if (_claimed[event.idx1] != _claimEpoch && _claimed[event.idx2] != _claimEpoch) {
+                _claimed[event.idx1] = _claimEpoch;
+                _claimed[event.idx2] = _claimEpoch;
+                accepted.push_back(event);
+            }
+        }
+        if (ctx.recordReactionCounts()) {
+            auto &counts = stateModel.reactionCounts();
+            for (const auto &event : accepted) {
+                const auto &reaction = event.nEducts == 1
+                                       ? interactions.reactionsOrder1(event.t1)[event.reactionIndex]
+                                       : interactions.reactionsOrder2(event.t1, event.t2)[event.reactionIndex];
+                counts.at(reaction->id())++;
+            }
+        }
+    }
 
-        // todo better conflict detection?
-        for (auto it = events.begin(); it != events.end(); ++it) {
-            auto &event = *it;
-            if (event.cumulativeRate == 0) {
-                auto entry1 = event.idx1;
-                if (event.nEducts == 1) {
-                    auto reaction = ctx.reactions().order1ByType(event.t1)[event.reactionIndex];
-                    if (ctx.recordReactionsWithPositions()) {
-                        record_t record;
-                        record.id = reaction->id();
-                        performReaction(&data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, &record);
-                        bcs::fixPosition(record.where, box, pbc);
-                        kernel->getCPUKernelStateModel().reactionRecords().push_back(record);
-                    } else {
-                        performReaction(&data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, nullptr);
-                    }
-                    if (ctx.recordReactionCounts()) {
-                        auto &counts = stateModel.reactionCounts();
-                        counts.at(reaction->id())++;
-                    }
-                    for (auto _it2 = it + 1; _it2 != events.end(); ++_it2) {
-                        if (_it2->idx1 == entry1 || _it2->idx2 == entry1) {
-                            _it2->cumulativeRate = 1;
-                        }
-                    }
+    // in reproducible runs the product ids are assigned in the order of the accepted events rather than taken from
+    // the id blocks of whichever threads perform them
+    auto &firstIds = _firstIds;
+    firstIds.clear();
+    if (kernel->reproducible()) {
+        firstIds.resize(accepted.size());
+        std::size_t nIds = 0;
+        for (std::size_t i = 0; i < accepted.size(); ++i) {
+            const auto &event = accepted[i];
+            firstIds[i] = nIds;
+            nIds += nProductIds(event.nEducts == 1
+                                ? interactions.reactionsOrder1(event.t1)[event.reactionIndex]
+                                : interactions.reactionsOrder2(event.t1, event.t2)[event.reactionIndex]);
+        }
+        const auto firstId = readdy::model::Particle::reserveIds(nIds);
+        for (auto &id : firstIds) {
+            id += firstId;
+        }
+    }
+
+    // execute reactions, the accepted events have pairwise disjoint educts and can be performed concurrently
+    {
+        auto &pool = kernel->pool();
+        const auto recordPositions = ctx.recordReactionsWithPositions();
+        _threadUpdates.resize(pool.teamSize());
+        for (auto &update : _threadUpdates) {
+            update.newParticles.clear();
+            update.decayedEntries.clear();
+            update.records.clear();
+        }
+        pool.parallel_for(0, accepted.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+            auto &update = _threadUpdates[tid];
+            for (auto i = begin; i < end; ++i) {
+                const auto &event = accepted[i];
+                rnd::CounterBasedStream stream(kernel->seed(), epoch + 3, static_cast<std::uint64_t>(event.idx1));
+                const auto *ids = firstIds.empty() ? nullptr : &firstIds[i];
+                const readdy::model::reactions::Reaction *reaction = event.nEducts == 1
+                        ? interactions.reactionsOrder1(event.t1)[event.reactionIndex]
+                        : interactions.reactionsOrder2(event.t1, event.t2)[event.reactionIndex];
+                if (recordPositions) {
+                    record_t record;
+                    record.id = reaction->id();
+                    performReaction(&data, ctx, event.idx1, event.idx2, update.newParticles, update.decayedEntries,
+                                    reaction, &record, &stream, ids);
+                    bcs::fixPosition(record.where, box, pbc);
+                    update.records.push_back(record);
                 } else {
-                    auto reaction = ctx.reactions().order2ByType(event.t1, event.t2)[event.reactionIndex];
-                    if (ctx.recordReactionsWithPositions()) {
-                        record_t record;
-                        record.id = reaction->id();
-                        performReaction(&data, ctx, entry1, event.idx2, newParticles, decayedEntries, reaction, &record);
-                        bcs::fixPosition(record.where, box, pbc);
-                        kernel->getCPUKernelStateModel().reactionRecords().push_back(record);
-                    } else {
-                        performReaction(&data, ctx, entry1, event.idx2, newParticles, decayedEntries, reaction, nullptr);
-                    }
-                    if (ctx.recordReactionCounts()) {
-                        auto &counts = stateModel.reactionCounts();
-                        counts.at(reaction->id())++;
-                    }
-                    for (auto _it2 = it + 1; _it2 != events.end(); ++_it2) {
-                        if (_it2->idx1 == entry1 || _it2->idx2 == entry1 ||
-                            _it2->idx1 == event.idx2 || _it2->idx2 == event.idx2) {
-                            _it2->cumulativeRate = 1;
-                        }
-                    }
+                    performReaction(&data, ctx, event.idx1, event.idx2, update.newParticles, update.decayedEntries,
+                                    reaction, nullptr, &stream, ids);
                 }
             }
+        });
+
+        // merging in thread order yields the order of the accepted events, independent of the number of threads
+        auto &[newParticles, decayedEntries] = _update;
+        newParticles.clear();
+        decayedEntries.clear();
+        for (auto &update : _threadUpdates) {
+            newParticles.insert(newParticles.end(), std::make_move_iterator(update.newParticles.begin()),
+                                std::make_move_iterator(update.newParticles.end()));
+            decayedEntries.insert(decayedEntries.end(), update.decayedEntries.begin(), update.decayedEntries.end());
+            if (recordPositions) {
+                auto &records = stateModel.reactionRecords();
+                records.insert(records.end(), update.records.begin(), update.records.end());
+            }
         }
-        data.update(std::make_pair(std::move(newParticles), std::move(decayedEntries)));
+        data.update(std::move(_update));
     }
 }
 }
@@ -43,8 +43,11 @@
  * @date 20.10.16
  */
 
+#include <numeric>
+
 #include <readdy/kernel/cpu/actions/reactions/ReactionUtils.h>
 #include <readdy/common/algorithm.h>
+#include <readdy/common/range.h>
 
 namespace readdy {
 namespace kernel {
@@ -52,18 +55,92 @@ namespace cpu {
 namespace actions {
 namespace reactions {
 
+void gatherEventsParallel(CPUKernel *const kernel, EventBuffers &buffers, std::vector<event_t> &events,
+                          bool firstOrder) {
+    // the first nThreads buffers hold first order events, the remaining ones the events of the cost balanced cell
+    // chunks
+    auto data = kernel->getCPUKernelStateModel().getParticleData();
+    const auto nl = kernel->getCPUKernelStateModel().getNeighborList();
+    auto &pool = kernel->pool();
+    const auto nThreads = pool.teamSize();
+    const auto &chunks = nl->costBalancedChunks(thread_pool::chunksPerThread * nThreads);
+    const auto nCellChunks = chunks.empty() ? 0 : chunks.size() - 1;
+    auto &chunkEvents = buffers.chunkEvents;
+    auto &chunkRates = buffers.chunkRates;
+    auto &rateOffsets = buffers.rateOffsets;
+    chunkEvents.resize(nThreads + nCellChunks);
+    for (auto &buffer : chunkEvents) {
+        buffer.clear();
+    }
+    chunkRates.assign(chunkEvents.size(), 0);
+
+    if (firstOrder) {
+        pool.parallel_for(0, data->size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+            gatherEvents(kernel, readdy::util::range<event_t::index_type>(begin, end), nl, data, chunkRates[tid],
+                         chunkEvents[tid], 0, 0);
+        });
+    }
+    if (nCellChunks > 0) {
+        // schedule the cell chunks one by one, so that each one has its own buffer
+        auto &chunkIndices = buffers.chunkIndices;
+        chunkIndices.resize(nCellChunks + 1);
+        std::iota(chunkIndices.begin(), chunkIndices.end(), 0);
+        pool.parallel_for_balanced(chunkIndices, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto chunk = begin; chunk < end; ++chunk) {
+                const auto noParticles = readdy::util::range<event_t::index_type>(0, 0);
+                gatherEvents(kernel, noParticles, nl, data, chunkRates[nThreads + chunk],
+                             chunkEvents[nThreads + chunk], chunks[chunk], chunks[chunk + 1]);
+            }
+        }, "gatherEventsParallel");
+    }
+
+    // exclusive prefix sum over the buffers' total rates yields the offsets of their cumulative rates
+    std::size_t nEvents = 0;
+    rateOffsets.assign(chunkEvents.size(), 0);
+    for (std::size_t i = 0; i < chunkEvents.size(); ++i) {
+        nEvents += chunkEvents[i].size();
+        if (i > 0) {
+            rateOffsets[i] = rateOffsets[i - 1] + chunkRates[i - 1];
+        }
+    }
+    pool.parallel_for(0, chunkEvents.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            for (auto &event : chunkEvents[i]) {
+                event.cumulativeRate += rateOffsets[i];
+            }
+        }
+    });
+    events.clear();
+    events.reserve(nEvents);
+    for (const auto &buffer : chunkEvents) {
+        events.insert(events.end(), buffer.begin(), buffer.end());
+    }
+}
+
 data_t::DataUpdate handleEventsGillespie(
         CPUKernel *const kernel, scalar timeStep, bool filterEventsInAdvance, bool approximateRate,
-        std::vector<event_t> &&events, std::vector<record_t> *maybeRecords, reaction_counts_map *maybeCounts) {
-    using rdy_particle_t = readdy::model::Particle;
+        std::vector<event_t> &events, std::vector<record_t> *maybeRecords, reaction_counts_map *maybeCounts,
+        bool firstOrderInAdvance) {
+    data_t::DataUpdate update;
+    handleEventsGillespie(kernel, timeStep, filterEventsInAdvance, approximateRate, events, update, maybeRecords,
+                          maybeCounts, firstOrderInAdvance);
+    return update;
+}
+
+void handleEventsGillespie(
+        CPUKernel *const kernel, scalar timeStep, bool filterEventsInAdvance, bool approximateRate,
+        std::vector<event_t> &events, data_t::DataUpdate &update, std::vector<record_t> *maybeRecords,
+        reaction_counts_map *maybeCounts, bool firstOrderInAdvance) {
     const auto &box = kernel->context().boxSize().data();
     const auto &pbc = kernel->context().periodicBoundaryConditions().data();
 
-    data_t::EntriesUpdate newParticles{};
-    std::vector<data_t::size_type> decayedEntries{};
+    auto &[newParticles, decayedEntries] = update;
+    newParticles.clear();
+    decayedEntries.clear();
 
     if (!events.empty()) {
         const auto &ctx = kernel->context();
+        const auto &interactions = kernel->interactions();
         auto data = kernel->getCPUKernelStateModel().getParticleData();
         /**
          * Handle gathered reaction events
@@ -71,43 +148,47 @@ data_t::DataUpdate handleEventsGillespie(
         {
 
             auto shouldEval = [&](const event_t &event) {
-                return filterEventsInAdvance || shouldPerformEvent(event.rate, timeStep, approximateRate);
+                return filterEventsInAdvance || (firstOrderInAdvance && event.nEducts == 1)
+                       || shouldPerformEvent(event.rate, timeStep, approximateRate);
             };
 
-            auto depending = [&](const event_t &e1, const event_t &e2) {
-                return (e1.idx1 == e2.idx1 || (e2.nEducts == 2 && e1.idx1 == e2.idx2)
-                        || (e1.nEducts == 2 && (e1.idx2 == e2.idx1 || (e2.nEducts == 2 && e1.idx2 == e2.idx2))));
+            auto keys = [](const event_t &event) {
+                return std::array<std::size_t, 2>{{event.idx1, event.nEducts == 2 ? event.idx2 : event.idx1}};
             };
 
             auto eval = [&](const event_t &event) {
                 auto entry1 = event.idx1;
                 if (event.nEducts == 1) {
-                    auto reaction = ctx.reactions().order1ByType(event.t1)[event.reactionIndex];
+                    auto reaction = interactions.reactionsOrder1(event.t1)[event.reactionIndex];
+                    const auto ids = reserveProductIds(kernel, reaction);
                     if (maybeRecords != nullptr) {
                         record_t record;
                         record.id = reaction->id();
-                        performReaction(data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, &record);
+                        performReaction(data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, &record,
+                                        nullptr, ids ? &*ids : nullptr);
                         bcs::fixPosition(record.where, box, pbc);
                         maybeRecords->push_back(record);
                     } else {
-                        performReaction(data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, nullptr);
+                        performReaction(data, ctx, entry1, entry1, newParticles, decayedEntries, reaction, nullptr,
+                                        nullptr, ids ? &*ids : nullptr);
                     }
                     if (maybeCounts != nullptr) {
                         auto &counts = *maybeCounts;
                         counts.at(reaction->id())++;
                     }
                 } else {
-                    auto reaction = ctx.reactions().order2ByType(event.t1, event.t2)[event.reactionIndex];
+                    auto reaction = interactions.reactionsOrder2(event.t1, event.t2)[event.reactionIndex];
+                    const auto ids = reserveProductIds(kernel, reaction);
                     if (maybeRecords != nullptr) {
                         record_t record;
                         record.id = reaction->id();
                         performReaction(data, ctx, entry1, event.idx2, newParticles, decayedEntries, reaction,
-                                        &record);
+                                        &record, nullptr, ids ? &*ids : nullptr);
                         bcs::fixPosition(record.where, box, pbc);
                         maybeRecords->push_back(record);
                     } else {
                         performReaction(data, ctx, entry1, event.idx2, newParticles, decayedEntries, reaction,
-                                        nullptr);
+                                        nullptr, nullptr, ids ? &*ids : nullptr);
                     }
                     if (maybeCounts != nullptr) {
                         auto &counts = *maybeCounts;
@@ -116,10 +197,75 @@ data_t::DataUpdate handleEventsGillespie(
                 }
             };
 
-            algo::performEvents(events, shouldEval, depending, eval);
+            auto scope = kernel->scratch().scope();
+            algo::performEventsIndexed(&kernel->scratch(), events, shouldEval, keys, eval);
+        }
+    }
+}
+
+void FirstOrderSampler::sample(CPUKernel *const kernel, scalar timeStep, bool approximateRate, std::uint32_t epoch,
+                               std::vector<event_t> &events) {
+    const auto &interactions = kernel->interactions();
+    const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+    auto &pool = kernel->pool();
+    const auto nThreads = pool.teamSize();
+    const auto nTypes = interactions.nTypes();
+    auto hasReactions = [&](const data_t::Entries::value_type &entry) {
+        return !entry.deactivated && !interactions.reactionsOrder1(entry.type).empty();
+    };
+
+    // counting sort of the particles with first order reactions by type: count per thread and type, turn the counts
+    // into write positions (type major, thread minor) and scatter, the particles of each type stay in index order
+    _positions.assign(nThreads * nTypes, 0);
+    pool.parallel_for(0, data.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+        auto *counts = _positions.data() + tid * nTypes;
+        for (auto i = begin; i < end; ++i) {
+            const auto &entry = data.entry_at(i);
+            if (hasReactions(entry)) ++counts[entry.type];
+        }
+    });
+    _offsets.assign(nTypes + 1, 0);
+    std::size_t offset = 0;
+    for (std::size_t type = 0; type < nTypes; ++type) {
+        _offsets[type] = offset;
+        for (std::size_t tid = 0; tid < nThreads; ++tid) {
+            const auto count = _positions[tid * nTypes + type];
+            _positions[tid * nTypes + type] = offset;
+            offset += count;
+        }
+    }
+    _offsets[nTypes] = offset;
+    _indices.resize(offset);
+    pool.parallel_for(0, data.size(), [&](std::size_t tid, std::size_t begin, std::size_t end) {
+        auto *positions = _positions.data() + tid * nTypes;
+        for (auto i = begin; i < end; ++i) {
+            const auto &entry = data.entry_at(i);
+            if (hasReactions(entry)) _indices[positions[entry.type]++] = i;
+        }
+    });
+
+    for (std::size_t type = 0; type < nTypes; ++type) {
+        const auto n = _offsets[type + 1] - _offsets[type];
+        if (n == 0) continue;
+        auto *particles = _indices.data() + _offsets[type];
+        const auto t = static_cast<ParticleTypeId>(type);
+        const auto &reactions = interactions.reactionsOrder1(t);
+        for (std::size_t r = 0; r < reactions.size(); ++r) {
+            const auto rate = reactions[r]->rate();
+            if (rate <= 0) continue;
+            const auto p = approximateRate ? std::min<scalar>(rate * timeStep, 1) : 1 - std::exp(-rate * timeStep);
+            readdy::model::rnd::CounterBasedStream stream(kernel->seed(), epoch, static_cast<std::uint32_t>(type),
+                                                          static_cast<std::uint32_t>(r));
+            const auto k = stream.binomial(n, p);
+            // partial Fisher-Yates shuffle, the first k particles of the type form a uniform sample
+            for (std::size_t j = 0; j < k; ++j) {
+                const auto pick = j + std::min(static_cast<std::size_t>(stream.uniform() * (n - j)), n - j - 1);
+                std::swap(particles[j], particles[pick]);
+                events.emplace_back(1, reactions[r]->nProducts(), particles[j], particles[j], rate, 0,
+                                    static_cast<event_t::reaction_index_type>(r), t, 0);
+            }
         }
     }
-    return std::make_pair(std::move(newParticles), std::move(decayedEntries));
 }
 }
 }
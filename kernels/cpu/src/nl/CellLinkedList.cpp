@@ -49,11 +49,14 @@ namespace readdy::kernel::cpu::nl {
 CellLinkedList::CellLinkedList(data_type &data, const readdy::model::Context &context, thread_pool &pool)
         : _data(data), _context(context), _pool(pool) {}
 
-void CellLinkedList::setUp(scalar cutoff, cell_radius_type radius) {
-    if (!_isSetUp || _cutoff != cutoff || _radius != radius) {
+void CellLinkedList::setUp(scalar cutoff, cell_radius_type radius, scalar skin) {
+    if (!_isSetUp || _cutoff != cutoff || _radius != radius || _skin != skin) {
         if (cutoff <= 0) {
             throw std::logic_error("The cutoff distance for setting up a neighbor list must be > 0");
         }
+        if (skin < 0) {
+            throw std::logic_error("The skin for setting up a neighbor list must be >= 0");
+        }
         if (cutoff < _context.get().calculateMaxCutoff()) {
             log::warn(fmt::format(
                     "The requested interaction distance {} for neighbor-list set-up was smaller than the largest cutoff {}",
@@ -61,9 +64,10 @@ void CellLinkedList::setUp(scalar cutoff, cell_radius_type radius) {
         }
         _radius = radius;
         _cutoff = cutoff;
+        _skin = skin;
 
         auto size = _context.get().boxSize();
-        auto desiredWidth = static_cast<scalar>((_cutoff) / static_cast<scalar>(radius));
+        auto desiredWidth = static_cast<scalar>((_cutoff + _skin) / static_cast<scalar>(radius));
         std::array<std::size_t, 3> dims{};
         for (int i = 0; i < 3; ++i) {
             dims[i] = static_cast<unsigned int>(std::max(1., std::floor(size[i] / desiredWidth)));
@@ -171,18 +175,8 @@ void CompactCellLinkedList::fillBins<true>() {
 
 template<>
 void CompactCellLinkedList::fillBins<false>() {
-    {/*
-        static int i = 0;
-        if(i % 100 == 0) {
-            _data.get().hilbertSort(_max_cutoff + _skin);
-            i = 0;
-        }
-        ++i;
-    */}
-
     const auto &boxSize = _context.get().boxSize();
     const auto &data = _data.get();
-    const auto grainSize = data.size() / _pool.get().size();
     const auto cellSize = _cellSize;
     const auto &cellIndex = _cellIndex;
 
@@ -217,19 +211,16 @@ void CompactCellLinkedList::fillBins<false>() {
         }
     };
 
-    std::vector<util::thread::joining_future<void>> futures;
-    futures.reserve(_pool.get().size());
-    auto it = 1_z;
-    for (auto i = 0_z; i < _pool.get().size() - 1; ++i) {
-        auto itNext = it + grainSize;
-        if(it != itNext) futures.emplace_back(_pool.get().push(worker, it, itNext));
-        it = itNext;
-    }
-    futures.emplace_back(_pool.get().push(worker, it, _data.get().size()+1));
+    // particle indices in the list are one-based
+    _pool.get().parallel_for(1, _data.get().size() + 1, worker);
 }
 
 void CompactCellLinkedList::setUpBins() {
     if (_isSetUp) {
+        if (_reorderInterval > 0 && ++_nBinFillsSinceReorder >= _reorderInterval) {
+            _data.get().reorder(_cellSize, _hilbertOrder);
+            _nBinFillsSinceReorder = 0;
+        }
         {
             auto nParticles = _data.get().size();
             _head.clear();
@@ -242,9 +233,129 @@ void CompactCellLinkedList::setUpBins() {
         } else {
             fillBins<false>();
         }
+        ++_binsVersion;
+        if (_verlet) {
+            fillVerletList();
+        }
     } else {
         throw std::logic_error("Attempting to fill neighborlist bins, but cell structure is not set up yet");
     }
 }
 
+void CompactCellLinkedList::fillVerletList() {
+    const auto &data = _data.get();
+    const auto &box = _context.get().boxSize();
+    const auto &pbc = _context.get().periodicBoundaryConditions();
+    const auto verletCutoffSquared = (_cutoff + _skin) * (_cutoff + _skin);
+    const auto nCells = _cellIndex.size();
+
+    _verletList.resize(data.size());
+    _verletReferencePositions.resize(data.size());
+
+    // only binned particles are ever queried, their lists and reference positions are reset by the thread filling them
+    auto worker = [this, &data, &box, &pbc, verletCutoffSquared](std::size_t, std::size_t cellBegin,
+                                                                 std::size_t cellEnd) {
+        for (auto cell = cellBegin; cell < cellEnd; ++cell) {
+            for (auto it = particlesBegin(cell); it != particlesEnd(cell); ++it) {
+                const auto pidx = *it;
+                const auto &pos = data.entry_at(pidx).pos;
+                _verletReferencePositions[pidx] = pos;
+                auto &neighbors = _verletList[pidx];
+                neighbors.clear();
+                auto collect = [&](std::size_t neighborIdx) {
+                    if (neighborIdx != pidx && bcs::distSquared(pos, data.entry_at(neighborIdx).pos,
+                                                                 box.data(), pbc.data()) < verletCutoffSquared) {
+                        neighbors.push_back(neighborIdx);
+                    }
+                };
+                std::for_each(particlesBegin(cell), particlesEnd(cell), collect);
+                for (auto itNeighCell = neighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+                    std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), collect);
+                }
+            }
+        }
+    };
+
+    if (_serial) {
+        worker(0, 0, nCells);
+    } else {
+        _pool.get().parallel_for_balanced(costBalancedChunks(thread_pool::chunksPerThread * _pool.get().teamSize()),
+                                          worker, "CompactCellLinkedList::fillVerletList");
+    }
+
+    _verletDataVersion = data.particleSetVersion();
+    ++_nVerletRebuilds;
+}
+
+const std::vector<std::size_t> &CompactCellLinkedList::costBalancedChunks(std::size_t nChunks) const {
+    const auto nCells = _cellIndex.size();
+    nChunks = std::max<std::size_t>(std::min(nChunks, nCells), 1);
+    if (_chunksVersion == _binsVersion && _chunks.size() == nChunks + 1) {
+        return _chunks;
+    }
+
+    std::vector<std::size_t> counts(nCells, 0);
+    for (std::size_t cell = 0; cell < nCells; ++cell) {
+        counts[cell] = static_cast<std::size_t>(std::distance(particlesBegin(cell), particlesEnd(cell)));
+    }
+    _cellCostPrefix.resize(nCells + 1);
+    _cellCostPrefix[0] = 0;
+    for (std::size_t cell = 0; cell < nCells; ++cell) {
+        auto nNeighborParticles = counts[cell];
+        for (auto itNeighCell = neighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+            nNeighborParticles += counts[*itNeighCell];
+        }
+        _cellCostPrefix[cell + 1] = _cellCostPrefix[cell] + counts[cell] * nNeighborParticles;
+    }
+
+    const auto totalCost = _cellCostPrefix.back();
+    _chunks.resize(nChunks + 1);
+    _chunks.front() = 0;
+    _chunks.back() = nCells;
+    for (std::size_t chunk = 1; chunk < nChunks; ++chunk) {
+        if (totalCost == 0) {
+            _chunks[chunk] = (nCells * chunk) / nChunks;
+        } else {
+            // first cell whose preceding cells carry at least chunk / nChunks of the total cost
+            const auto target = (totalCost * chunk) / nChunks;
+            const auto it = std::lower_bound(_cellCostPrefix.begin(), _cellCostPrefix.end(), target);
+            _chunks[chunk] = std::max(_chunks[chunk - 1],
+                                      static_cast<std::size_t>(std::distance(_cellCostPrefix.begin(), it)));
+        }
+    }
+    _chunksVersion = _binsVersion;
+    return _chunks;
+}
+
+bool CompactCellLinkedList::verletListInvalid() const {
+    const auto &data = _data.get();
+    if (data.particleSetVersion() != _verletDataVersion || data.size() != _verletReferencePositions.size()) {
+        return true;
+    }
+    const auto &box = _context.get().boxSize();
+    const auto &pbc = _context.get().periodicBoundaryConditions();
+    // the pair list stays valid as long as no particle moved farther than half the skin
+    const auto maxDisplacementSquared = .25 * _skin * _skin;
+    // largest squared displacement of a range, a chunk stops early once it exceeds the bound
+    auto displacement = [this, &data, &box, &pbc, maxDisplacementSquared](std::size_t, std::size_t begin,
+                                                                        std::size_t end) {
+        scalar chunkMax = 0;
+        for (auto i = begin; i < end; ++i) {
+            const auto &entry = data.entry_at(i);
+            if (!entry.deactivated) {
+                chunkMax = std::max(chunkMax, bcs::distSquared(entry.pos, _verletReferencePositions[i],
+                                                               box.data(), pbc.data()));
+                if (chunkMax > maxDisplacementSquared) break;
+            }
+        }
+        return chunkMax;
+    };
+    if (_serial) {
+        return displacement(0, 0, data.size()) > maxDisplacementSquared;
+    }
+    const auto maxOf = [](scalar lhs, scalar rhs) { return std::max(lhs, rhs); };
+    return _pool.get().parallel_reduce(0, data.size(), static_cast<scalar>(0), displacement, maxOf)
+           > maxDisplacementSquared;
+}
+
 }
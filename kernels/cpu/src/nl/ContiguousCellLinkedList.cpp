@@ -103,19 +103,7 @@ void ContiguousCellLinkedList::fillBins() {
             }
         };
 
-        auto &pool = _pool.get();
-        std::vector<util::thread::joining_future<void>> futures;
-        futures.reserve(pool.size());
-        const auto grainSize = data.size() / pool.size();
-        auto it = 0_z;
-        for (std::size_t i = 0; i < pool.size()-1; ++i) {
-            auto itNext = it + grainSize;
-            if(it != itNext) {
-                futures.emplace_back(pool.push(worker, it, itNext));
-            }
-            it = itNext;
-        }
-        if(it != data.size()) futures.emplace_back(pool.push(worker, it, data.size()));
+        _pool.get().parallel_for(0, data.size(), worker);
     }
 
 }
@@ -123,8 +111,6 @@ void ContiguousCellLinkedList::fillBins() {
 ContiguousCellLinkedList::count_type ContiguousCellLinkedList::getMaxCounts() {
     const auto &boxSize = _context.get().boxSize();
     const auto &data = _data.get();
-    auto &pool = _pool.get();
-    const auto grainSize = data.size() / pool.size();
     const auto cellSize = _cellSize;
     const auto &cellIndex = _cellIndex;
     auto nCells = cellIndex.size();
@@ -159,19 +145,7 @@ ContiguousCellLinkedList::count_type ContiguousCellLinkedList::getMaxCounts() {
 
         };
 
-        std::vector<util::thread::joining_future<void>> futures;
-        futures.reserve(pool.size());
-        auto it = 0_z;
-        for (std::size_t i = 0; i < pool.size()-1; ++i) {
-            auto itNext = it + grainSize;
-            if(it != itNext) {
-                futures.emplace_back(pool.push(worker, it, itNext));
-            }
-            it = itNext;
-        }
-        if(it != data.size()) {
-            futures.emplace_back(pool.push(worker, it, data.size()));
-        }
+        _pool.get().parallel_for(0, data.size(), worker);
     }
 
     auto maxCounts = *std::max_element(blockNParticles.begin(), blockNParticles.end(),
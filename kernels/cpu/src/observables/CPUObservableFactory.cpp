@@ -91,7 +91,7 @@ CPUObservableFactory::radialDistribution(Stride stride, std::vector<scalar> binB
                                          std::vector<std::string> typeCountFrom,
                                          std::vector<std::string> typeCountTo, scalar particleDensity,
                                          model::observables::ObservableFactory::ObsCallback <model::observables::RadialDistribution> callback) const {
-    auto obs = std::make_unique<model::observables::RadialDistribution>(
+    auto obs = std::make_unique<CPURadialDistribution>(
             kernel, stride, binBorders, typeCountFrom, typeCountTo, particleDensity
     );
     obs->setCallback(callback);
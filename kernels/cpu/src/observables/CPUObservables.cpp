@@ -42,9 +42,7 @@
  * @date 27.10.16
  */
 
-#include <future>
-
-#include <readdy/common/thread/scoped_async.h>
+#include <readdy/common/boundary_condition_operations.h>
 
 #include <readdy/kernel/cpu/observables/CPUObservables.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
@@ -83,23 +81,17 @@ CPUHistogramAlongAxis::CPUHistogramAlongAxis(CPUKernel *const kernel, unsigned i
 }
 
 void CPUHistogramAlongAxis::evaluate() {
-    using Iter = readdy::kernel::cpu::CPUStateModel::data_type::const_iterator;
-
-    std::fill(result.begin(), result.end(), 0);
-
-    const auto binBorders = this->binBorders;
-    const auto typesToCount = this->typesToCount;
+    const auto &binBorders = this->binBorders;
+    const auto &typesToCount = this->typesToCount;
     const auto resultSize = result.size();
     const auto axis = this->axis;
     const auto data = kernel->getCPUKernelStateModel().getParticleData();
 
-    std::vector<std::future<result_type>> updates;
-    updates.reserve(kernel->getNThreads());
-    auto worker = [binBorders, typesToCount, resultSize, data, axis](std::size_t, Iter from, Iter to, std::promise<result_type>& update) {
-        result_type resultUpdate;
-        resultUpdate.resize(resultSize);
-
-        for (auto it = from; it != to; ++it) {
+    // the partial histograms are added up in thread order
+    result = kernel->pool().parallel_reduce(0, data->size(), result_type(resultSize, 0), [&](
+            std::size_t, std::size_t begin, std::size_t end) {
+        result_type resultUpdate(resultSize, 0);
+        for (auto it = data->cbegin() + begin; it != data->cbegin() + end; ++it) {
             if (!it->deactivated && typesToCount.find(it->type) != typesToCount.end()) {
                 auto upperBound = std::upper_bound(binBorders.begin(), binBorders.end(), it->pos[axis]);
                 if (upperBound != binBorders.end()) {
@@ -110,39 +102,13 @@ void CPUHistogramAlongAxis::evaluate() {
                 }
             }
         }
-
-        update.set_value(std::move(resultUpdate));
-    };
-
-    {
-        const std::size_t grainSize = data->size() / kernel->getNThreads();
-
-        std::vector<std::promise<result_type>> promises;
-        promises.resize(kernel->getNThreads());
-
-        auto &pool = kernel->pool();
-
-        auto workIter = data->cbegin();
-        for (unsigned int i = 0; i < kernel->getNThreads() - 1; ++i) {
-            updates.push_back(promises.at(i).get_future());
-            pool.push(worker, workIter, workIter + grainSize, std::ref(promises.at(i)));
-            workIter += grainSize;
-        }
-        auto& promise = promises.back();
-        updates.push_back(promise.get_future());
-        pool.push(worker, workIter, data->cend(), std::ref(promise));
-
-
-        for (auto &update : updates) {
-            auto vec = std::move(update.get());
-            auto it1 = vec.begin();
-            auto it2 = result.begin();
-            for (; it1 != vec.end(); ++it1, ++it2) {
-                *it2 += *it1;
-            }
+        return resultUpdate;
+    }, [](result_type lhs, const result_type &rhs) {
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            lhs[i] += rhs[i];
         }
-
-    }
+        return lhs;
+    });
 }
 
 
@@ -220,6 +186,87 @@ void CPUParticles::evaluate() {
     }
 }
 
+CPURadialDistribution::CPURadialDistribution(CPUKernel *const kernel, Stride stride,
+                                             const std::vector<scalar> &binBorders,
+                                             const std::vector<std::string> &typeCountFrom,
+                                             const std::vector<std::string> &typeCountTo, scalar particleToDensity)
+        : RadialDistribution(kernel, stride, binBorders, typeCountFrom, typeCountTo, particleToDensity),
+          kernel(kernel) {}
+
+void CPURadialDistribution::evaluate() {
+    if (binBorders.size() <= 1) {
+        return;
+    }
+    static constexpr std::uint8_t from = 1, to = 2;
+    const auto &context = kernel->context();
+    typeMask.assign(context.particleTypes().nTypes(), 0);
+    for (auto type : typeCountFrom) {
+        typeMask.at(type) |= from;
+    }
+    for (auto type : typeCountTo) {
+        typeMask.at(type) |= to;
+    }
+
+    auto *data = kernel->getCPUKernelStateModel().getParticleData();
+    auto &pool = kernel->pool();
+    const auto nThreads = pool.teamSize();
+    const auto nBins = counts.size();
+
+    const auto nFromParticles = pool.parallel_reduce(
+            0, data->size(), std::size_t{0}, [&](std::size_t, std::size_t begin, std::size_t end) {
+                std::size_t n = 0;
+                for (auto i = begin; i < end; ++i) {
+                    const auto &entry = data->entry_at(i);
+                    if (!entry.deactivated && (typeMask[entry.type] & from)) {
+                        ++n;
+                    }
+                }
+                return n;
+            }, std::plus<std::size_t>());
+
+    if (!cellList) {
+        cellList = std::make_unique<nl::CompactCellLinkedList>(*data, context, pool);
+    }
+    // cells narrower than the largest interaction cutoff would only trigger the neighbor list's warning
+    cellList->setUp(std::max(binBorders.back(), context.calculateMaxCutoff()), 1);
+    cellList->update();
+
+    threadCounts.assign(nThreads * nBins, 0);
+    const auto &box = context.boxSize();
+    const auto &pbc = context.periodicBoundaryConditions();
+    const auto &nl = *cellList;
+    const auto &chunks = nl.costBalancedChunks(thread_pool::chunksPerThread * nThreads);
+    pool.parallel_for_balanced(chunks, [&](std::size_t tid, std::size_t begin, std::size_t end) {
+        auto *histogram = threadCounts.data() + tid * nBins;
+        for (auto cell = begin; cell < end; ++cell) {
+            for (auto it = nl.particlesBegin(cell); it != nl.particlesEnd(cell); ++it) {
+                const auto &entryFrom = data->entry_at(*it);
+                if (!(typeMask[entryFrom.type] & from)) {
+                    continue;
+                }
+                nl.forEachNeighbor(*it, cell, [&](std::size_t neighbor) {
+                    const auto &entryTo = data->entry_at(neighbor);
+                    if (typeMask[entryTo.type] & to) {
+                        const auto bin = binOf(std::sqrt(bcs::distSquared(entryFrom.pos, entryTo.pos, box, pbc)));
+                        if (bin < nBins) {
+                            ++histogram[bin];
+                        }
+                    }
+                });
+            }
+        }
+    });
+
+    for (std::size_t bin = 0; bin < nBins; ++bin) {
+        std::size_t count = 0;
+        for (std::size_t tid = 0; tid < nThreads; ++tid) {
+            count += threadCounts[tid * nBins + bin];
+        }
+        counts[bin] = static_cast<scalar>(count);
+    }
+    normalize(nFromParticles);
+}
+
 CPUReactions::CPUReactions(CPUKernel *const kernel, unsigned int stride)
         : Reactions(kernel, stride), kernel(kernel) {}
 
@@ -0,0 +1,357 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * << detailed description >>
+ *
+ * @file TestDataContainer.cpp
+ * @brief Tests for the cpu particle data containers
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#include <catch2/catch.hpp>
+
+#include <readdy/kernel/cpu/CPUKernel.h>
+#include <readdy/kernel/cpu/data/SoADataContainer.h>
+
+using namespace readdy;
+
+TEST_CASE("Test cpu structure of arrays data container", "[cpu]") {
+    model::Context context;
+    context.particleTypes().add("A", 1.);
+    context.particleTypes().add("B", 1.);
+    context.boxSize() = {{10, 10, 10}};
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    auto idA = context.particleTypes().idOf("A");
+    auto idB = context.particleTypes().idOf("B");
+
+    kernel::cpu::thread_pool pool (readdy_default_n_threads());
+    kernel::cpu::data::SoADataContainer data (context, pool);
+    data.enableArrays(true);
+
+    auto nParticles = 500;
+    for (int i = 0; i < nParticles; ++i) {
+        model::Particle particle(model::rnd::uniform_real<scalar>(-5, 5),
+                                 model::rnd::uniform_real<scalar>(-5, 5),
+                                 model::rnd::uniform_real<scalar>(-5, 5), i % 2 == 0 ? idA : idB);
+        data.addParticle(particle);
+    }
+
+    auto checkConsistent = [&]() {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            const auto &entry = data.entry_at(i);
+            REQUIRE(data.x()[i] == entry.pos.x);
+            REQUIRE(data.y()[i] == entry.pos.y);
+            REQUIRE(data.z()[i] == entry.pos.z);
+            REQUIRE(data.types()[i] == entry.type);
+            REQUIRE(data.active(i) == !entry.deactivated);
+        }
+    };
+
+    SECTION("Arrays mirror the entries") {
+        checkConsistent();
+    }
+
+    SECTION("Displacement and updates") {
+        data.displace(3, {.5, .5, .5});
+        data.removeEntry(7);
+        data.removeParticle(data.getParticle(70));
+        checkConsistent();
+        kernel::cpu::data::SoADataContainer::EntriesUpdate newEntries;
+        newEntries.emplace_back(model::Particle(0, 0, 0, idB));
+        data.update(std::make_tuple(std::move(newEntries), std::vector<std::size_t>{}));
+        checkConsistent();
+        REQUIRE(data.active(7) != data.active(70));
+    }
+
+    SECTION("Clear and disable") {
+        data.clear();
+        REQUIRE(data.activeMask().empty());
+        data.addParticle({0, 0, 0, idA});
+        checkConsistent();
+        data.enableArrays(false);
+        REQUIRE_FALSE(data.arraysEnabled());
+        REQUIRE(data.activeMask().empty());
+        data.removeEntry(0);
+        data.enableArrays(true);
+        checkConsistent();
+    }
+
+    SECTION("Scatter forces and positions") {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data.fx()[i] = static_cast<scalar>(i);
+            data.x()[i] = 0;
+        }
+        data.scatterForces();
+        data.scatterPositions();
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            REQUIRE(data.entry_at(i).force.x == static_cast<scalar>(i));
+            REQUIRE(data.entry_at(i).pos.x == 0);
+        }
+    }
+
+    SECTION("Lazy synchronization") {
+        data.x()[5] = 1;
+        data.fx()[5] = 2;
+        data.arrayPositionsChanged();
+        data.arrayForcesChanged();
+        // structural changes bring the entries up to date first
+        data.removeEntry(6);
+        data.addParticle({0, 0, 0, idA});
+        REQUIRE(data.entry_at(5).pos.x == 1);
+        REQUIRE(data.entry_at(5).force.x == 2);
+        checkConsistent();
+
+        data.invalidateArrays();
+        data.entry_at(5).pos.x = 3;
+        data.entry_at(5).type = idB;
+        data.syncArrays();
+        REQUIRE(data.x()[5] == 3);
+        checkConsistent();
+    }
+
+    SECTION("Reorder along a space filling curve") {
+        auto hilbert = GENERATE(true, false);
+        data.removeEntry(3);
+        data.removeEntry(42);
+        std::vector<ParticleId> ids;
+        for (const auto &entry : data) {
+            ids.push_back(entry.id);
+        }
+        std::vector<std::size_t> oldToNew;
+        auto connection = data.reorderSignal().connect_scoped([&](const auto &mapping) { oldToNew = mapping; });
+        data.reorder({1, 1, 1}, hilbert);
+
+        REQUIRE(data.size() == static_cast<std::size_t>(nParticles - 2));
+        REQUIRE(data.getNDeactivated() == 0);
+        REQUIRE(oldToNew.size() == static_cast<std::size_t>(nParticles));
+        REQUIRE(oldToNew[3] == kernel::cpu::data::SoADataContainer::removedIndex);
+        REQUIRE(oldToNew[42] == kernel::cpu::data::SoADataContainer::removedIndex);
+        for (std::size_t i = 0; i < oldToNew.size(); ++i) {
+            if (i != 3 && i != 42) {
+                REQUIRE(data.entry_at(oldToNew[i]).id == ids[i]);
+            }
+        }
+        checkConsistent();
+
+        // consecutive entries are ordered along the curve of their cells
+        auto curveIndex = [&](const Vec3 &pos) {
+            std::array<std::uint64_t, 3> cell {{static_cast<std::uint64_t>(pos.x + 5),
+                                                static_cast<std::uint64_t>(pos.y + 5),
+                                                static_cast<std::uint64_t>(pos.z + 5)}};
+            return hilbert ? util::sfc::hilbertIndex(cell, 4) : util::sfc::mortonIndex(cell, 4);
+        };
+        for (std::size_t i = 1; i < data.size(); ++i) {
+            REQUIRE(curveIndex(data.entry_at(i - 1).pos) <= curveIndex(data.entry_at(i).pos));
+        }
+    }
+}
+
+TEST_CASE("Test cpu integration on structure of arrays", "[cpu]") {
+    auto run = [](bool structureOfArrays) {
+        kernel::cpu::CPUKernel kernel;
+        auto &ctx = kernel.context();
+        ctx.boxSize() = {{10, 10, 10}};
+        ctx.periodicBoundaryConditions() = {{true, true, false}};
+        ctx.particleTypes().add("A", 1.);
+        ctx.particleTypes().add("B", .5);
+        ctx.potentials().addHarmonicRepulsion("A", "B", 1., 1.);
+        ctx.potentials().addHarmonicRepulsion("B", "B", 1., 1.5);
+        ctx.potentials().addBox("A", 1., {-4, -4, -4}, {8, 8, 8});
+        ctx.kernelConfiguration().cpu.seed = 1234;
+        ctx.kernelConfiguration().cpu.threadConfig.nThreads = 1;
+        ctx.kernelConfiguration().cpu.structureOfArrays = structureOfArrays;
+
+        model::rnd::seedThreadGenerator(42);
+        for (int i = 0; i < 300; ++i) {
+            kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                             model::rnd::uniform_real<scalar>(-5, 5),
+                                             model::rnd::uniform_real<scalar>(-5, 5),
+                                             ctx.particleTypes().idOf(i % 3 == 0 ? "A" : "B")});
+        }
+        kernel.initialize();
+        REQUIRE((kernel.getCPUKernelStateModel().getSoAParticleData() != nullptr) == structureOfArrays);
+        auto integrator = kernel.actions().eulerBDIntegrator(.01);
+        auto forces = kernel.actions().calculateForces();
+        kernel.actions().createNeighborList(ctx.calculateMaxCutoff())->perform();
+        auto updateNeighborList = kernel.actions().updateNeighborList();
+        forces->perform();
+        for (int step = 0; step < 20; ++step) {
+            integrator->perform();
+            if (step == 10) {
+                kernel.stateModel().removeParticle(kernel.stateModel().getParticles().front());
+            }
+            updateNeighborList->perform();
+            forces->perform();
+        }
+        std::vector<std::tuple<Vec3, Vec3>> result;
+        for (const auto &entry : *kernel.getCPUKernelStateModel().getParticleData()) {
+            if (!entry.deactivated) {
+                result.emplace_back(entry.pos, entry.force);
+            }
+        }
+        return std::make_tuple(result, kernel.stateModel().energy());
+    };
+    auto [entries, energyEntries] = run(false);
+    auto [arrays, energyArrays] = run(true);
+    REQUIRE(energyEntries == energyArrays);
+    REQUIRE(entries.size() == arrays.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        REQUIRE(std::get<0>(entries[i]) == std::get<0>(arrays[i]));
+        REQUIRE(std::get<1>(entries[i]) == std::get<1>(arrays[i]));
+    }
+}
+
+TEST_CASE("Test cpu particle reordering with topologies", "[cpu]") {
+    kernel::cpu::CPUKernel kernel;
+    auto &ctx = kernel.context();
+    ctx.boxSize() = {{10, 10, 10}};
+    ctx.periodicBoundaryConditions() = {{true, true, true}};
+    ctx.particleTypes().add("A", 1.);
+    ctx.particleTypes().add("T", 1., model::particleflavor::TOPOLOGY);
+    ctx.topologyRegistry().addType("chain");
+    ctx.topologyRegistry().configureBondPotential("T", "T", {10., 1.});
+    ctx.potentials().addHarmonicRepulsion("A", "A", 1., 1.);
+    ctx.kernelConfiguration().cpu.reorder.interval = 1;
+
+    auto idA = ctx.particleTypes().idOf("A");
+    auto idT = ctx.particleTypes().idOf("T");
+    for (int i = 0; i < 300; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-5, 5), idA});
+    }
+    auto top = kernel.stateModel().addTopology(ctx.topologyRegistry().idOf("chain"),
+                                               {{4, 4, 4, idT}, {-4, -4, -4, idT}, {0, 0, 0, idT}});
+    top->addEdge({0}, {1});
+    top->addEdge({1}, {2});
+    auto topParticlesBefore = top->fetchParticles();
+
+    kernel.initialize();
+    kernel.stateModel().initializeNeighborList(ctx.calculateMaxCutoff());
+    kernel.actions().calculateForces()->perform();
+    auto energyBefore = kernel.stateModel().energy();
+
+    // the next update reorders the particle data
+    kernel.stateModel().updateNeighborList();
+    auto topParticlesAfter = top->fetchParticles();
+    REQUIRE(topParticlesAfter.size() == topParticlesBefore.size());
+    for (std::size_t i = 0; i < topParticlesBefore.size(); ++i) {
+        REQUIRE(topParticlesAfter[i].id() == topParticlesBefore[i].id());
+        REQUIRE(topParticlesAfter[i].pos() == topParticlesBefore[i].pos());
+    }
+    const auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    for (auto particleIndex : top->particleIndices()) {
+        REQUIRE(data.entry_at(particleIndex).type == idT);
+    }
+    kernel.actions().calculateForces()->perform();
+    REQUIRE(kernel.stateModel().energy() == Approx(energyBefore));
+}
+
+TEST_CASE("Test cpu data container id lookup", "[cpu]") {
+    model::Context context;
+    context.particleTypes().add("A", 1.);
+    context.boxSize() = {{10, 10, 10}};
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    auto idA = context.particleTypes().idOf("A");
+
+    kernel::cpu::thread_pool pool (readdy_default_n_threads());
+    kernel::cpu::data::DefaultDataContainer data (context, pool);
+
+    std::vector<model::Particle> particles;
+    for (int i = 0; i < 100; ++i) {
+        particles.emplace_back(model::rnd::uniform_real<scalar>(-5, 5), model::rnd::uniform_real<scalar>(-5, 5),
+                               model::rnd::uniform_real<scalar>(-5, 5), idA);
+    }
+    data.addParticles(particles);
+
+    auto checkLookup = [&]() {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            const auto &entry = data.entry_at(i);
+            if (!entry.deactivated) {
+                REQUIRE(data.getIndexForId(entry.id) == i);
+            }
+        }
+    };
+    checkLookup();
+
+    // removal by id
+    data.removeParticle(particles[10]);
+    data.removeParticle(particles[20]);
+    REQUIRE(data.entry_at(10).deactivated);
+    REQUIRE(data.entry_at(20).deactivated);
+    REQUIRE_THROWS_AS(data.getIndexForId(particles[10].id()), std::out_of_range);
+    checkLookup();
+
+    // new entries fill the blanks and replace removed entries
+    kernel::cpu::data::DefaultDataContainer::EntriesUpdate newEntries;
+    newEntries.emplace_back(model::Particle(0, 0, 0, idA));
+    newEntries.emplace_back(model::Particle(1, 1, 1, idA));
+    newEntries.emplace_back(model::Particle(2, 2, 2, idA));
+    auto replacedId = data.entry_at(30).id;
+    auto newIndices = data.update(std::make_tuple(std::move(newEntries), std::vector<std::size_t>{30}));
+    REQUIRE(newIndices.front() == 30);
+    REQUIRE_THROWS_AS(data.getIndexForId(replacedId), std::out_of_range);
+    checkLookup();
+
+    // ids that are changed in place are found as well
+    data.reassignId(5, model::Particle::nextId());
+    REQUIRE(data.getIndexForId(data.entry_at(5).id) == 5);
+    REQUIRE_THROWS_AS(data.getIndexForId(particles[5].id()), std::out_of_range);
+
+    // concurrent lookups after in-place changes
+    data.reassignId(6, model::Particle::nextId());
+    data.reassignId(7, model::Particle::nextId());
+    std::vector<std::size_t> found(data.size(), 0);
+    pool.parallel_for(0, data.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            if (!data.entry_at(i).deactivated) {
+                found[i] = data.getIndexForId(data.entry_at(i).id);
+            }
+        }
+    });
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (!data.entry_at(i).deactivated) {
+            REQUIRE(found[i] == i);
+        }
+    }
+
+    data.removeEntry(50);
+    data.reorder({1, 1, 1}, true);
+    checkLookup();
+    REQUIRE_THROWS_AS(data.getIndexForId(particles[50].id()), std::out_of_range);
+}
@@ -45,7 +45,9 @@
  * @date 23.08.16
  */
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 
 #include <catch2/catch.hpp>
 
@@ -360,4 +362,175 @@ TEST_CASE("Test cpu neighbor list", "[cpu]") {
             reactionHandler->perform();
         }
     }
+    SECTION("Verlet list") {
+        auto &context = kernel->context();
+        context.particleTypes().add("Test", .01);
+        auto id = context.particleTypes().idOf("Test");
+        scalar cutoff = 1.5;
+        context.reactions().addFusion("Fusion", id, id, id, .001, cutoff);
+        context.boxSize() = {{8, 8, 8}};
+        context.periodicBoundaryConditions() = {{true, true, true}};
+        context.kernelConfiguration().cpu.neighborList.verletList = true;
+        context.kernelConfiguration().cpu.neighborList.skin = .5;
+
+        for (auto i = 0; i < 500; ++i) {
+            model::Particle particle(model::rnd::uniform_real<scalar>(-4, 4), model::rnd::uniform_real<scalar>(-4, 4),
+                                     model::rnd::uniform_real<scalar>(-4, 4), id);
+            kernel->stateModel().addParticle(particle);
+        }
+
+        kernel->initialize();
+        kernel->stateModel().initializeNeighborList(context.calculateMaxCutoff());
+
+        auto integrator = kernel->actions().eulerBDIntegrator(.01);
+        auto reactionHandler = kernel->actions().uncontrolledApproximation(.01);
+
+        const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+        const auto &neighborList = *kernel->getCPUKernelStateModel().getNeighborList();
+        REQUIRE(neighborList.verlet());
+        REQUIRE(neighborList.nVerletRebuilds() == 1);
+
+        auto nSteps = 20U;
+        for (auto t = 0U; t < nSteps; ++t) {
+            integrator->perform();
+            kernel->stateModel().updateNeighborList();
+
+            std::size_t ix1 = 0;
+            for (const auto &e1 : data) {
+                if (!e1.deactivated) {
+                    std::vector<std::size_t> neighbors;
+                    neighborList.forEachNeighbor(ix1, [&](auto neighborIdx) {
+                        REQUIRE_FALSE(data.entry_at(neighborIdx).deactivated);
+                        neighbors.push_back(neighborIdx);
+                    });
+                    std::size_t ix2 = 0;
+                    for (const auto &e2 : data) {
+                        if (ix1 != ix2 && !e2.deactivated && bcs::dist(e1.pos, e2.pos, context.boxSize(),
+                                context.periodicBoundaryConditions()) < cutoff) {
+                            REQUIRE(std::find(neighbors.begin(), neighbors.end(), ix2) != neighbors.end());
+                        }
+                        ++ix2;
+                    }
+                }
+                ++ix1;
+            }
+
+            reactionHandler->perform();
+            kernel->stateModel().updateNeighborList();
+        }
+        // with D=.01 and dt=.01 particles barely move, so the lists should mostly be reused
+        REQUIRE(neighborList.nVerletRebuilds() < nSteps / 2);
+    }
+    SECTION("Half shell traversal") {
+        auto &context = kernel->context();
+        context.particleTypes().add("Test", 1.);
+        auto id = context.particleTypes().idOf("Test");
+        scalar cutoff = 1.5;
+        context.potentials().addHarmonicRepulsion("Test", "Test", 1., cutoff);
+        context.boxSize() = {{8, 8, 8}};
+        context.periodicBoundaryConditions() = {{true, true, false}};
+
+        for (auto i = 0; i < 300; ++i) {
+            model::Particle particle(model::rnd::uniform_real<scalar>(-4, 4), model::rnd::uniform_real<scalar>(-4, 4),
+                                     model::rnd::uniform_real<scalar>(-4, 4), id);
+            kernel->stateModel().addParticle(particle);
+        }
+
+        kernel->initialize();
+        kernel->stateModel().initializeNeighborList(context.calculateMaxCutoff());
+
+        const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+        const auto &neighborList = *kernel->getCPUKernelStateModel().getNeighborList();
+
+        std::map<std::tuple<std::size_t, std::size_t>, std::size_t> visits;
+        for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+            for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+                auto particle = *it;
+                neighborList.forEachNeighborHalf(particle, cell, [&](auto neighbor) {
+                    ++visits[std::make_tuple(std::min(particle, neighbor), std::max(particle, neighbor))];
+                });
+            }
+        }
+        for (const auto &entry : visits) {
+            REQUIRE(entry.second == 1);
+        }
+        for (auto i = 0_z; i < data.size(); ++i) {
+            for (auto j = i + 1; j < data.size(); ++j) {
+                if (bcs::dist(data.entry_at(i).pos, data.entry_at(j).pos, context.boxSize(),
+                              context.periodicBoundaryConditions()) < cutoff) {
+                    REQUIRE(visits.find(std::make_tuple(i, j)) != visits.end());
+                }
+            }
+        }
+
+        // forces obtained from the half shell traversal obey Newton's third law
+        kernel->actions().calculateForces()->perform();
+        Vec3 totalForce {0, 0, 0};
+        for (const auto &entry : data) {
+            totalForce += entry.force;
+        }
+        REQUIRE(std::abs(totalForce.x) < 1e-8);
+        REQUIRE(std::abs(totalForce.y) < 1e-8);
+        REQUIRE(std::abs(totalForce.z) < 1e-8);
+    }
+
+    SECTION("Cost balanced chunks") {
+        auto &context = kernel->context();
+        context.particleTypes().add("Test", 1.);
+        auto id = context.particleTypes().idOf("Test");
+        context.potentials().addHarmonicRepulsion("Test", "Test", 1., 1.);
+        context.boxSize() = {{20, 20, 20}};
+        context.periodicBoundaryConditions() = {{true, true, true}};
+
+        // a dense cluster in one corner and a dilute gas elsewhere
+        for (auto i = 0; i < 500; ++i) {
+            kernel->stateModel().addParticle({model::rnd::uniform_real<scalar>(-10, -8),
+                                              model::rnd::uniform_real<scalar>(-10, -8),
+                                              model::rnd::uniform_real<scalar>(-10, -8), id});
+        }
+        for (auto i = 0; i < 100; ++i) {
+            kernel->stateModel().addParticle({model::rnd::uniform_real<scalar>(-10, 10),
+                                              model::rnd::uniform_real<scalar>(-10, 10),
+                                              model::rnd::uniform_real<scalar>(-10, 10), id});
+        }
+        kernel->initialize();
+        kernel->stateModel().initializeNeighborList(context.calculateMaxCutoff());
+        const auto &neighborList = *kernel->getCPUKernelStateModel().getNeighborList();
+
+        const auto &chunks = neighborList.costBalancedChunks(8);
+        REQUIRE(chunks.size() == 9);
+        REQUIRE(chunks.front() == 0);
+        REQUIRE(chunks.back() == neighborList.nCells());
+        REQUIRE(std::is_sorted(chunks.begin(), chunks.end()));
+        // the cluster occupies few cells, a uniform split would put it into a single chunk
+        REQUIRE(chunks[1] < neighborList.nCells() / 8);
+
+        // the force calculation over the chunks agrees with the serial evaluation
+        auto calculateForces = kernel->actions().calculateForces();
+        calculateForces->perform();
+        const auto energy = kernel->stateModel().energy();
+        std::vector<Vec3> forces;
+        for (const auto &entry : *kernel->getCPUKernelStateModel().getParticleData()) {
+            forces.push_back(entry.force);
+        }
+        auto requireForces = [&]() {
+            const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+            for (auto i = 0_z; i < data.size(); ++i) {
+                REQUIRE(data.entry_at(i).force.x == Approx(forces[i].x).margin(1e-10));
+                REQUIRE(data.entry_at(i).force.y == Approx(forces[i].y).margin(1e-10));
+                REQUIRE(data.entry_at(i).force.z == Approx(forces[i].z).margin(1e-10));
+            }
+        };
+        // the force buffers are reused and must not carry over contributions of the previous step
+        calculateForces->perform();
+        REQUIRE(kernel->stateModel().energy() == Approx(energy));
+        requireForces();
+
+        kernel->getCPUKernelStateModel().getNeighborList()->serial() = true;
+        kernel->pool().resize_wait(1);
+        kernel->stateModel().updateNeighborList();
+        calculateForces->perform();
+        REQUIRE(kernel->stateModel().energy() == Approx(energy));
+        requireForces();
+    }
 }
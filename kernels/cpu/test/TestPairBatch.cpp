@@ -0,0 +1,126 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * << detailed description >>
+ *
+ * @file TestPairBatch.cpp
+ * @brief Tests for the batched pair potential evaluation
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#include <catch2/catch.hpp>
+
+#include <readdy/model/Context.h>
+#include <readdy/common/boundary_condition_operations.h>
+#include <readdy/kernel/cpu/actions/PairBatch.h>
+#include <readdy/testing/Utils.h>
+
+using namespace readdy;
+
+TEST_CASE("Test cpu pair batch", "[cpu]") {
+    model::Context context;
+    context.particleTypes().add("A", 1.);
+    context.particleTypes().add("B", 1.);
+    context.particleTypes().add("C", 1.);
+    context.particleTypes().add("D", 1.);
+    context.boxSize() = {{5, 5, 5}};
+    context.periodicBoundaryConditions() = {{true, false, true}};
+    auto &potentials = context.potentials();
+    potentials.addHarmonicRepulsion("A", "A", 2., 1.5);
+    potentials.addLennardJones("A", "B", 12, 6, 2.5, true, 1., 1.);
+    potentials.addWeakInteractionPiecewiseHarmonic("A", "C", 3., 1., .5, 2.);
+
+    model::potentials::PairPotentialTable table(potentials, context.particleTypes());
+    kernel::cpu::actions::PairBatch<4> batch(table, context.boxSize(), context.periodicBoundaryConditions());
+
+    const auto &box = context.boxSize();
+    const auto &pbc = context.periodicBoundaryConditions();
+    auto randomPosition = [] {
+        return Vec3(model::rnd::uniform_real<scalar>(-2.5, 2.5), model::rnd::uniform_real<scalar>(-2.5, 2.5),
+                    model::rnd::uniform_real<scalar>(-2.5, 2.5));
+    };
+    std::vector<ParticleTypeId> types {context.particleTypes().idOf("A"), context.particleTypes().idOf("B"),
+                                       context.particleTypes().idOf("C"), context.particleTypes().idOf("D")};
+
+    for (int trial = 0; trial < 20; ++trial) {
+        Vec3 posI = randomPosition();
+        auto typeI = types[0];
+
+        std::size_t nNeighbors = 11;
+        std::vector<Vec3> positions;
+        std::vector<ParticleTypeId> neighborTypes;
+        for (std::size_t j = 0; j < nNeighbors; ++j) {
+            positions.push_back(randomPosition());
+            neighborTypes.push_back(types[j % types.size()]);
+        }
+
+        Vec3 forceI {0, 0, 0};
+        scalar energy {0};
+        Matrix33 virial {{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+        std::vector<Vec3> forceBuffer (nNeighbors, {0, 0, 0});
+        for (std::size_t j = 0; j < nNeighbors; ++j) {
+            if (batch.add(j, positions[j], neighborTypes[j])) {
+                batch.evaluate<true>(posI, typeI, forceI, forceBuffer, energy, virial);
+            }
+        }
+        if (!batch.empty()) {
+            batch.evaluate<true>(posI, typeI, forceI, forceBuffer, energy, virial);
+        }
+
+        Vec3 referenceForceI {0, 0, 0};
+        scalar referenceEnergy {0};
+        Matrix33 referenceVirial {{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+        for (std::size_t j = 0; j < nNeighbors; ++j) {
+            auto x_ij = bcs::shortestDifference(posI, positions[j], box, pbc);
+            Vec3 f {0, 0, 0};
+            for (const auto *potential : potentials.potentialsOf(typeI, neighborTypes[j])) {
+                if (x_ij * x_ij < potential->getCutoffRadiusSquared()) {
+                    potential->calculateForceAndEnergy(f, referenceEnergy, x_ij);
+                }
+            }
+            referenceForceI += f;
+            referenceVirial += math::outerProduct<Matrix33>(-1. * x_ij, f);
+            REQUIRE(readdy::testing::vec3eq(forceBuffer[j], -1. * f, 1e-8));
+        }
+        REQUIRE(readdy::testing::vec3eq(forceI, referenceForceI, 1e-8));
+        REQUIRE(energy == Approx(referenceEnergy).epsilon(1e-8));
+        for (std::size_t i = 0; i < 9; ++i) {
+            REQUIRE(virial.data()[i] == Approx(referenceVirial.data()[i]).epsilon(1e-8));
+        }
+    }
+}
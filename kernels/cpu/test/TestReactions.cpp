@@ -44,6 +44,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <set>
+
 #include <readdy/model/Kernel.h>
 #include <readdy/plugin/KernelProvider.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
@@ -352,3 +354,287 @@ TEST_CASE("Test cpu kernel reaction handling", "[cpu]") {
         }
     }
 }
+
+TEST_CASE("Test cpu interaction snapshot", "[cpu]") {
+    auto kernel = std::make_unique<readdy::kernel::cpu::CPUKernel>();
+    auto &ctx = kernel->context();
+    ctx.particleTypes().add("A", 1.);
+    ctx.particleTypes().add("B", 1.);
+    ctx.reactions().addFusion("fusion", "A", "B", "A", 1., 1.);
+    ctx.reactions().addDecay("decay", "B", 1.);
+    ctx.potentials().addBox("A", 1., {-1, -1, -1}, {2, 2, 2});
+
+    const auto &snapshot = kernel->interactions();
+    auto idA = ctx.particleTypes().idOf("A");
+    auto idB = ctx.particleTypes().idOf("B");
+    REQUIRE(snapshot.reactionsOrder2(idA, idB).size() == 1);
+    REQUIRE(snapshot.reactionsOrder2(idB, idA).size() == 1);
+    REQUIRE(snapshot.reactionsOrder2(idA, idA).empty());
+    REQUIRE(snapshot.reactionsOrder1(idB).size() == 1);
+    REQUIRE(snapshot.reactionsOrder1(idA).empty());
+    REQUIRE(snapshot.hasPotentialsOrder1());
+    REQUIRE(snapshot.potentialsOrder1(idA).size() == 1);
+    REQUIRE(snapshot.pairPotentials().empty());
+    REQUIRE_FALSE(snapshot.outdated(ctx));
+
+    ctx.potentials().addHarmonicRepulsion("A", "B", 1., 1.);
+    REQUIRE(snapshot.outdated(ctx));
+    REQUIRE_FALSE(kernel->interactions().pairPotentials().empty());
+    REQUIRE_FALSE(kernel->interactions().outdated(ctx));
+
+    // a replaced context with the same registry version counts is noticed as well
+    readdy::model::Context other;
+    other.particleTypes().add("A", 1.);
+    other.particleTypes().add("B", 1.);
+    other.reactions().addFusion("fusion", "A", "B", "A", 2., 1.);
+    other.reactions().addDecay("decay", "B", 1.);
+    other.potentials().addBox("A", 1., {-1, -1, -1}, {2, 2, 2});
+    other.potentials().addHarmonicRepulsion("A", "B", 1., 1.);
+    ctx = other;
+    REQUIRE(snapshot.outdated(ctx));
+    idA = ctx.particleTypes().idOf("A");
+    idB = ctx.particleTypes().idOf("B");
+    REQUIRE(kernel->interactions().reactionsOrder2(idA, idB).size() == 1);
+    REQUIRE(kernel->interactions().reactionsOrder2(idA, idB)[0]->rate() == 2.);
+}
+
+TEST_CASE("Test cpu uncontrolled approximation conflict resolution", "[cpu]") {
+    // all particles within reaction radius of each other and fusions that happen almost surely
+    readdy::kernel::cpu::CPUKernel kernel;
+    auto &ctx = kernel.context();
+    ctx.boxSize() = {{10, 10, 10}};
+    ctx.particleTypes().add("A", 1.);
+    ctx.particleTypes().add("B", 1.);
+    ctx.reactions().addFusion("fusion", "A", "A", "B", 1e6, 2.);
+    ctx.kernelConfiguration().cpu.threadConfig.nThreads = 4;
+    kernel.initialize();
+    const auto n = 101;
+    for (int i = 0; i < n; ++i) {
+        kernel.stateModel().addParticle({readdy::model::rnd::uniform_real<readdy::scalar>(-.5, .5),
+                                         readdy::model::rnd::uniform_real<readdy::scalar>(-.5, .5),
+                                         readdy::model::rnd::uniform_real<readdy::scalar>(-.5, .5),
+                                         ctx.particleTypes().idOf("A")});
+    }
+    kernel.initialize();
+    kernel.actions().createNeighborList(ctx.calculateMaxCutoff())->perform();
+    kernel.actions().updateNeighborList()->perform();
+    kernel.actions().uncontrolledApproximation(1.)->perform();
+
+    std::size_t nA = 0, nB = 0;
+    for (const auto &entry : *kernel.getCPUKernelStateModel().getParticleData()) {
+        if (!entry.deactivated) {
+            if (entry.type == ctx.particleTypes().idOf("A")) ++nA;
+            else ++nB;
+        }
+    }
+    // every particle took part in at most one reaction and the accepted events form a maximal matching
+    REQUIRE(nA + 2 * nB == n);
+    REQUIRE(nA == 1);
+}
+
+TEST_CASE("Test cpu gathering events in chunks", "[cpu]") {
+    readdy::kernel::cpu::CPUKernel kernel;
+    auto &ctx = kernel.context();
+    ctx.boxSize() = {{10, 10, 10}};
+    ctx.periodicBoundaryConditions() = {{true, true, true}};
+    ctx.particleTypes().add("A", 1.);
+    ctx.particleTypes().add("B", 1.);
+    ctx.reactions().addConversion("conversion", "A", "B", .1);
+    ctx.reactions().addFusion("fusion", "A", "B", "A", 2., 1.);
+    kernel.initialize();
+    for (int i = 0; i < 300; ++i) {
+        kernel.stateModel().addParticle({readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                         readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                         readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                         ctx.particleTypes().idOf(i % 2 == 0 ? "A" : "B")});
+    }
+    kernel.initialize();
+    kernel.actions().createNeighborList(ctx.calculateMaxCutoff())->perform();
+    kernel.actions().updateNeighborList()->perform();
+    const auto nl = kernel.getCPUKernelStateModel().getNeighborList();
+    const auto data = kernel.getCPUKernelStateModel().getParticleData();
+
+    readdy::scalar alpha = 0;
+    std::vector<reac::Event> events;
+    reac::gatherEvents(&kernel, readdy::util::range<reac::Event::index_type>(0, data->size()), nl, data, alpha, events);
+
+    // gathering the particle halves and the cell chunks one after another yields the same events
+    readdy::scalar chunkedAlpha = 0;
+    std::vector<reac::Event> chunkedEvents;
+    const auto half = data->size() / 2;
+    reac::gatherEvents(&kernel, readdy::util::range<reac::Event::index_type>(0, half), nl, data, chunkedAlpha,
+                       chunkedEvents, 0, 0);
+    reac::gatherEvents(&kernel, readdy::util::range<reac::Event::index_type>(half, data->size()), nl, data,
+                       chunkedAlpha, chunkedEvents, 0, 0);
+    const auto &chunks = nl->costBalancedChunks(5);
+    for (std::size_t i = 0; i + 1 < chunks.size(); ++i) {
+        reac::gatherEvents(&kernel, readdy::util::range<reac::Event::index_type>(0, 0), nl, data, chunkedAlpha,
+                           chunkedEvents, chunks[i], chunks[i + 1]);
+    }
+    REQUIRE(chunkedAlpha == Approx(alpha));
+    REQUIRE(chunkedEvents.size() == events.size());
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        REQUIRE(chunkedEvents[i].idx1 == events[i].idx1);
+        REQUIRE(chunkedEvents[i].idx2 == events[i].idx2);
+        REQUIRE(chunkedEvents[i].reactionIndex == events[i].reactionIndex);
+    }
+}
+
+TEST_CASE("Test cpu first order event sampling", "[cpu]") {
+    // samples the first order events of one step with the given number of threads
+    auto sample = [](std::uint32_t nThreads) {
+        readdy::kernel::cpu::CPUKernel kernel;
+        auto &ctx = kernel.context();
+        ctx.boxSize() = {{10, 10, 10}};
+        ctx.particleTypes().add("A", 1.);
+        ctx.particleTypes().add("B", 1.);
+        ctx.particleTypes().add("C", 1.);
+        ctx.reactions().addDecay("decay", "A", .1);
+        ctx.reactions().addConversion("conversion", "A", "B", .2);
+        ctx.kernelConfiguration().cpu.seed = 42;
+        ctx.kernelConfiguration().cpu.threadConfig.nThreads = static_cast<int>(nThreads);
+        kernel.initialize();
+        std::vector<readdy::model::Particle> particles;
+        for (int i = 0; i < 30000; ++i) {
+            particles.emplace_back(0, 0, 0, ctx.particleTypes().idOf(i % 3 == 0 ? "C" : "A"));
+        }
+        kernel.stateModel().addParticles(particles);
+        reac::FirstOrderSampler sampler;
+        std::vector<reac::Event> events;
+        sampler.sample(&kernel, .1, false, 7, events);
+
+        const auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+        for (const auto &event : events) {
+            REQUIRE(event.nEducts == 1);
+            REQUIRE(event.idx1 == event.idx2);
+            REQUIRE(data.entry_at(event.idx1).type == ctx.particleTypes().idOf("A"));
+            REQUIRE(event.t1 == ctx.particleTypes().idOf("A"));
+        }
+        return events;
+    };
+    auto events = sample(1);
+
+    // each reaction picks distinct particles, with a count that is binomially distributed
+    for (std::size_t reactionIndex : {0, 1}) {
+        std::set<reac::Event::index_type> particles;
+        for (const auto &event : events) {
+            if (event.reactionIndex == reactionIndex) {
+                REQUIRE(particles.insert(event.idx1).second);
+            }
+        }
+        const auto rate = reactionIndex == 0 ? .1 : .2;
+        const auto p = 1 - std::exp(-rate * .1);
+        const auto mean = 20000 * p;
+        const auto sigma = std::sqrt(20000 * p * (1 - p));
+        REQUIRE(std::abs(static_cast<double>(particles.size()) - mean) < 6 * sigma);
+    }
+
+    // the draws do not depend on the number of threads
+    auto parallelEvents = sample(4);
+    REQUIRE(parallelEvents.size() == events.size());
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        REQUIRE(parallelEvents[i].idx1 == events[i].idx1);
+        REQUIRE(parallelEvents[i].reactionIndex == events[i].reactionIndex);
+    }
+}
+
+TEST_CASE("Test cpu reproducible random numbers", "[cpu]") {
+    // runs the same seeded system with the given number of threads and returns the final particles, with their ids
+    // relative to the id counter at the start of the run
+    auto gillespie = GENERATE(false, true);
+    auto run = [gillespie](std::uint32_t nThreads) {
+        readdy::kernel::cpu::CPUKernel kernel;
+        auto &ctx = kernel.context();
+        ctx.boxSize() = {{10, 10, 10}};
+        ctx.periodicBoundaryConditions() = {{true, true, true}};
+        ctx.particleTypes().add("A", 1.);
+        ctx.particleTypes().add("B", .5);
+        ctx.reactions().addConversion("conversion", "A", "B", .1);
+        ctx.reactions().addFusion("fusion", "B", "B", "A", 1., 1.);
+        ctx.kernelConfiguration().cpu.seed = 1234;
+        ctx.kernelConfiguration().cpu.threadConfig.nThreads = static_cast<int>(nThreads);
+        kernel.initialize();
+
+        readdy::model::rnd::seedThreadGenerator(42);
+        const auto firstId = readdy::model::Particle::reserveIds(0);
+        for (int i = 0; i < 500; ++i) {
+            kernel.stateModel().addParticle({readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                             readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                             readdy::model::rnd::uniform_real<readdy::scalar>(-5, 5),
+                                             ctx.particleTypes().idOf("A")});
+        }
+        kernel.initialize();
+        auto integrator = kernel.actions().eulerBDIntegrator(.01);
+        std::unique_ptr<readdy::model::actions::TimeStepDependentAction> reactions;
+        if (gillespie) {
+            reactions = kernel.actions().gillespie(.01);
+        } else {
+            reactions = kernel.actions().uncontrolledApproximation(.01);
+        }
+        kernel.actions().createNeighborList(ctx.calculateMaxCutoff())->perform();
+        auto updateNeighborList = kernel.actions().updateNeighborList();
+        for (int step = 0; step < 50; ++step) {
+            integrator->perform();
+            updateNeighborList->perform();
+            reactions->perform();
+            updateNeighborList->perform();
+        }
+        std::vector<std::tuple<readdy::ParticleTypeId, readdy::Vec3, readdy::ParticleId>> result;
+        for (const auto &entry : *kernel.getCPUKernelStateModel().getParticleData()) {
+            if (!entry.deactivated) {
+                result.emplace_back(entry.type, entry.pos, entry.id - firstId);
+            }
+        }
+        return result;
+    };
+    auto serial = run(1);
+    auto parallel = run(4);
+    REQUIRE(serial.size() == parallel.size());
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        REQUIRE(std::get<0>(serial[i]) == std::get<0>(parallel[i]));
+        REQUIRE(std::get<1>(serial[i]) == std::get<1>(parallel[i]));
+        REQUIRE(std::get<2>(serial[i]) == std::get<2>(parallel[i]));
+    }
+}
+
+TEST_CASE("Test counter based random streams", "[cpu]") {
+    // known answers of Philox4x32-10 from the Random123 test vectors
+    auto zero = readdy::model::rnd::Philox4x32::generate({{0, 0, 0, 0}}, {{0, 0}});
+    REQUIRE(zero == readdy::model::rnd::Philox4x32::counter_type{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}});
+    auto pi = readdy::model::rnd::Philox4x32::generate({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                                                       {{0xa4093822, 0x299f31d0}});
+    REQUIRE(pi == readdy::model::rnd::Philox4x32::counter_type{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}});
+
+    readdy::model::rnd::CounterBasedStream stream1(7, 1, 2, 3), stream2(7, 1, 2, 3), other(7, 1, 2, 4);
+    for (int i = 0; i < 10; ++i) {
+        auto x = stream1.uniform();
+        REQUIRE(x == stream2.uniform());
+        REQUIRE(x > 0);
+        REQUIRE(x < 1);
+        REQUIRE(x != other.uniform());
+    }
+}
+
+TEST_CASE("Test binomial draws of counter based random streams", "[cpu]") {
+    using readdy::model::rnd::CounterBasedStream;
+    REQUIRE(CounterBasedStream(7, 1, 2, 3).binomial(0, .5) == 0);
+    REQUIRE(CounterBasedStream(7, 1, 2, 3).binomial(10, 0.) == 0);
+    REQUIRE(CounterBasedStream(7, 1, 2, 3).binomial(10, 1.) == 10);
+    REQUIRE(CounterBasedStream(7, 1, 2, 3).binomial(1000, .3) == CounterBasedStream(7, 1, 2, 3).binomial(1000, .3));
+
+    // inversion (small mode), BTRD (large mode) and the mirrored case p > 1/2
+    for (const auto &[n, p] : std::vector<std::tuple<std::size_t, double>>{{100, .02}, {1000, .3}, {200, .9}}) {
+        const std::size_t nDraws = 20000;
+        double mean = 0, meanSquared = 0;
+        for (std::size_t i = 0; i < nDraws; ++i) {
+            const auto k = CounterBasedStream(7, 5, static_cast<std::uint64_t>(i)).binomial(n, p);
+            REQUIRE(k <= n);
+            mean += static_cast<double>(k) / nDraws;
+            meanSquared += static_cast<double>(k * k) / nDraws;
+        }
+        const auto expectedMean = n * p;
+        const auto expectedVariance = n * p * (1 - p);
+        REQUIRE(std::abs(mean - expectedMean) < 5 * std::sqrt(expectedVariance / nDraws));
+        REQUIRE(std::abs((meanSquared - mean * mean) / expectedVariance - 1) < .05);
+    }
+}
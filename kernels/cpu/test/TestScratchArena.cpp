@@ -0,0 +1,119 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * << detailed description >>
+ *
+ * @file TestScratchArena.cpp
+ * @brief Tests for the arena allocator of the cpu actions' scratch buffers
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#include <catch2/catch.hpp>
+
+#include <readdy/common/algorithm.h>
+#include <readdy/kernel/cpu/ScratchArena.h>
+
+using namespace readdy;
+
+TEST_CASE("Test cpu scratch arena", "[cpu]") {
+    kernel::cpu::ScratchArena arena;
+
+    SECTION("Grows to the peak demand and stops allocating") {
+        auto step = [&]() {
+            auto scope = arena.scope();
+            std::pmr::vector<double> values(&arena);
+            for (int i = 0; i < 1000; ++i) {
+                values.push_back(i);
+            }
+            std::pmr::vector<char> flags(100, true, &arena);
+            REQUIRE(values.back() == 999.);
+            REQUIRE(flags.size() == 100);
+        };
+        step();
+        REQUIRE(arena.nOverflowAllocations() > 0);
+        REQUIRE(arena.used() == 0);
+        REQUIRE(arena.capacity() >= arena.peak());
+        const auto nOverflow = arena.nOverflowAllocations();
+        const auto capacity = arena.capacity();
+        for (int i = 0; i < 5; ++i) {
+            step();
+        }
+        REQUIRE(arena.nOverflowAllocations() == nOverflow);
+        REQUIRE(arena.capacity() == capacity);
+    }
+
+    SECTION("Nested scopes rewind to their mark") {
+        arena.reserve(1024);
+        auto outer = arena.scope();
+        auto *first = arena.allocate(16, 8);
+        const auto used = arena.used();
+        {
+            auto inner = arena.scope();
+            arena.allocate(256, 8);
+            REQUIRE(arena.used() > used);
+        }
+        REQUIRE(arena.used() == used);
+        auto *second = arena.allocate(16, 8);
+        REQUIRE(static_cast<std::byte *>(second) == static_cast<std::byte *>(first) + 16);
+    }
+
+    SECTION("Alignment is respected") {
+        auto scope = arena.scope();
+        arena.allocate(1, 1);
+        auto *ptr = arena.allocate(64, 64);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % 64 == 0);
+    }
+
+    SECTION("Indexed events with the arena") {
+        struct Event {
+            std::size_t idx1, idx2;
+            scalar rate;
+        };
+        std::vector<Event> events{{0, 1, 1.}, {1, 2, 1.}, {3, 4, 1.}};
+        std::vector<std::size_t> performed;
+        auto keys = [](const Event &event) {
+            return std::array<std::size_t, 2>{{event.idx1, event.idx2}};
+        };
+        auto scope = arena.scope();
+        algo::performEventsIndexed(&arena, events, [](const Event &) { return true; }, keys,
+                                   [&](const Event &event) { performed.push_back(event.idx1); });
+        // the event on (3, 4) is independent, out of the two others only one can be performed
+        REQUIRE(performed.size() == 2);
+        REQUIRE(std::count(performed.begin(), performed.end(), 3) == 1);
+    }
+}
@@ -187,8 +187,7 @@ public:
         return _data.get().entry_at(index).type;
     }
 
-    void toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                std::vector<std::size_t>::iterator end) const override;
+    [[nodiscard]] readdy::model::DenseParticleIndices denseParticleIndices() const override;
 
     void clear() override;
 
@@ -64,7 +64,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 
@@ -82,7 +82,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -96,7 +96,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -111,7 +111,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -129,7 +129,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -145,7 +145,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -162,7 +162,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -176,7 +176,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
@@ -190,7 +190,7 @@ public:
 protected:
     MPIKernel *kernel;
 
-    void append() override;
+    void write(result_type &snapshot, TimeStep t) override;
 
     void initializeDataSet(File &file, const std::string &dataSetName, Stride flushStride) override;
 };
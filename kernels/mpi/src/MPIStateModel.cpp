@@ -107,19 +107,9 @@ void MPIStateModel::resetReactionCounts() {
     }
 }
 
-void MPIStateModel::toDenseParticleIndices(
-        std::vector<std::size_t>::iterator begin,
-        std::vector<std::size_t>::iterator end) const {
+readdy::model::DenseParticleIndices MPIStateModel::denseParticleIndices() const {
     const auto &blanks = _data.get().blanks();
-    std::transform(begin, end, begin, [&blanks](const std::size_t &ix) {
-        auto result = ix;
-        for (auto blankIx : blanks) {
-            if (blankIx < ix) {
-                --result;
-            }
-        }
-        return result;
-    });
+    return {blanks.begin(), blanks.end()};
 }
 
 void MPIStateModel::clear() {
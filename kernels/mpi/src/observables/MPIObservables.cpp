@@ -66,9 +66,9 @@ void MPIVirial::evaluate() {
     }
 }
 
-void MPIVirial::append() {
+void MPIVirial::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Virial::append();
+        Virial::write(snapshot, t);
     }
 }
 
@@ -105,9 +105,9 @@ void MPIPositions::evaluate() {
     result = util::gatherObjects(result, 0, kernel->domain(), kernel->commUsedRanks());
 }
 
-void MPIPositions::append() {
+void MPIPositions::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Positions::append();
+        Positions::write(snapshot, t);
     }
 }
 
@@ -136,9 +136,9 @@ void MPIParticles::evaluate() {
     }
 }
 
-void MPIParticles::append() {
+void MPIParticles::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Particles::append();
+        Particles::write(snapshot, t);
     }
 }
 
@@ -176,9 +176,9 @@ void MPIHistogramAlongAxis::evaluate() {
     result = tmp;
 }
 
-void MPIHistogramAlongAxis::append() {
+void MPIHistogramAlongAxis::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        HistogramAlongAxis::append();
+        HistogramAlongAxis::write(snapshot, t);
     }
 }
 
@@ -231,9 +231,9 @@ void MPINParticles::evaluate() {
     result = tmp;
 }
 
-void MPINParticles::append() {
+void MPINParticles::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        NParticles::append();
+        NParticles::write(snapshot, t);
     }
 }
 
@@ -271,9 +271,9 @@ void MPIForces::evaluate() {
     result = util::gatherObjects(result, 0, kernel->domain(), kernel->commUsedRanks());
 }
 
-void MPIForces::append() {
+void MPIForces::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Forces::append();
+        Forces::write(snapshot, t);
     }
 }
 
@@ -293,9 +293,9 @@ void MPIReactions::evaluate() {
     result = util::gatherObjects(result, 0, kernel->domain(), kernel->commUsedRanks());
 }
 
-void MPIReactions::append() {
+void MPIReactions::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Reactions::append();
+        Reactions::write(snapshot, t);
     }
 }
 
@@ -340,9 +340,9 @@ void MPIReactionCounts::evaluate() {
     //std::get<2>(result) = kernel->getMPIKernelStateModel().structuralReactionCounts();
 }
 
-void MPIReactionCounts::append() {
+void MPIReactionCounts::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        ReactionCounts::append();
+        ReactionCounts::write(snapshot, t);
     }
 }
 
@@ -364,9 +364,9 @@ void MPIEnergy::evaluate() {
     result = tmp;
 }
 
-void MPIEnergy::append() {
+void MPIEnergy::write(result_type &snapshot, TimeStep t) {
     if (kernel->domain().isMasterRank()) {
-        Energy::append();
+        Energy::write(snapshot, t);
     }
 }
 
@@ -75,6 +75,21 @@ std::vector<readdy::model::Particle> SCPUStateModel::getParticles() const {
     return result;
 }
 
+void SCPUStateModel::trajectorySnapshot(const std::vector<readdy::model::ParticleFlavor> &flavors,
+                                        std::vector<readdy::model::observables::TrajectoryEntry> &entries) const {
+    entries.clear();
+    entries.reserve(particleData.size());
+    for (const auto &entry : particleData) {
+        if (!entry.is_deactivated()) {
+            auto &target = entries.emplace_back();
+            target.typeId = entry.type;
+            target.id = entry.id;
+            target.flavor = flavors[entry.type];
+            target.pos = entry.pos;
+        }
+    }
+}
+
 
 readdy::model::top::GraphTopology *const SCPUStateModel::addTopology(TopologyTypeId type, const std::vector<readdy::model::Particle> &particles) {
     std::vector<std::size_t> indices = particleData.addTopologyParticles(particles);
@@ -136,18 +151,9 @@ void SCPUStateModel::resetReactionCounts() {
     }
 }
 
-void SCPUStateModel::toDenseParticleIndices(std::vector<std::size_t>::iterator begin,
-                                            std::vector<std::size_t>::iterator end) const {
+readdy::model::DenseParticleIndices SCPUStateModel::denseParticleIndices() const {
     const auto &blanks = particleData.blanks();
-    std::transform(begin, end, begin, [&blanks](const std::size_t &ix) {
-        auto result = ix;
-        for(auto blankIx : blanks) {
-            if(blankIx < ix) {
-                --result;
-            }
-        }
-        return result;
-    });
+    return {blanks.begin(), blanks.end()};
 }
 
 void SCPUStateModel::clear() {
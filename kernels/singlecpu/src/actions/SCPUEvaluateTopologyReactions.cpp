@@ -103,8 +103,8 @@ void SCPUEvaluateTopologyReactions::perform() {
             auto shouldEval = [this](const TREvent &event) {
                 return performReactionEvent<false>(event.rate, _timeStep);
             };
-            auto depending = [this](const TREvent &e1, const TREvent &e2) {
-                return eventsDependent(e1, e2);
+            auto keys = [this](const TREvent &event) {
+                return eventKeys(event);
             };
 
             auto eval = [&](const TREvent &event) {
@@ -138,7 +138,7 @@ void SCPUEvaluateTopologyReactions::perform() {
                 }
             };
 
-            algo::performEvents(events, shouldEval, depending, eval);
+            algo::performEventsIndexed(events, shouldEval, keys, eval);
 
             if (!new_topologies.empty()) {
                 for (auto &&top : new_topologies) {
@@ -322,14 +322,17 @@ SCPUEvaluateTopologyReactions::topology_reaction_events SCPUEvaluateTopologyReac
     return events;
 }
 
-bool SCPUEvaluateTopologyReactions::eventsDependent(const SCPUEvaluateTopologyReactions::TREvent &evt1,
-                                                    const SCPUEvaluateTopologyReactions::TREvent &evt2) const {
-    if(evt1.topology_idx == evt2.topology_idx || evt1.topology_idx == evt2.topology_idx2) {
-        return true;
+std::array<std::size_t, 2>
+SCPUEvaluateTopologyReactions::eventKeys(const SCPUEvaluateTopologyReactions::TREvent &event) const {
+    // topologies get even keys, particles that are not part of a topology odd ones
+    const auto topologyKey = 2 * event.topology_idx;
+    if (!event.spatial) {
+        return {{topologyKey, topologyKey}};
     }
-    auto tpWithSameP = evt1.topology_idx2 < 0 && evt2.topology_idx2 < 0 && evt1.idx2 == evt2.idx2;
-    if(tpWithSameP) return true;
-    return evt1.topology_idx2 >= 0 && (evt1.topology_idx2 == evt2.topology_idx || evt1.topology_idx2 == evt2.topology_idx2);
+    if (event.topology_idx2 >= 0) {
+        return {{topologyKey, 2 * static_cast<std::size_t>(event.topology_idx2)}};
+    }
+    return {{topologyKey, 2 * static_cast<std::size_t>(event.idx2) + 1}};
 }
 
 void SCPUEvaluateTopologyReactions::handleTopologyTopologyReaction(SCPUStateModel::topology_ref &t1,
@@ -290,9 +290,8 @@ scpu_data::EntriesUpdate handleEventsGillespie(
                 return filterEventsInAdvance || shouldPerformEvent(event.rate, timeStep, approximateRate);
             };
 
-            auto depending = [&](const event_t &e1, const event_t &e2) {
-                return (e1.idx1 == e2.idx1 || (e2.nEducts == 2 && e1.idx1 == e2.idx2)
-                        || (e1.nEducts == 2 && (e1.idx2 == e2.idx1 || (e2.nEducts == 2 && e1.idx2 == e2.idx2))));
+            auto keys = [](const event_t &event) {
+                return std::array<std::size_t, 2>{{event.idx1, event.nEducts == 2 ? event.idx2 : event.idx1}};
             };
 
             auto eval = [&](const event_t &event) {
@@ -328,7 +327,7 @@ scpu_data::EntriesUpdate handleEventsGillespie(
                 }
             };
 
-            algo::performEvents(events, shouldEval, depending, eval);
+            algo::performEventsIndexed(events, shouldEval, keys, eval);
 
         }
     }
@@ -430,9 +429,8 @@ void SCPUDetailedBalance::perform() {
             return shouldPerformEvent(event.rate, timeStep(), approximateRate);
         };
 
-        auto depending = [&](const event_t &e1, const event_t &e2) {
-            return (e1.idx1 == e2.idx1 || (e2.nEducts == 2 && e1.idx1 == e2.idx2)
-                    || (e1.nEducts == 2 && (e1.idx2 == e2.idx1 || (e2.nEducts == 2 && e1.idx2 == e2.idx2))));
+        auto keys = [](const event_t &event) {
+            return std::array<std::size_t, 2>{{event.idx1, event.nEducts == 2 ? event.idx2 : event.idx1}};
         };
 
         auto eval = [&](const event_t &event) {
@@ -484,7 +482,8 @@ void SCPUDetailedBalance::perform() {
                         if (reaction->educts() == revReaction->lhsTypes) {
                             // forward
                             prefactor = revReaction->acceptancePrefactor;
-                        } else if (reaction->educts() == revReaction->lhsTypes) {
+                        } else if (reaction->educts() == revReaction->rhsTypes) {
+                            // backward
                             prefactor = 1. / revReaction->acceptancePrefactor;
                         }
                         boltzmannFactor = std::exp(-1. / ctx.kBT() * (stateModel.energy() - energyBefore));
@@ -548,7 +547,7 @@ void SCPUDetailedBalance::perform() {
         };
 
         calculateEnergies();
-        algo::performEvents(events, shouldEval, depending, eval);
+        algo::performEventsIndexed(events, shouldEval, keys, eval);
 
     }
 }
@@ -46,11 +46,41 @@ namespace readdy::conf {
 
 namespace cpu {
 void to_json(json &j, const NeighborList &nl) {
-    j = json{{"cll_radius", nl.cll_radius}};
+    j = json{{"cll_radius", nl.cll_radius},
+             {"verlet_list", nl.verletList},
+             {"skin", nl.skin}};
 }
 
 void from_json(const json &j, NeighborList &nl) {
     nl.cll_radius = j.at("cll_radius").get<std::uint8_t>();
+    if (j.find("verlet_list") != j.end()) {
+        nl.verletList = j.at("verlet_list").get<bool>();
+    } else {
+        nl.verletList = false;
+    }
+    if (j.find("skin") != j.end()) {
+        nl.skin = j.at("skin").get<scalar>();
+    } else {
+        nl.skin = 0;
+    }
+}
+
+void to_json(json &j, const Reorder &reorder) {
+    j = json{{"interval", reorder.interval},
+             {"hilbert", reorder.hilbert}};
+}
+
+void from_json(const json &j, Reorder &reorder) {
+    if (j.find("interval") != j.end()) {
+        reorder.interval = j.at("interval").get<std::size_t>();
+    } else {
+        reorder.interval = 0;
+    }
+    if (j.find("hilbert") != j.end()) {
+        reorder.hilbert = j.at("hilbert").get<bool>();
+    } else {
+        reorder.hilbert = true;
+    }
 }
 
 void to_json(json &j, const ThreadConfig &nl) {
@@ -67,7 +97,11 @@ void from_json(const json &j, ThreadConfig &nl) {
 
 void to_json(json &j, const Configuration &conf) {
     j = json {{"neighbor_list", conf.neighborList},
-              {"thread_config", conf.threadConfig}};
+              {"thread_config", conf.threadConfig},
+              {"reorder", conf.reorder},
+              {"seed", conf.seed},
+              {"sample_first_order_reactions", conf.sampleFirstOrderReactions},
+              {"structure_of_arrays", conf.structureOfArrays}};
 }
 
 void from_json(const json &j, Configuration &conf) {
@@ -81,6 +115,26 @@ void from_json(const json &j, Configuration &conf) {
     } else {
         conf.threadConfig = {};
     }
+    if (j.find("reorder") != j.end()) {
+        conf.reorder = j.at("reorder").get<Reorder>();
+    } else {
+        conf.reorder = {};
+    }
+    if (j.find("seed") != j.end()) {
+        conf.seed = j.at("seed").get<std::uint64_t>();
+    } else {
+        conf.seed = 0;
+    }
+    if (j.find("sample_first_order_reactions") != j.end()) {
+        conf.sampleFirstOrderReactions = j.at("sample_first_order_reactions").get<bool>();
+    } else {
+        conf.sampleFirstOrderReactions = false;
+    }
+    if (j.find("structure_of_arrays") != j.end()) {
+        conf.structureOfArrays = j.at("structure_of_arrays").get<bool>();
+    } else {
+        conf.structureOfArrays = false;
+    }
 }
 }
 
@@ -47,6 +47,7 @@ using Json = nlohmann::json;
 namespace readdy::util {
 
 std::unordered_map<std::string, PerformanceData> Timer::perf {};
+std::atomic<bool> Timer::detailed {false};
 
 void to_json(nlohmann::json &j, const PerformanceData &pd) {
     j = nlohmann::json{{"time",  pd.cumulativeTime()},
@@ -62,6 +63,10 @@ std::string Timer::perfToJsonString() {
     return j.dump();
 }
 
+const PerformanceData &Timer::performanceData(const std::string &targetName) {
+    return perf[targetName];
+}
+
 void Timer::clear() {
     perf.clear();
 }
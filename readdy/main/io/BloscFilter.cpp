@@ -59,8 +59,21 @@ void BloscFilter::activate(h5rd::PropertyList &plist) {
     unsigned int cd_values[7];
     // compression level 0-9 (0 no compression, 9 highest compression)
     cd_values[4] = compressionLevel;
-    // 0: shuffle not active, 1: shuffle active
-    cd_values[5] = shuffle ? 1 : 0;
+    // 0: shuffle not active, 1: byte shuffle active, 2: bit shuffle active
+    switch (shuffle) {
+        case NoShuffle: {
+            cd_values[5] = BLOSC_NOSHUFFLE;
+            break;
+        }
+        case ByteShuffle: {
+            cd_values[5] = BLOSC_SHUFFLE;
+            break;
+        }
+        case BitShuffle: {
+            cd_values[5] = BLOSC_BITSHUFFLE;
+            break;
+        }
+    }
     // the compressor to use
     switch (compressor) {
         case BloscLZ: {
@@ -104,8 +117,12 @@ void BloscFilter::registerFilter() {
     }
 }
 
-BloscFilter::BloscFilter(BloscFilter::Compressor compressor, unsigned int compressionLevel, bool shuffle) : compressor(
-        compressor), compressionLevel(compressionLevel), shuffle(shuffle) {
+BloscFilter::BloscFilter(BloscFilter::Compressor compressor, unsigned int compressionLevel, bool shuffle)
+        : BloscFilter(compressor, compressionLevel, shuffle ? ByteShuffle : NoShuffle) {}
+
+BloscFilter::BloscFilter(BloscFilter::Compressor compressor, unsigned int compressionLevel,
+                         BloscFilter::ShuffleMode shuffle)
+        : shuffle(shuffle), compressor(compressor), compressionLevel(compressionLevel) {
     if (compressionLevel > 9) {
         throw std::invalid_argument("Blosc only allows compression levels ranging from 0 to 9.");
     }
@@ -42,6 +42,8 @@
  * @todo make proper reference to KernelContext.h, is kBT really indepdendent of t?
  */
 
+#include <atomic>
+
 #include <readdy/model/Context.h>
 
 #include <readdy/api/KernelConfiguration.h>
@@ -149,7 +151,12 @@ void Context::setTypeRegistryReferences() {
     _topologyRegistry._types = &_particleTypeRegistry;
 }
 
-Context::Context() {
+std::uint64_t Context::nextGeneration() {
+    static std::atomic<std::uint64_t> generation{0};
+    return ++generation;
+}
+
+Context::Context() : _generation(nextGeneration()) {
     setTypeRegistryReferences();
 }
 
@@ -170,6 +177,8 @@ Context &Context::operator=(Context &&rhs) noexcept {
     _recordReactionsWithPositions = rhs._recordReactionsWithPositions;
     _recordReactionCounts = rhs._recordReactionCounts;
     _recordVirial = rhs._recordVirial;
+    _generation = nextGeneration();
+    rhs._generation = nextGeneration();
     setTypeRegistryReferences();
     return *this;
 }
@@ -188,6 +197,7 @@ Context &Context::operator=(const Context &rhs) {
         _recordReactionsWithPositions = rhs._recordReactionsWithPositions;
         _recordReactionCounts = rhs._recordReactionCounts;
         _recordVirial = rhs._recordVirial;
+        _generation = nextGeneration();
         setTypeRegistryReferences();
     }
     return *this;
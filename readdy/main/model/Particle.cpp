@@ -46,4 +46,14 @@ namespace readdy::model {
 
 std::atomic<ParticleId> Particle::idCounter{0};
 
+ParticleId Particle::nextThreadLocalId() {
+    thread_local ParticleId next {0};
+    thread_local ParticleId end {0};
+    if (next == end) {
+        next = reserveIds(idBlockSize);
+        end = next + idBlockSize;
+    }
+    return next++;
+}
+
 }
@@ -55,4 +55,18 @@ std::vector<Particle> StateModel::getParticlesForTopology(const top::GraphTopolo
     return result;
 }
 
+void StateModel::trajectorySnapshot(const std::vector<ParticleFlavor> &flavors,
+                                    std::vector<observables::TrajectoryEntry> &entries) const {
+    const auto particles = getParticles();
+    entries.resize(particles.size());
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        const auto &particle = particles[i];
+        auto &entry = entries[i];
+        entry.typeId = particle.type();
+        entry.id = particle.id();
+        entry.flavor = flavors.at(particle.type());
+        entry.pos = particle.pos();
+    }
+}
+
 }
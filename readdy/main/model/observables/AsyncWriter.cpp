@@ -0,0 +1,158 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ ********************************************************************/
+
+
+/**
+ * @file AsyncWriter.cpp
+ * @brief Implementation of the asynchronous observable writer
+ * @author clonker
+ * @date 16.10.26
+ * @copyright BSD-3
+ */
+
+#include <chrono>
+#include <algorithm>
+
+#include <readdy/common/logging.h>
+#include <readdy/model/observables/io/AsyncWriter.h>
+
+namespace readdy::model::observables::util {
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+double secondsSince(clock::time_point start) {
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+}
+
+AsyncWriter::AsyncWriter(std::size_t capacity) : _capacity(std::max<std::size_t>(capacity, 1)),
+                                                 _thread([this]() { run(); }) {}
+
+AsyncWriter::~AsyncWriter() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]() { return _queue.empty() && !_busy; });
+        _stop = true;
+    }
+    _notEmpty.notify_one();
+    _thread.join();
+    if (_error) {
+        try {
+            std::rethrow_exception(_error);
+        } catch (const std::exception &e) {
+            log::error("Asynchronous observable writer failed: {}", e.what());
+        } catch (...) {
+            log::error("Asynchronous observable writer failed");
+        }
+    }
+}
+
+void AsyncWriter::submit(Job job, std::size_t bytes) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        rethrow();
+        if (_queue.size() >= _capacity) {
+            const auto start = clock::now();
+            _notFull.wait(lock, [this]() { return _queue.size() < _capacity || _error; });
+            _statistics.waitTime += secondsSince(start);
+            rethrow();
+        }
+        _queue.emplace_back(std::move(job), bytes);
+    }
+    _notEmpty.notify_one();
+}
+
+void AsyncWriter::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_queue.empty() || _busy) {
+        const auto start = clock::now();
+        _idle.wait(lock, [this]() { return _queue.empty() && !_busy; });
+        _statistics.waitTime += secondsSince(start);
+    }
+    rethrow();
+}
+
+AsyncWriter::Statistics AsyncWriter::statistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void AsyncWriter::rethrow() {
+    if (_error) {
+        auto error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void AsyncWriter::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _notEmpty.wait(lock, [this]() { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+            // stop was requested and everything is written
+            return;
+        }
+        auto [job, bytes] = std::move(_queue.front());
+        _queue.pop_front();
+        _busy = true;
+        lock.unlock();
+        _notFull.notify_one();
+
+        const auto start = clock::now();
+        std::exception_ptr error {nullptr};
+        try {
+            job();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        const auto elapsed = secondsSince(start);
+
+        lock.lock();
+        _busy = false;
+        ++_statistics.nWrites;
+        _statistics.bytes += bytes;
+        _statistics.writeTime += elapsed;
+        if (error && !_error) {
+            _error = error;
+            _notFull.notify_all();
+        }
+        if (_queue.empty()) {
+            _idle.notify_all();
+        }
+    }
+}
+
+}
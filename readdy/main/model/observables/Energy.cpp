@@ -72,9 +72,9 @@ void Energy::initializeDataSet(File &file, const std::string &dataSetName, Strid
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void Energy::append() {
-    pimpl->ds->append({1}, &result);
-    pimpl->time->append(t_current);
+void Energy::write(result_type &snapshot, TimeStep t) {
+    pimpl->ds->append({1}, &snapshot);
+    pimpl->time->append(t);
 }
 
 void Energy::evaluate() {
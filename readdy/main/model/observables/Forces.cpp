@@ -85,9 +85,9 @@ void Forces::initializeDataSet(File &file, const std::string &dataSetName, unsig
     pimpl->timeSeries = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void Forces::append() {
-    pimpl->dataSet->append({1}, &result);
-    pimpl->timeSeries->append(t_current);
+void Forces::write(result_type &snapshot, TimeStep t) {
+    pimpl->dataSet->append({1}, &snapshot);
+    pimpl->timeSeries->append(t);
 }
 
 constexpr static auto& t = "Forces";
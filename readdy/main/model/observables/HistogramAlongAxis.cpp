@@ -89,9 +89,9 @@ void HistogramAlongAxis::initializeDataSet(File &file, const std::string &dataSe
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void HistogramAlongAxis::append() {
-    pimpl->dataSet->append({1, result.size()}, result.data());
-    pimpl->time->append(t_current);
+void HistogramAlongAxis::write(result_type &snapshot, TimeStep t) {
+    pimpl->dataSet->append({1, snapshot.size()}, snapshot.data());
+    pimpl->time->append(t);
 }
 
 void HistogramAlongAxis::flush() {
@@ -84,9 +84,9 @@ void NParticles::initializeDataSet(File &file, const std::string &dataSetName, S
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void NParticles::append() {
-    pimpl->ds->append({1, result.size()}, result.data());
-    pimpl->time->append(t_current);
+void NParticles::write(result_type &snapshot, TimeStep t) {
+    pimpl->ds->append({1, snapshot.size()}, snapshot.data());
+    pimpl->time->append(t);
 }
 
 void NParticles::flush() {
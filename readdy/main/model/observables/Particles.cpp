@@ -72,23 +72,23 @@ void Particles::initializeDataSet(File &file, const std::string &dataSetName, St
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void Particles::append() {
+void Particles::write(result_type &snapshot, TimeStep t) {
     {
-        auto &types = std::get<0>(result);
+        auto &types = std::get<0>(snapshot);
         log::debug("appending {} types ", types.size());
-        for(auto t : types) {
-            log::debug("    -> {}", t);
+        for(auto type : types) {
+            log::debug("    -> {}", type);
         }
         pimpl->dataSetTypes->append({1}, &types);
     }
     {
-        auto &ids = std::get<1>(result);
+        auto &ids = std::get<1>(snapshot);
         pimpl->dataSetIds->append({1}, &ids);
     }
     {
-        pimpl->dataSetPositions->append({1}, &std::get<2>(result));
+        pimpl->dataSetPositions->append({1}, &std::get<2>(snapshot));
     }
-    pimpl->time->append(t_current);
+    pimpl->time->append(t);
 }
 
 void Particles::flush() {
@@ -68,10 +68,10 @@ Positions::Positions(Kernel *const kernel, Stride stride,
                      std::vector<ParticleTypeId> typesToCount) :
         Observable(kernel, stride), typesToCount(std::move(typesToCount)), pimpl(std::make_unique<Impl>()) {}
 
-void Positions::append() {
-    std::vector<Vec3> podVec(result.begin(), result.end());
+void Positions::write(result_type &snapshot, TimeStep t) {
+    std::vector<Vec3> podVec(snapshot.begin(), snapshot.end());
     pimpl->writer->append({1}, &podVec);
-    pimpl->time->append(t_current);
+    pimpl->time->append(t);
 }
 
 Positions::Positions(Kernel *const kernel, Stride stride) : Observable(kernel, stride) {}
@@ -91,34 +91,36 @@ void RadialDistribution::evaluate() {
                     for (auto &&pTo : particles) {
                         if (isInCollection(pTo, typeCountTo) && pFrom.id() != pTo.id()) {
                             const auto dist = sqrt(bcs::distSquared(pFrom.pos(), pTo.pos(), box, pbc));
-                            auto upperBound = std::upper_bound(binBorders.begin(), binBorders.end(), dist);
-                            if (upperBound != binBorders.end()) {
-                                const auto binBordersIdx = upperBound - binBorders.begin();
-                                counts[binBordersIdx - 1]++;
+                            const auto bin = binOf(dist);
+                            if (bin < counts.size()) {
+                                counts[bin]++;
                             }
                         }
                     }
                 }
             }
         }
+        normalize(static_cast<std::size_t>(nFromParticles));
+    }
+}
 
-        auto &radialDistribution = std::get<1>(result);
-        {
-            const auto &binCenters = std::get<0>(result);
-            auto &&it_centers = binCenters.begin();
-            auto &&it_distribution = radialDistribution.begin();
-            for (auto &&it_counts = counts.begin(); it_counts != counts.end(); ++it_counts) {
-                const auto idx = it_centers - binCenters.begin();
-                const auto lowerRadius = binBorders[idx];
-                const auto upperRadius = binBorders[idx + 1];
-                *it_distribution =
-                        (*it_counts) /
-                        (4. / 3. * readdy::util::numeric::pi<scalar>() * (std::pow(upperRadius, 3.)
-                                                                       - std::pow(lowerRadius, 3.))
-                         * nFromParticles * particleToDensity);
-                ++it_distribution;
-                ++it_centers;
-            }
+void RadialDistribution::normalize(std::size_t nFromParticles) {
+    auto &radialDistribution = std::get<1>(result);
+    {
+        const auto &binCenters = std::get<0>(result);
+        auto &&it_centers = binCenters.begin();
+        auto &&it_distribution = radialDistribution.begin();
+        for (auto &&it_counts = counts.begin(); it_counts != counts.end(); ++it_counts) {
+            const auto idx = it_centers - binCenters.begin();
+            const auto lowerRadius = binBorders[idx];
+            const auto upperRadius = binBorders[idx + 1];
+            *it_distribution =
+                    (*it_counts) /
+                    (4. / 3. * readdy::util::numeric::pi<scalar>() * (std::pow(upperRadius, 3.)
+                                                                   - std::pow(lowerRadius, 3.))
+                     * nFromParticles * particleToDensity);
+            ++it_distribution;
+            ++it_centers;
         }
     }
 }
@@ -142,6 +144,12 @@ void RadialDistribution::setBinBorders(const std::vector<scalar> &binBorders) {
             ++it_begin;
             ++it_begin_next;
         }
+        binWidth = (binBorders.back() - binBorders.front()) / static_cast<scalar>(nCenters);
+        uniformBins = binWidth > 0;
+        for (std::size_t i = 0; i < nCenters && uniformBins; ++i) {
+            const auto width = binBorders[i + 1] - binBorders[i];
+            uniformBins = std::abs(width - binWidth) <= 1e-9 * binWidth;
+        }
     } else {
         log::warn("Argument bin borders' size should be at least two to make sense.");
     }
@@ -169,10 +177,10 @@ void RadialDistribution::initializeDataSet(File &file, const std::string &dataSe
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void RadialDistribution::append() {
-    auto &dist = std::get<1>(result);
+void RadialDistribution::write(result_type &snapshot, TimeStep t) {
+    auto &dist = std::get<1>(snapshot);
     pimpl->writerRadialDistribution->append({1, dist.size()}, dist.data());
-    pimpl->time->append(t_current);
+    pimpl->time->append(t);
 }
 
 void RadialDistribution::flush() {
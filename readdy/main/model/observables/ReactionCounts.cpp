@@ -90,8 +90,8 @@ void ReactionCounts::initializeDataSet(File &file, const std::string &dataSetNam
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(*pimpl->group, flushStride);
 }
 
-void ReactionCounts::append() {
-    const auto &[reactionCounts, spatialReactionCounts, structuralReactionCounts] = result;
+void ReactionCounts::write(result_type &snapshot, TimeStep t) {
+    const auto &[reactionCounts, spatialReactionCounts, structuralReactionCounts] = snapshot;
 
     if (pimpl->firstWrite) {
         pimpl->firstWrite = false;
@@ -150,7 +150,7 @@ void ReactionCounts::append() {
     for(const auto [id, count] : structuralReactionCounts) {
         pimpl->structuralReactionsDataSets.at(id)->append({1}, &count);
     }
-    pimpl->time->append(t_current);
+    pimpl->time->append(t);
 }
 
 constexpr static auto& t = "ReactionCounts";
@@ -80,9 +80,9 @@ void Reactions::initializeDataSet(File &file, const std::string &dataSetName, St
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(*pimpl->group, flushStride);
 }
 
-void Reactions::append() {
-    pimpl->writer->append({1}, &result);
-    pimpl->time->append(t_current);
+void Reactions::write(result_type &snapshot, TimeStep t) {
+    pimpl->writer->append({1}, &snapshot);
+    pimpl->time->append(t);
 }
 
 void Reactions::initialize(Kernel *const kernel) {
@@ -60,6 +60,8 @@ Topologies::Topologies(Kernel *kernel, Stride stride, bool useBlosc)
 
 void Topologies::evaluate() {
     result.clear();
+    // built once and shared by all topologies
+    const auto denseIndices = kernel->stateModel().denseParticleIndices();
     for (auto topologyPtr : kernel->stateModel().getTopologies()) {
         top::TopologyRecord record;
 
@@ -68,7 +70,7 @@ void Topologies::evaluate() {
         for(const auto& v : topologyPtr->graph().vertices()) {
             if(!v.deactivated()) record.particleIndices.push_back(v->particleIndex);
         }
-        kernel->stateModel().toDenseParticleIndices(record.particleIndices.begin(), record.particleIndices.end());
+        denseIndices.apply(record.particleIndices.begin(), record.particleIndices.end());
 
         for (auto [e1, e2] : topologyPtr->graph().edges()) {
             auto itE1 = topologyPtr->graph().vertices().cpersistent_to_active_iterator(topologyPtr->graph().vertices().begin_persistent() + e1.value);
@@ -127,26 +129,26 @@ void Topologies::initializeDataSet(File &file, const std::string &dataSetName, S
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride, "time", useBlosc);
 }
 
-void Topologies::append() {
+void Topologies::write(result_type &snapshot, TimeStep t) {
     std::size_t totalNParticles{0}, totalNEdges{0};
-    for (const auto &record : result) {
+    for (const auto &record : snapshot) {
         totalNParticles += record.particleIndices.size();
         totalNEdges += record.edges.size();
     }
     // advance limits by total number of particles in all topologies + #topologies for the prefix
     pimpl->currentLimitsParticles[0] = pimpl->currentLimitsParticles[1];
-    pimpl->currentLimitsParticles[1] += totalNParticles + result.size();
+    pimpl->currentLimitsParticles[1] += totalNParticles + snapshot.size();
 
     // advance limits by total number of edges in all topologies + #topologies for the prefix
     pimpl->currentLimitsEdges[0] = pimpl->currentLimitsEdges[1];
-    pimpl->currentLimitsEdges[1] += totalNEdges + result.size();
+    pimpl->currentLimitsEdges[1] += totalNEdges + snapshot.size();
 
     std::vector<std::size_t> flatParticles;
-    flatParticles.reserve(totalNParticles + result.size());
+    flatParticles.reserve(totalNParticles + snapshot.size());
     std::vector<std::array<std::size_t, 2>> flatEdges;
-    flatEdges.reserve(totalNEdges + result.size());
+    flatEdges.reserve(totalNEdges + snapshot.size());
 
-    for (const auto &r : result) {
+    for (const auto &r : snapshot) {
         flatParticles.push_back(r.particleIndices.size());
         flatParticles.insert(std::end(flatParticles), std::begin(r.particleIndices), std::end(r.particleIndices));
         flatEdges.push_back(std::array<std::size_t, 2>{{r.edges.size(), 0}});
@@ -159,12 +161,13 @@ void Topologies::append() {
     pimpl->limitsParticles->append({1, 2}, pimpl->currentLimitsParticles.data());
     pimpl->dataSetEdges->append({flatEdges.size(), 2}, &flatEdges[0][0]);
     pimpl->limitsEdges->append({1, 2}, pimpl->currentLimitsEdges.data());
-    pimpl->time->append(t_current);
+    pimpl->time->append(t);
 
     {
         std::vector<TopologyTypeId> types;
-        types.reserve(result.size());
-        std::transform(result.begin(), result.end(), std::back_inserter(types), [](const auto &r) { return r.type; });
+        types.reserve(snapshot.size());
+        std::transform(snapshot.begin(), snapshot.end(), std::back_inserter(types),
+                       [](const auto &r) { return r.type; });
         pimpl->types->append({1}, &types);
     }
 }
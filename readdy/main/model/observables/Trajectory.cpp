@@ -47,13 +47,25 @@
 #include <readdy/model/observables/io/Trajectory.h>
 #include <readdy/model/observables/io/TimeSeriesWriter.h>
 #include <readdy/model/observables/io/Types.h>
+#include <readdy/model/observables/io/CompactTrajectoryCodec.h>
 
 namespace readdy::model::observables {
 
+namespace {
+// the flavor table only grows with the particle types, it is rebuilt if types were added
+const std::vector<ParticleFlavor> &flavorTable(std::vector<ParticleFlavor> &flavors, const Context &context) {
+    if (flavors.size() != context.particleTypes().nTypes()) {
+        flavors = context.particleTypes().flavors();
+    }
+    return flavors;
+}
+}
+
 struct Trajectory::Impl {
     std::unique_ptr<h5rd::VLENDataSet> dataSet {nullptr};
     std::unique_ptr<util::TimeSeriesWriter> time {nullptr};
     std::unique_ptr<util::CompoundH5Types> h5types {nullptr};
+    std::vector<ParticleFlavor> flavors {};
 };
 
 
@@ -62,11 +74,7 @@ Trajectory::Trajectory(readdy::model::Kernel *const kernel, unsigned int stride)
 }
 
 void Trajectory::evaluate() {
-    result.clear();
-    const auto &currentInput = kernel->stateModel().getParticles();
-    std::for_each(currentInput.begin(), currentInput.end(), [this](const Particle &p) {
-        result.emplace_back(p, kernel->context().particleTypes());
-    });
+    kernel->stateModel().trajectorySnapshot(flavorTable(pimpl->flavors, kernel->context()), result);
 }
 
 void Trajectory::flush() {
@@ -87,9 +95,9 @@ void Trajectory::initializeDataSet(File &file, const std::string &dataSetName, u
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void Trajectory::append() {
-    pimpl->dataSet->append({1}, &result);
-    pimpl->time->append(t_current);
+void Trajectory::write(result_type &snapshot, TimeStep t) {
+    pimpl->dataSet->append({1}, &snapshot);
+    pimpl->time->append(t);
 }
 
 static constexpr auto& tTraj = "Trajectory";
@@ -104,6 +112,7 @@ struct FlatTrajectory::Impl {
     std::unique_ptr<util::TimeSeriesWriter> time {nullptr};
     std::unique_ptr<util::CompoundH5Types> h5types {nullptr};
     std::size_t current_limits[2]{0, 0};
+    std::vector<ParticleFlavor> flavors {};
 };
 
 FlatTrajectory::FlatTrajectory(Kernel *const kernel, unsigned int stride, bool useBlosc)
@@ -134,11 +143,7 @@ void FlatTrajectory::initializeDataSet(File &file, const std::string &dataSetNam
 }
 
 void FlatTrajectory::evaluate() {
-    result.clear();
-    const auto &currentInput = kernel->stateModel().getParticles();
-    std::for_each(currentInput.begin(), currentInput.end(), [this](const Particle &p) {
-        result.emplace_back(p, kernel->context().particleTypes());
-    });
+    kernel->stateModel().trajectorySnapshot(flavorTable(pimpl->flavors, kernel->context()), result);
 }
 
 void FlatTrajectory::flush() {
@@ -147,11 +152,11 @@ void FlatTrajectory::flush() {
     if (pimpl->limits) pimpl->limits->flush();
 }
 
-void FlatTrajectory::append() {
+void FlatTrajectory::write(result_type &snapshot, TimeStep t) {
     pimpl->current_limits[0] = pimpl->current_limits[1];
-    pimpl->current_limits[1] += result.size();
-    pimpl->dataSet->append({result.size()}, result.data());
-    pimpl->time->append(t_current);
+    pimpl->current_limits[1] += snapshot.size();
+    pimpl->dataSet->append({snapshot.size()}, snapshot.data());
+    pimpl->time->append(t);
     pimpl->limits->append({1, 2}, pimpl->current_limits);
 }
 
@@ -166,4 +171,142 @@ FlatTrajectory::FlatTrajectory(FlatTrajectory &&) noexcept = default;
 FlatTrajectory::~FlatTrajectory() {
     flush();
 };
+
+struct CompactTrajectory::Impl {
+    std::unique_ptr<h5rd::DataSet> positions {nullptr};
+    std::unique_ptr<h5rd::DataSet> limits {nullptr};
+    std::unique_ptr<h5rd::DataSet> ids {nullptr};
+    std::unique_ptr<h5rd::DataSet> types {nullptr};
+    std::unique_ptr<h5rd::DataSet> setLimits {nullptr};
+    std::unique_ptr<h5rd::DataSet> removed {nullptr};
+    std::unique_ptr<h5rd::DataSet> removedLimits {nullptr};
+    std::unique_ptr<h5rd::DataSet> changed {nullptr};
+    std::unique_ptr<h5rd::DataSet> changedTypes {nullptr};
+    std::unique_ptr<h5rd::DataSet> changedLimits {nullptr};
+    std::unique_ptr<util::TimeSeriesWriter> time {nullptr};
+    std::unique_ptr<util::CompactTrajectoryEncoder> encoder {nullptr};
+    std::size_t currentLimits[2]{0, 0};
+    std::size_t currentSetLimits[2]{0, 0};
+    std::size_t currentRemovedLimits[2]{0, 0};
+    std::size_t currentChangedLimits[2]{0, 0};
+    std::vector<ParticleFlavor> flavors {};
+};
+
+CompactTrajectory::CompactTrajectory(Kernel *const kernel, unsigned int stride, scalar precision,
+                                     std::size_t keyframeInterval)
+        : Observable(kernel, stride), pimpl(std::make_unique<Impl>()), precision(precision),
+          keyframeInterval(std::max<std::size_t>(1, keyframeInterval)) {
+    util::compact::validate(precision, kernel->context().boxSize());
+}
+
+void CompactTrajectory::initializeDataSet(File &file, const std::string &dataSetName, unsigned int flushStride) {
+    if (!pimpl->positions) {
+        const auto &boxSize = kernel->context().boxSize();
+        util::compact::validate(precision, boxSize);
+        Vec3 origin {-.5 * boxSize[0], -.5 * boxSize[1], -.5 * boxSize[2]};
+        pimpl->encoder = std::make_unique<util::CompactTrajectoryEncoder>(precision, origin, keyframeInterval);
+
+        auto group = file.createGroup(
+                std::string(Trajectory::TRAJECTORY_GROUP_PATH + (dataSetName.length() > 0 ? "/" + dataSetName : "")));
+        group.write("precision", std::vector<scalar>{precision});
+        group.write("origin", std::vector<scalar>{origin[0], origin[1], origin[2]});
+        group.write("keyframe_interval", std::vector<std::size_t>{keyframeInterval});
+
+        // the encoded positions are small unsigned integers, bit shuffle exposes their zero high bits to blosc
+        io::BloscFilter filter(io::BloscFilter::LZ4, 9, io::BloscFilter::BitShuffle);
+        h5rd::File::FilterConfiguration filters {&filter};
+        {
+            h5rd::dimensions fs = {flushStride, 3};
+            h5rd::dimensions dims = {h5rd::UNLIMITED_DIMS, 3};
+            pimpl->positions = group.createDataSet<std::uint32_t>("positions", fs, dims, filters);
+        }
+        {
+            h5rd::dimensions fs = {flushStride};
+            h5rd::dimensions dims = {h5rd::UNLIMITED_DIMS};
+            // particles added per frame (the complete particle set on keyframes), removed particles and type
+            // changes, see util::ParticleSetDelta
+            pimpl->ids = group.createDataSet<ParticleId>("ids", fs, dims, filters);
+            pimpl->types = group.createDataSet<ParticleTypeId>("types", fs, dims, filters);
+            pimpl->removed = group.createDataSet<std::size_t>("removed", fs, dims, filters);
+            pimpl->changed = group.createDataSet<std::size_t>("changed", fs, dims, filters);
+            pimpl->changedTypes = group.createDataSet<ParticleTypeId>("changed_types", fs, dims, filters);
+        }
+        {
+            h5rd::dimensions fs = {flushStride, 2};
+            h5rd::dimensions dims = {h5rd::UNLIMITED_DIMS, 2};
+            pimpl->limits = group.createDataSet<std::size_t>("limits", fs, dims, filters);
+            pimpl->setLimits = group.createDataSet<std::size_t>("set_limits", fs, dims, filters);
+            pimpl->removedLimits = group.createDataSet<std::size_t>("removed_limits", fs, dims, filters);
+            pimpl->changedLimits = group.createDataSet<std::size_t>("changed_limits", fs, dims, filters);
+        }
+        pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride, "time", true);
+    }
+}
+
+void CompactTrajectory::evaluate() {
+    kernel->stateModel().trajectorySnapshot(flavorTable(pimpl->flavors, kernel->context()), result);
+}
+
+void CompactTrajectory::flush() {
+    if (pimpl->positions) pimpl->positions->flush();
+    if (pimpl->limits) pimpl->limits->flush();
+    if (pimpl->ids) pimpl->ids->flush();
+    if (pimpl->types) pimpl->types->flush();
+    if (pimpl->setLimits) pimpl->setLimits->flush();
+    if (pimpl->removed) pimpl->removed->flush();
+    if (pimpl->removedLimits) pimpl->removedLimits->flush();
+    if (pimpl->changed) pimpl->changed->flush();
+    if (pimpl->changedTypes) pimpl->changedTypes->flush();
+    if (pimpl->changedLimits) pimpl->changedLimits->flush();
+    if (pimpl->time) pimpl->time->flush();
+}
+
+void CompactTrajectory::write(result_type &snapshot, TimeStep t) {
+    auto &encoder = *pimpl->encoder;
+    encoder.encode(snapshot);
+    const auto &delta = encoder.delta();
+
+    pimpl->currentSetLimits[0] = pimpl->currentSetLimits[1];
+    if (!delta.addedIds.empty()) {
+        pimpl->ids->append({delta.addedIds.size()}, delta.addedIds.data());
+        pimpl->types->append({delta.addedTypes.size()}, delta.addedTypes.data());
+        pimpl->currentSetLimits[1] += delta.addedIds.size();
+    }
+    pimpl->setLimits->append({1, 2}, pimpl->currentSetLimits);
+
+    pimpl->currentRemovedLimits[0] = pimpl->currentRemovedLimits[1];
+    if (!delta.removed.empty()) {
+        pimpl->removed->append({delta.removed.size()}, delta.removed.data());
+        pimpl->currentRemovedLimits[1] += delta.removed.size();
+    }
+    pimpl->removedLimits->append({1, 2}, pimpl->currentRemovedLimits);
+
+    pimpl->currentChangedLimits[0] = pimpl->currentChangedLimits[1];
+    if (!delta.changed.empty()) {
+        pimpl->changed->append({delta.changed.size()}, delta.changed.data());
+        pimpl->changedTypes->append({delta.changedTypes.size()}, delta.changedTypes.data());
+        pimpl->currentChangedLimits[1] += delta.changed.size();
+    }
+    pimpl->changedLimits->append({1, 2}, pimpl->currentChangedLimits);
+
+    pimpl->currentLimits[0] = pimpl->currentLimits[1];
+    pimpl->currentLimits[1] += snapshot.size();
+    if (!snapshot.empty()) {
+        pimpl->positions->append({snapshot.size(), 3}, encoder.words().data());
+    }
+    pimpl->limits->append({1, 2}, pimpl->currentLimits);
+    pimpl->time->append(t);
+}
+
+static constexpr auto& tCompactTraj = "CompactTrajectory";
+
+std::string_view CompactTrajectory::type() const {
+    return tCompactTraj;
+}
+
+CompactTrajectory::CompactTrajectory(CompactTrajectory &&) noexcept = default;
+
+CompactTrajectory::~CompactTrajectory() {
+    flush();
+}
 }
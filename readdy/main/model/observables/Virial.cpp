@@ -79,9 +79,9 @@ void Virial::initializeDataSet(File &file, const std::string &dataSetName, Strid
     pimpl->time = std::make_unique<util::TimeSeriesWriter>(group, flushStride);
 }
 
-void Virial::append() {
-    pimpl->ds->append({1, Matrix33::n(), Matrix33::m()}, result.data().data());
-    pimpl->time->append(t_current);
+void Virial::write(result_type &snapshot, TimeStep t) {
+    pimpl->ds->append({1, Matrix33::n(), Matrix33::m()}, snapshot.data().data());
+    pimpl->time->append(t);
 }
 
 constexpr static auto& t = "Virial";
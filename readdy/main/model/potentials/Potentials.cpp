@@ -43,6 +43,7 @@
 
 #include <readdy/model/Kernel.h>
 #include <readdy/model/potentials/PotentialsOrder1.h>
+#include <readdy/model/potentials/PairPotentialTable.h>
 
 namespace readdy::model::potentials {
 
@@ -268,4 +269,68 @@ std::string ScreenedElectrostatics::type() const {
     return getPotentialName<ScreenedElectrostatics>();
 }
 
+
+PairPotentialTable::PairPotentialTable(const PotentialRegistry &potentials, const ParticleTypeRegistry &types)
+        : _nRegisteredTypes(types.nTypes()), _potentialsVersion(potentials.potentialsOrder2Version()) {
+    for (const auto &entry : types.typeMapping()) {
+        _nTypes = std::max(_nTypes, static_cast<std::size_t>(entry.second) + 1);
+    }
+    _table.resize(_nTypes * _nTypes);
+    for (const auto &entry : potentials.potentialsOrder2()) {
+        auto t1 = std::get<0>(entry.first);
+        auto t2 = std::get<1>(entry.first);
+        pair::TypePairPotentials compiled;
+        for (const auto *potential : entry.second) {
+            if (auto hr = dynamic_cast<const HarmonicRepulsion *>(potential)) {
+                compiled.harmonicRepulsion.push_back({hr->_forceConstant, hr->_interactionDistance,
+                                                      hr->_interactionDistanceSquared});
+            } else if (auto wi = dynamic_cast<const WeakInteractionPiecewiseHarmonic *>(potential)) {
+                compiled.weakInteractionPiecewiseHarmonic.push_back({
+                    wi->forceConstant, wi->conf.desiredParticleDistance, wi->conf.depthAtDesiredDistance,
+                    wi->conf.noInteractionDistance, wi->conf.noInteractionDistanceSquared
+                });
+            } else if (auto lj = dynamic_cast<const LennardJones *>(potential)) {
+                compiled.lennardJones.push_back({
+                    lj->m, lj->n, lj->k, lj->sigma, lj->shift ? lj->energy(lj->cutoffDistance) : 0,
+                    lj->cutoffDistanceSquared
+                });
+            } else if (auto se = dynamic_cast<const ScreenedElectrostatics *>(potential)) {
+                compiled.screenedElectrostatics.push_back({
+                    se->electrostaticStrength, se->inverseScreeningDepth, se->repulsionStrength,
+                    se->repulsionDistance, se->exponent, se->cutoffSquared
+                });
+            } else {
+                compiled.userDefined.push_back(potential);
+                continue;
+            }
+            compiled.maxCutoffSquared = std::max(compiled.maxCutoffSquared, potential->getCutoffRadiusSquared());
+        }
+        for (const auto *potential : compiled.userDefined) {
+            compiled.maxCutoffSquared = std::max(compiled.maxCutoffSquared, potential->getCutoffRadiusSquared());
+        }
+        {
+            using Dispatch = pair::TypePairPotentials::Dispatch;
+            const auto nPotentials = entry.second.size();
+            if (compiled.empty()) {
+                compiled.dispatch = Dispatch::none;
+            } else if (nPotentials == 1 && compiled.harmonicRepulsion.size() == 1) {
+                compiled.dispatch = Dispatch::harmonicRepulsion;
+            } else if (nPotentials == 1 && compiled.lennardJones.size() == 1
+                       && compiled.lennardJones.front().m == 12 && compiled.lennardJones.front().n == 6) {
+                compiled.dispatch = Dispatch::lennardJones126;
+            } else {
+                compiled.dispatch = Dispatch::generic;
+            }
+        }
+        _empty &= compiled.empty();
+        // the registry contains each unordered pair once, the table is symmetric
+        _table[t1 * _nTypes + t2] = compiled;
+        _table[t2 * _nTypes + t1] = std::move(compiled);
+    }
+}
+
+bool PairPotentialTable::outdated(const PotentialRegistry &potentials, const ParticleTypeRegistry &types) const {
+    return _potentialsVersion != potentials.potentialsOrder2Version() || _nRegisteredTypes != types.nTypes();
+}
+
 }
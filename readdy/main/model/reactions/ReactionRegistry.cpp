@@ -45,6 +45,7 @@
  */
 
 #include <readdy/model/reactions/ReactionRegistry.h>
+#include <readdy/model/reactions/ReactionTable.h>
 #include <readdy/common/Utils.h>
 #include <readdy/model/reactions/Conversion.h>
 #include <readdy/model/reactions/Enzymatic.h>
@@ -76,6 +77,7 @@ ReactionId ReactionRegistry::emplaceReaction(const std::shared_ptr<Reaction> &re
         _o2Reactions[pp].push_back(_ownO2Reactions[pp].back().get());
         _n_order2 += 1;
     }
+    ++_version;
     return id;
 }
 
@@ -415,4 +417,35 @@ const Reaction* ReactionRegistry::byId(ReactionId id) const {
     }
 }
 
-}
\ No newline at end of file
+ReactionTable::ReactionTable(const ReactionRegistry &reactions, const ParticleTypeRegistry &types)
+        : _nRegisteredTypes(types.nTypes()), _reactionsVersion(reactions.version()) {
+    for (const auto &entry : types.typeMapping()) {
+        _nTypes = std::max(_nTypes, static_cast<std::size_t>(entry.second) + 1);
+    }
+    const auto nPairs = _nTypes * _nTypes;
+    _offsets.assign(nPairs + 1, 0);
+    _hasOrder2.assign((nPairs + 63) / 64, 0);
+    _maxEductDistanceSquared.assign(nPairs, 0);
+    _reactions.reserve(2 * reactions.nOrder2());
+    for (std::size_t t1 = 0; t1 < _nTypes; ++t1) {
+        for (std::size_t t2 = 0; t2 < _nTypes; ++t2) {
+            const auto index = t1 * _nTypes + t2;
+            for (auto *reaction : reactions.order2ByType(static_cast<ParticleTypeId>(t1),
+                                                         static_cast<ParticleTypeId>(t2))) {
+                _reactions.push_back(reaction);
+                _maxEductDistanceSquared[index] = std::max(_maxEductDistanceSquared[index],
+                                                           reaction->eductDistanceSquared());
+            }
+            _offsets[index + 1] = _reactions.size();
+            if (_offsets[index + 1] != _offsets[index]) {
+                _hasOrder2[index / 64] |= std::uint64_t{1} << (index % 64);
+            }
+        }
+    }
+}
+
+bool ReactionTable::outdated(const ReactionRegistry &reactions, const ParticleTypeRegistry &types) const {
+    return _reactionsVersion != reactions.version() || _nRegisteredTypes != types.nTypes();
+}
+
+}
@@ -249,6 +249,15 @@ ParticleTypeId GraphTopology::typeOf(const Vertex &v) const {
     return particleForVertex(v).type();
 }
 
+void GraphTopology::remapParticleIndices(const std::vector<VertexData::ParticleIndex> &oldToNew) {
+    for (auto &v : _graph.vertices()) {
+        if (!v.deactivated()) {
+            v->particleIndex = oldToNew.at(v->particleIndex);
+        }
+    }
+    configure();
+}
+
 std::vector<VertexData::ParticleIndex> GraphTopology::particleIndices() const {
     std::vector<VertexData::ParticleIndex> result;
     result.reserve(_graph.vertices().size());
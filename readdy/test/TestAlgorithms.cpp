@@ -44,10 +44,13 @@
 
 #include <catch2/catch.hpp>
 
+#include <array>
+#include <map>
 #include <unordered_set>
 #include <readdy/api/SimulationLoop.h>
 #include <readdy/api/Simulation.h>
 #include "readdy/common/algorithm.h"
+#include "readdy/common/space_filling_curve.h"
 
 
 using namespace readdy;
@@ -138,3 +141,128 @@ TEST_CASE("Check performEvents.", "[perform-events]") {
         }
     }
 }
+
+TEST_CASE("Check sum tree.", "[perform-events]") {
+    algo::SumTree<scalar> tree (5);
+    REQUIRE(tree.size() == 8);
+    std::vector<scalar> weights {1., 0., 2., 3., 0.};
+    tree.assign(weights.begin(), weights.end());
+    REQUIRE(tree.total() == Approx(6.));
+    REQUIRE(tree.find(0.) == 0);
+    REQUIRE(tree.find(.999) == 0);
+    REQUIRE(tree.find(1.) == 2);
+    REQUIRE(tree.find(2.999) == 2);
+    REQUIRE(tree.find(3.) == 3);
+    // round-off beyond the total never selects an index of weight zero
+    REQUIRE(tree.find(6.5) == 3);
+    tree.set(3, 0.);
+    REQUIRE(tree.total() == Approx(3.));
+    REQUIRE(tree.find(3.) == 2);
+    tree.set(0, 0.);
+    tree.set(2, 0.);
+    REQUIRE(tree.total() == 0.);
+}
+
+TEST_CASE("Check performEventsIndexed.", "[perform-events]") {
+    struct PairEvent {
+        std::size_t idx1, idx2;
+        scalar rate;
+    };
+    auto keys = [](const PairEvent &event) { return std::array<std::size_t, 2>{{event.idx1, event.idx2}}; };
+
+    SECTION("Evaluating all independent events") {
+        auto n = 1000U;
+        std::vector<PairEvent> events;
+        for (auto i = 0U; i < n; ++i) {
+            events.push_back({2 * i, 2 * i + 1, static_cast<scalar>(i % 3)});
+        }
+        std::vector<int> evaluated (n, 0);
+        algo::performEventsIndexed(events, [](const PairEvent &) { return true; }, keys,
+                                   [&](const PairEvent &event) { ++evaluated.at(event.idx1 / 2); });
+        for (auto count : evaluated) {
+            REQUIRE(count == 1);
+        }
+    }
+
+    SECTION("Events sharing a key are disabled") {
+        // a chain of particles with events between neighbors, no two evaluated events may share a particle
+        auto n = 1000U;
+        std::vector<PairEvent> events;
+        for (auto i = 0U; i + 1 < n; ++i) {
+            events.push_back({i, i + 1, static_cast<scalar>(1 + i % 5)});
+        }
+        std::vector<int> touched (n, 0);
+        std::size_t nEvaluated = 0, lastDeactivated = 0;
+        bool monotonic = true;
+        algo::performEventsIndexed(events, [](const PairEvent &) { return true; }, keys,
+                                   [&](const PairEvent &event) {
+                                       ++touched.at(event.idx1);
+                                       ++touched.at(event.idx2);
+                                       ++nEvaluated;
+                                   }, [&](const PairEvent &, std::size_t nDeactivated) {
+                    monotonic &= nDeactivated > lastDeactivated;
+                    lastDeactivated = nDeactivated;
+                });
+        REQUIRE(monotonic);
+        REQUIRE(lastDeactivated <= events.size());
+        for (auto count : touched) {
+            REQUIRE(count <= 1);
+        }
+        // a maximal matching: every event has at least one endpoint that was touched
+        for (const auto &event : events) {
+            REQUIRE(touched.at(event.idx1) + touched.at(event.idx2) > 0);
+        }
+        REQUIRE(nEvaluated >= (n - 1) / 3);
+    }
+
+    SECTION("Rejected events do not disable their dependents") {
+        std::vector<PairEvent> events {{0, 1, 1.}, {1, 2, 1.}, {2, 3, 0.}};
+        std::vector<int> evaluated (events.size(), 0);
+        algo::performEventsIndexed(events, [](const PairEvent &event) { return event.idx1 != 1; }, keys,
+                                   [&](const PairEvent &event) { ++evaluated.at(event.idx1); });
+        REQUIRE(evaluated[1] == 0);
+        REQUIRE(evaluated[0] == 1);
+        // the zero-rate event is still visited once all others are done
+        REQUIRE(evaluated[2] == 1);
+    }
+
+    SECTION("Selection is proportional to the rate") {
+        std::vector<PairEvent> events {{0, 1, 1.}, {0, 2, 3.}};
+        std::size_t nFirst = 0, nTrials = 20000;
+        for (std::size_t t = 0; t < nTrials; ++t) {
+            algo::performEventsIndexed(events, [](const PairEvent &) { return true; }, keys,
+                                       [&](const PairEvent &event) { nFirst += event.idx2 == 1 ? 1 : 0; });
+        }
+        REQUIRE(static_cast<scalar>(nFirst) / nTrials == Approx(.25).margin(.02));
+    }
+}
+
+TEST_CASE("Space filling curves", "[sfc]") {
+    const std::uint64_t n = 8;
+    std::map<std::uint64_t, std::array<std::uint64_t, 3>> hilbert, morton;
+    for (std::uint64_t i = 0; i < n; ++i) {
+        for (std::uint64_t j = 0; j < n; ++j) {
+            for (std::uint64_t k = 0; k < n; ++k) {
+                hilbert[util::sfc::hilbertIndex({{i, j, k}}, 3)] = {{i, j, k}};
+                morton[util::sfc::mortonIndex({{i, j, k}}, 3)] = {{i, j, k}};
+            }
+        }
+    }
+    SECTION("Bijective") {
+        REQUIRE(hilbert.size() == n * n * n);
+        REQUIRE(morton.size() == n * n * n);
+        REQUIRE(hilbert.rbegin()->first == n * n * n - 1);
+        REQUIRE(morton.rbegin()->first == n * n * n - 1);
+    }
+    SECTION("Consecutive Hilbert indices belong to adjacent grid points") {
+        for (auto it = std::next(hilbert.begin()); it != hilbert.end(); ++it) {
+            const auto &previous = std::prev(it)->second;
+            const auto &current = it->second;
+            std::uint64_t distance = 0;
+            for (std::size_t d = 0; d < 3; ++d) {
+                distance += std::max(previous[d], current[d]) - std::min(previous[d], current[d]);
+            }
+            REQUIRE(distance == 1);
+        }
+    }
+}
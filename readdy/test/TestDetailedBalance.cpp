@@ -210,7 +210,7 @@ TEST_CASE("Test detailed balance config.", "[detailed-balance]") {
     }
 }
 
-TEMPLATE_TEST_CASE("Test detailed balance action.", "[detailed-balance]", SingleCPU) {
+TEMPLATE_TEST_CASE("Test detailed balance action.", "[detailed-balance]", SingleCPU, CPU) {
     auto kernel = create<TestType>();
     auto &ctx = kernel->context();
     ctx.kBT() = 1;
@@ -360,7 +360,7 @@ void perform(readdy::model::Kernel *kernel, size_t nSteps, readdy::scalar timeSt
     }
 }
 
-TEMPLATE_TEST_CASE("Detailed balance integration tests.", "[detailed-balance]", SingleCPU) {
+TEMPLATE_TEST_CASE("Detailed balance integration tests.", "[detailed-balance]", SingleCPU, CPU) {
     auto kernel = create<TestType>();
     auto &ctx = kernel->context();
     ctx.boxSize() = {{12, 12, 12}};
@@ -0,0 +1,134 @@
+#include <utility>
+
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * Redistribution and use in source and binary forms, with or       *
+ * without modification, are permitted provided that the            *
+ * following conditions are met:                                    *
+ *  1. Redistributions of source code must retain the above         *
+ *     copyright notice, this list of conditions and the            *
+ *     following disclaimer.                                        *
+ *  2. Redistributions in binary form must reproduce the above      *
+ *     copyright notice, this list of conditions and the following  *
+ *     disclaimer in the documentation and/or other materials       *
+ *     provided with the distribution.                              *
+ *  3. Neither the name of the copyright holder nor the names of    *
+ *     its contributors may be used to endorse or promote products  *
+ *     derived from this software without specific                  *
+ *     prior written permission.                                    *
+ *                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND           *
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,      *
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE         *
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR            *
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,         *
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER *
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,      *
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)    *
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF      *
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+
+/**
+ * @file TestForkJoin.cpp
+ * @brief Tests for the persistent fork-join runtime
+ * @author clonker
+ * @date 16.10.26
+ */
+
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <readdy/common/thread/fork_join.h>
+
+using fork_join = readdy::util::thread::fork_join;
+
+TEST_CASE("Test the fork join runtime", "[threading]") {
+    auto nThreads = GENERATE(1, 2, 3, 8);
+    fork_join team (static_cast<std::size_t>(nThreads));
+    REQUIRE(team.size() == static_cast<std::size_t>(nThreads));
+
+    SECTION("parallel_for covers the range exactly once") {
+        for (std::size_t n : {0, 1, 2, 7, 1000}) {
+            std::vector<std::atomic<int>> visits (n);
+            std::atomic<std::size_t> maxTid {0};
+            team.parallel_for(0, n, [&](std::size_t tid, std::size_t begin, std::size_t end) {
+                // catch assertions are not thread safe, only record here
+                auto current = maxTid.load();
+                while (current < tid && !maxTid.compare_exchange_weak(current, tid)) {}
+                for (auto i = begin; i < end; ++i) ++visits[i];
+            });
+            REQUIRE(maxTid.load() < team.size());
+            for (const auto &v : visits) {
+                REQUIRE(v.load() == 1);
+            }
+        }
+    }
+
+    SECTION("parallel_reduce") {
+        std::vector<double> values (12345);
+        std::iota(values.begin(), values.end(), 0.);
+        for (int repetition = 0; repetition < 100; ++repetition) {
+            auto sum = team.parallel_reduce(0, values.size(), 0., [&](std::size_t, std::size_t begin, std::size_t end) {
+                return std::accumulate(values.begin() + begin, values.begin() + end, 0.);
+            }, [](double lhs, double rhs) { return lhs + rhs; });
+            REQUIRE(sum == std::accumulate(values.begin(), values.end(), 0.));
+        }
+    }
+
+    SECTION("Dynamic scheduling covers the chunks exactly once") {
+        std::vector<std::size_t> bounds {0, 3, 3, 400, 401, 1000};
+        std::vector<std::atomic<int>> visits (bounds.back());
+        team.parallel_for_dynamic(bounds, [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) ++visits[i];
+        });
+        for (const auto &v : visits) {
+            REQUIRE(v.load() == 1);
+        }
+    }
+
+    SECTION("Dynamic reduction is combined in chunk order") {
+        std::vector<std::size_t> bounds {0, 10, 20, 30, 40};
+        for (int repetition = 0; repetition < 100; ++repetition) {
+            auto order = team.parallel_reduce_dynamic(bounds, std::string(), [](std::size_t, std::size_t begin,
+                                                                                std::size_t) {
+                return std::to_string(begin / 10);
+            }, [](std::string lhs, const std::string &rhs) { return lhs + rhs; });
+            REQUIRE(order == "0123");
+        }
+    }
+
+    SECTION("Exceptions are rethrown after the region completed") {
+        for (std::size_t throwingTid = 0; throwingTid < team.size(); ++throwingTid) {
+            std::vector<std::atomic<int>> visits (100);
+            REQUIRE_THROWS_AS(team.parallel_for(0, visits.size(), [&](std::size_t tid, std::size_t begin,
+                                                                      std::size_t end) {
+                for (auto i = begin; i < end; ++i) ++visits[i];
+                if (tid == throwingTid) throw std::runtime_error("job failed");
+            }), std::runtime_error);
+            for (const auto &v : visits) {
+                REQUIRE(v.load() == 1);
+            }
+        }
+        // the team stays usable
+        auto sum = team.parallel_reduce(0, 10, 0, [](std::size_t, std::size_t begin, std::size_t end) {
+            return static_cast<int>(end - begin);
+        }, [](int lhs, int rhs) { return lhs + rhs; });
+        REQUIRE(sum == 10);
+    }
+
+    SECTION("resize") {
+        team.resize(5);
+        REQUIRE(team.size() == 5);
+        std::atomic<std::size_t> count {0};
+        team.parallel_for(0, 100, [&](std::size_t, std::size_t begin, std::size_t end) { count += end - begin; });
+        REQUIRE(count == 100);
+    }
+}
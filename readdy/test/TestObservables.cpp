@@ -40,12 +40,17 @@
  * @date 02.05.16
  */
 
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
 #include <catch2/catch.hpp>
 
 #include <readdy/plugin/KernelProvider.h>
 #include <readdy/api/Simulation.h>
 #include <readdy/testing/KernelTest.h>
 #include <readdy/testing/Utils.h>
+#include <readdy/model/observables/io/CompactTrajectoryCodec.h>
 
 namespace m = readdy::model;
 
@@ -315,4 +320,202 @@ TEMPLATE_TEST_CASE("Test observables", "[observables]", SingleCPU, CPU) {
             REQUIRE((resC[1] == force1 || resC[0] == force1));
         }
     }
+    SECTION("Radial distribution") {
+        namespace rnd = readdy::model::rnd;
+        context.particleTypes().add("A", 1.);
+        context.particleTypes().add("B", 1.);
+        context.boxSize() = {{8., 7., 9.}};
+        auto periodic = GENERATE(true, false);
+        context.periodicBoundaryConditions() = {{periodic, periodic, periodic}};
+        const auto &box = context.boxSize();
+        for (std::size_t i = 0; i < 300; ++i) {
+            readdy::Vec3 pos {rnd::uniform_real() * box[0] - .5 * box[0], rnd::uniform_real() * box[1] - .5 * box[1],
+                              rnd::uniform_real() * box[2] - .5 * box[2]};
+            stateModel.addParticle({pos, context.particleTypes().idOf(i % 3 == 0 ? "B" : "A")});
+        }
+        kernel->initialize();
+
+        std::vector<readdy::scalar> uniformBins;
+        for (int i = 0; i <= 30; ++i) {
+            uniformBins.push_back(.1 * i);
+        }
+        std::vector<readdy::scalar> nonUniformBins {.2, .3, .7, 1.1, 1.15, 2., 3.5};
+        for (const auto &bins : {uniformBins, nonUniformBins}) {
+            auto obs = kernel->observe().radialDistribution(1, bins, {"A"}, {"A", "B"}, 1.);
+            m::observables::RadialDistribution reference(kernel.get(), 1, bins, std::vector<std::string>{"A"},
+                                                         std::vector<std::string>{"A", "B"}, 1.);
+            obs->evaluate();
+            reference.evaluate();
+            const auto &distribution = std::get<1>(obs->getResult());
+            const auto &expected = std::get<1>(reference.getResult());
+            REQUIRE(distribution.size() == bins.size() - 1);
+            REQUIRE(std::accumulate(expected.begin(), expected.end(), 0.) > 0);
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                REQUIRE(distribution[i] == Approx(expected[i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("Test asynchronous observable writer", "[observables]") {
+    using AsyncWriter = m::observables::util::AsyncWriter;
+
+    SECTION("Jobs are performed in submission order") {
+        std::vector<int> written;
+        {
+            AsyncWriter writer(2);
+            for (int i = 0; i < 100; ++i) {
+                writer.submit([&written, i]() { written.push_back(i); }, sizeof(int));
+            }
+            writer.wait();
+            REQUIRE(written.size() == 100);
+            auto statistics = writer.statistics();
+            REQUIRE(statistics.nWrites == 100);
+            REQUIRE(statistics.bytes == 100 * sizeof(int));
+            writer.submit([&written]() { written.push_back(100); });
+        }
+        // the destructor drains the queue
+        REQUIRE(written.size() == 101);
+        for (int i = 0; i <= 100; ++i) {
+            REQUIRE(written[i] == i);
+        }
+    }
+
+    SECTION("Failures are rethrown on the submitting thread") {
+        AsyncWriter writer;
+        writer.submit([]() { throw std::runtime_error("io failed"); });
+        REQUIRE_THROWS_AS(writer.wait(), std::runtime_error);
+        writer.submit([]() {});
+        REQUIRE_NOTHROW(writer.wait());
+    }
+
+    SECTION("Buffers are recycled") {
+        m::observables::util::BufferPool<std::vector<int>> pool;
+        auto *buffer = pool.acquire();
+        buffer->resize(10);
+        pool.release(buffer);
+        REQUIRE(pool.acquire() == buffer);
+        REQUIRE(pool.acquire() != buffer);
+    }
+
+    SECTION("Size of results") {
+        std::tuple<std::vector<int>, std::vector<std::vector<double>>> result {{1, 2, 3}, {{1.}, {1., 2.}}};
+        REQUIRE(m::observables::util::byteSize(result) == 3 * sizeof(int) + 3 * sizeof(double));
+    }
+
+    SECTION("Registered observables use the kernel's writer") {
+        auto kernel = readdy::plugin::KernelProvider::getInstance().create("SingleCPU");
+        auto handle = kernel->registerObservable(kernel->observe().nParticles(1));
+        REQUIRE(kernel->asyncObservableWriter() == nullptr);
+        kernel->enableAsyncObservableWriter(4);
+        REQUIRE(kernel->asyncObservableWriter() != nullptr);
+        REQUIRE(kernel->asyncObservableWriter()->capacity() == 4);
+        kernel->disableAsyncObservableWriter();
+        REQUIRE(kernel->asyncObservableWriter() == nullptr);
+    }
+}
+
+TEST_CASE("Test compact trajectory codec", "[observables]") {
+    using Encoder = m::observables::util::CompactTrajectoryEncoder;
+    using Decoder = m::observables::util::CompactTrajectoryDecoder;
+    using Entry = m::observables::TrajectoryEntry;
+    namespace compact = m::observables::util::compact;
+
+    SECTION("Zigzag encoding") {
+        for (std::int32_t v : {0, 1, -1, 2, -2, 1000, -1000, 1 << 30, -(1 << 30)}) {
+            REQUIRE(compact::unzigzag(compact::zigzag(v)) == v);
+        }
+        REQUIRE(compact::zigzag(0) == 0);
+        REQUIRE(compact::zigzag(-1) == 1);
+        REQUIRE(compact::zigzag(1) == 2);
+    }
+
+    SECTION("Invalid precision") {
+        REQUIRE_THROWS_AS(compact::validate(0., {10., 10., 10.}), std::invalid_argument);
+        REQUIRE_THROWS_AS(compact::validate(1e-12, {10., 10., 10.}), std::invalid_argument);
+        REQUIRE_NOTHROW(compact::validate(1e-3, {10., 10., 10.}));
+    }
+
+    SECTION("Round trip") {
+        readdy::scalar precision = 1e-3;
+        readdy::Vec3 origin {-5, -5, -5};
+        Encoder encoder(precision, origin, 4);
+        Decoder decoder(precision, origin, 4);
+
+        std::vector<Entry> frame;
+        auto entry = [](readdy::ParticleId id, readdy::ParticleTypeId type, readdy::Vec3 pos) {
+            Entry e;
+            e.id = id;
+            e.typeId = type;
+            e.pos = pos;
+            return e;
+        };
+        for (std::size_t i = 0; i < 20; ++i) {
+            frame.push_back(entry(i, static_cast<readdy::ParticleTypeId>(i % 2),
+                                  {-4.9 + .5 * i, 4.9 - .5 * i, .01 * i}));
+        }
+
+        std::mt19937 shuffleGenerator(42);
+        for (std::size_t t = 0; t < 12; ++t) {
+            std::size_t nAdded = 0, nRemoved = 0, nChanged = 0;
+            if (t == 2) {
+                // the particle data was reordered, the particle set is the same
+                std::shuffle(frame.begin(), frame.end(), shuffleGenerator);
+            }
+            if (t == 3) {
+                // a conversion reaction in place
+                frame[5].typeId = 1 - frame[5].typeId;
+                nChanged = 1;
+            }
+            if (t == 6) {
+                // a reaction: particle 3 is gone, a new one appears
+                frame.erase(frame.begin() + 3);
+                frame.push_back(entry(100, 1, {0, 0, 0}));
+                nRemoved = 1;
+                nAdded = 1;
+            }
+            if (t == 9) {
+                nRemoved = frame.size();
+                frame.clear();
+            }
+            encoder.encode(frame);
+            const auto &delta = encoder.delta();
+            REQUIRE(encoder.keyframe() == (t % 4 == 0));
+            if (encoder.keyframe()) {
+                REQUIRE(delta.addedIds.size() == frame.size());
+                REQUIRE(delta.removed.empty());
+                REQUIRE(delta.changed.empty());
+            } else {
+                REQUIRE(delta.addedIds.size() == nAdded);
+                REQUIRE(delta.removed.size() == nRemoved);
+                REQUIRE(delta.changed.size() == nChanged);
+            }
+            decoder.decode(encoder.words().data(), frame.size(), delta);
+            REQUIRE(decoder.size() == frame.size());
+            REQUIRE(decoder.ids() == encoder.ids());
+            REQUIRE(decoder.types() == encoder.types());
+            std::unordered_map<readdy::ParticleId, std::size_t> decoded;
+            for (std::size_t i = 0; i < decoder.size(); ++i) {
+                decoded[decoder.ids()[i]] = i;
+            }
+            for (const auto &e : frame) {
+                REQUIRE(decoded.find(e.id) != decoded.end());
+                auto i = decoded.at(e.id);
+                REQUIRE(decoder.types()[i] == e.typeId);
+                auto pos = decoder.position(i);
+                for (std::size_t d = 0; d < 3; ++d) {
+                    REQUIRE(std::abs(pos[d] - e.pos[d]) <= .5 * precision + 1e-12);
+                }
+            }
+            if (!encoder.keyframe() && nAdded == 0) {
+                // small displacements give small words
+                for (auto word : encoder.words()) {
+                    REQUIRE(word < 64);
+                }
+            }
+            for (auto &e : frame) {
+                e.pos += readdy::Vec3(.01, -.005, .0123);
+            }
+        }
+    }
 }
@@ -49,6 +49,7 @@
 #include <readdy/plugin/KernelProvider.h>
 #include <readdy/testing/KernelTest.h>
 #include <readdy/testing/Utils.h>
+#include <readdy/model/potentials/PairPotentialTable.h>
 
 using namespace Catch::Floating;
 using namespace readdytesting::kernel;
@@ -505,3 +506,47 @@ TEMPLATE_TEST_CASE("Test potentials", "[potentials]", SingleCPU, CPU) {
         }
     }
 }
+
+TEST_CASE("Test pair potential table", "[potentials]") {
+    readdy::model::Context context;
+    context.particleTypes().add("A", 1.);
+    context.particleTypes().add("B", 1.);
+    context.particleTypes().add("C", 1.);
+    auto &potentials = context.potentials();
+    potentials.addHarmonicRepulsion("A", "A", 2., 1.5);
+    potentials.addWeakInteractionPiecewiseHarmonic("A", "B", 3., 1., .5, 2.5);
+    potentials.addLennardJones("B", "B", 12, 6, 2.5, true, 1., 1.);
+    potentials.addLennardJones("A", "C", 12, 6, 2.5, false, 1., 1.);
+    potentials.addScreenedElectrostatics("B", "C", -1., 1., 1., 1., 6, 3.);
+    potentials.addHarmonicRepulsion("B", "C", 1., 1.);
+
+    readdy::model::potentials::PairPotentialTable table(potentials, context.particleTypes());
+    REQUIRE_FALSE(table.empty());
+    REQUIRE_FALSE(table.outdated(potentials, context.particleTypes()));
+
+    const auto &types = context.particleTypes();
+    for (auto t1 : {types.idOf("A"), types.idOf("B"), types.idOf("C")}) {
+        for (auto t2 : {types.idOf("A"), types.idOf("B"), types.idOf("C")}) {
+            const auto &compiled = table(t1, t2);
+            const auto &reference = potentials.potentialsOf(t1, t2);
+            REQUIRE(compiled.empty() == reference.empty());
+            for (auto i = 0; i < 100; ++i) {
+                auto x_ij = readdy::model::rnd::normal3<readdy::scalar>(0, 1);
+                auto distSquared = x_ij * x_ij;
+                readdy::Vec3 force{0, 0, 0}, referenceForce{0, 0, 0};
+                readdy::scalar energy{0}, referenceEnergy{0};
+                compiled.calculateForceAndEnergy(force, energy, x_ij, distSquared);
+                for (const auto *potential : reference) {
+                    if (distSquared < potential->getCutoffRadiusSquared()) {
+                        potential->calculateForceAndEnergy(referenceForce, referenceEnergy, x_ij);
+                    }
+                }
+                REQUIRE(energy == Approx(referenceEnergy).epsilon(1e-8));
+                REQUIRE(readdy::testing::vec3eq(force, referenceForce, 1e-8));
+            }
+        }
+    }
+
+    potentials.addHarmonicRepulsion("C", "C", 1., 1.);
+    REQUIRE(table.outdated(potentials, context.particleTypes()));
+}
@@ -48,6 +48,7 @@
 #include <readdy/api/SimulationLoop.h>
 #include <readdy/testing/KernelTest.h>
 #include <readdy/testing/Utils.h>
+#include <readdy/model/reactions/ReactionTable.h>
 
 using namespace readdytesting::kernel;
 
@@ -213,3 +214,41 @@ TEMPLATE_TEST_CASE("Test reaction handlers", "[reactions]", SingleCPU, CPU) {
         }
     }
 }
+
+TEST_CASE("Test reaction table", "[reactions]") {
+    readdy::model::Context context;
+    context.particleTypes().add("A", 1.);
+    context.particleTypes().add("B", 1.);
+    context.particleTypes().add("C", 1.);
+    auto &reactions = context.reactions();
+    reactions.addFusion("fusAB", "A", "B", "C", 1., 1.5);
+    reactions.addEnzymatic("enzCA", "C", "A", "B", 2., 2.5);
+    reactions.addFusion("fusBA", "B", "A", "A", 3., .5);
+    reactions.addFusion("fusCC", "C", "C", "A", 4., 1.);
+    reactions.addDecay("decA", "A", 1.);
+
+    readdy::model::reactions::ReactionTable table(reactions, context.particleTypes());
+    REQUIRE_FALSE(table.outdated(reactions, context.particleTypes()));
+
+    const auto &types = context.particleTypes();
+    for (auto t1 : {types.idOf("A"), types.idOf("B"), types.idOf("C")}) {
+        for (auto t2 : {types.idOf("A"), types.idOf("B"), types.idOf("C")}) {
+            const auto compiled = table.order2(t1, t2);
+            const auto &reference = reactions.order2ByType(t1, t2);
+            REQUIRE(table.hasOrder2(t1, t2) == !reference.empty());
+            REQUIRE(compiled.size() == reference.size());
+            readdy::scalar maxDistSquared {0};
+            for (std::size_t i = 0; i < reference.size(); ++i) {
+                REQUIRE(compiled[i] == reference[i]);
+                maxDistSquared = std::max(maxDistSquared, reference[i]->eductDistanceSquared());
+            }
+            REQUIRE(table.maxEductDistanceSquared(t1, t2) == maxDistSquared);
+        }
+    }
+    REQUIRE(table.order2(types.idOf("A"), types.idOf("B")).size() == 2);
+    REQUIRE(table.maxEductDistanceSquared(types.idOf("B"), types.idOf("A")) == 1.5 * 1.5);
+    REQUIRE_FALSE(table.hasOrder2(types.idOf("B"), types.idOf("B")));
+
+    reactions.addFusion("fusBB", "B", "B", "C", 1., 1.);
+    REQUIRE(table.outdated(reactions, context.particleTypes()));
+}
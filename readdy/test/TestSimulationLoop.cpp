@@ -53,6 +53,15 @@ namespace api = readdy::api;
 
 using namespace readdytesting::kernel;
 
+namespace {
+// moves nothing and does not keep track of the drift speeds
+struct SilentEulerBDIntegrator : public readdy::model::actions::EulerBDIntegrator {
+    explicit SilentEulerBDIntegrator(readdy::scalar timeStep) : EulerBDIntegrator(timeStep) {}
+
+    void perform() override {}
+};
+}
+
 TEMPLATE_TEST_CASE("Test simulation loop", "[loop]", SingleCPU, CPU) {
     SECTION("Correct number of timesteps") {
         readdy::model::Context ctx;
@@ -116,4 +125,51 @@ TEMPLATE_TEST_CASE("Test simulation loop", "[loop]", SingleCPU, CPU) {
         loop.neighborListCutoff() += 0.1; // adding a skin/padding
         loop.run(10);
     }
+    SECTION("Adaptive time step") {
+        readdy::model::Context ctx;
+        ctx.particleTypes().add("A", 1.);
+        ctx.particleTypes().add("B", 1.);
+        ctx.boxSize() = {{10., 10., 10.}};
+        ctx.periodicBoundaryConditions() = {{true, true, true}};
+        ctx.potentials().addHarmonicRepulsion("A", "A", 10., 2.);
+        ctx.reactions().addConversion("conversion", "B", "A", 1.);
+        readdy::Simulation simulation {create<TestType>(), ctx};
+        simulation.addParticle("A", 0., 0., 0.);
+        simulation.addParticle("A", .5, 0., 0.);
+        auto loop = simulation.createLoop(.001);
+        loop.useAdaptiveTimeStep(.01, .1, 0., .5);
+        std::vector<readdy::scalar> timeSteps;
+        loop.addCallback([&](readdy::TimeStep) {
+            timeSteps.push_back(loop.lastTimeStep());
+        });
+        loop.run(200);
+
+        // the first callback is invoked before the first step
+        timeSteps.erase(timeSteps.begin());
+        REQUIRE(timeSteps.size() == 200);
+        REQUIRE(timeSteps.front() == .001);
+        readdy::scalar totalTime = 0;
+        for (std::size_t i = 0; i < timeSteps.size(); ++i) {
+            // bounded by the reaction probability and the growth per step
+            REQUIRE(timeSteps[i] <= .1 + 1e-12);
+            if (i > 0) {
+                REQUIRE(timeSteps[i] <= 2 * timeSteps[i - 1] + 1e-12);
+            }
+            totalTime += timeSteps[i];
+        }
+        // once the particles drifted apart, the time step grows until it is limited by the reaction
+        REQUIRE(*std::max_element(timeSteps.begin(), timeSteps.end()) == Approx(.1));
+        REQUIRE(loop.kernel()->stateModel().time() == Approx(totalTime));
+    }
+    SECTION("Adaptive time step requires drift speeds") {
+        readdy::model::Context ctx;
+        ctx.particleTypes().add("A", 1.);
+        ctx.boxSize() = {{10., 10., 10.}};
+        readdy::Simulation simulation {create<TestType>(), ctx};
+        simulation.addParticle("A", 0., 0., 0.);
+        auto loop = simulation.createLoop(.001);
+        loop.useAdaptiveTimeStep(.01);
+        loop.integrator() = std::make_shared<SilentEulerBDIntegrator>(.001);
+        REQUIRE_THROWS_AS(loop.run(10), std::logic_error);
+    }
 }
@@ -211,4 +211,63 @@ TEMPLATE_TEST_CASE("Test state model", "[state-model]", SingleCPU, CPU) {
             readdy::testing::vec3eq(force, readdy::Vec3(0, 0, 0));
         }
     }
+    SECTION("Trajectory snapshot") {
+        m::Context &ctx = kernel->context();
+        auto &stateModel = kernel->stateModel();
+        ctx.particleTypes().add("A", 1.0);
+        ctx.particleTypes().addTopologyType("T", 1.0);
+        ctx.boxSize() = {{10., 10., 10.}};
+        auto typeIdA = ctx.particleTypes().idOf("A");
+        auto typeIdT = ctx.particleTypes().idOf("T");
+        std::vector<m::Particle> particles;
+        for (int i = 0; i < 50; ++i) {
+            auto x = static_cast<readdy::scalar>(-4.5 + .18 * i);
+            particles.emplace_back(x, -x, .5 * x, i % 3 == 0 ? typeIdT : typeIdA);
+        }
+        stateModel.addParticles(particles);
+        // leave a hole in the particle storage
+        stateModel.removeParticle(stateModel.getParticles().at(7));
+
+        auto expected = stateModel.getParticles();
+        std::vector<m::observables::TrajectoryEntry> entries;
+        stateModel.trajectorySnapshot(ctx.particleTypes().flavors(), entries);
+        REQUIRE(entries.size() == expected.size());
+        REQUIRE(entries.size() == particles.size() - 1);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const auto &p = expected.at(i);
+            REQUIRE(entries[i].id == p.id());
+            REQUIRE(entries[i].typeId == p.type());
+            REQUIRE(entries[i].flavor == ctx.particleTypes().infoOf(p.type()).flavor);
+            readdy::testing::vec3eq(entries[i].pos, p.pos());
+        }
+    }
+    SECTION("Dense particle indices") {
+        m::Context &ctx = kernel->context();
+        auto &stateModel = kernel->stateModel();
+        ctx.particleTypes().add("A", 1.0);
+        auto typeIdA = ctx.particleTypes().idOf("A");
+        std::vector<m::Particle> particles;
+        for (int i = 0; i < 10; ++i) {
+            particles.emplace_back(0, 0, 0, typeIdA);
+        }
+        stateModel.addParticles(particles);
+        // leave blanks at the storage indices 5 and 2
+        stateModel.removeParticle(particles.at(5));
+        stateModel.removeParticle(particles.at(2));
+
+        auto dense = stateModel.denseParticleIndices();
+        REQUIRE(dense(0) == 0);
+        REQUIRE(dense(1) == 1);
+        REQUIRE(dense(3) == 2);
+        REQUIRE(dense(4) == 3);
+        REQUIRE(dense(6) == 4);
+        REQUIRE(dense(9) == 7);
+
+        std::vector<std::size_t> indices {9, 0, 3, 6};
+        stateModel.toDenseParticleIndices(indices.begin(), indices.end());
+        REQUIRE(indices == std::vector<std::size_t>{7, 0, 2, 4});
+        auto remaining = stateModel.getParticles();
+        REQUIRE(remaining.at(dense(6)).id() == particles.at(6).id());
+        REQUIRE(remaining.at(dense(9)).id() == particles.at(9).id());
+    }
 }
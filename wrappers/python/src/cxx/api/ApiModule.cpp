@@ -157,7 +157,27 @@ void exportApi(py::module &api) {
             .def("run", [](sim &self, const readdy::TimeStep steps, const readdy::scalar timeStep) {
                 py::gil_scoped_release release;
                 self.run(steps, timeStep);
-            }, "n_steps"_a, "time_step"_a);
+            }, "n_steps"_a, "time_step"_a)
+            .def("enable_async_output", &sim::enableAsyncOutput, "queue_capacity"_a = 8)
+            .def("disable_async_output", [](sim &self) {
+                py::gil_scoped_release release;
+                self.disableAsyncOutput();
+            })
+            .def("wait_for_async_output", [](sim &self) {
+                py::gil_scoped_release release;
+                self.waitForAsyncOutput();
+            })
+            .def_property_readonly("async_output_statistics", [](const sim &self) -> py::object {
+                if (auto statistics = self.asyncOutputStatistics(); statistics) {
+                    py::dict result;
+                    result["n_writes"] = statistics->nWrites;
+                    result["bytes"] = statistics->bytes;
+                    result["write_time"] = statistics->writeTime;
+                    result["wait_time"] = statistics->waitTime;
+                    return std::move(result);
+                }
+                return py::none();
+            });
     exportObservables(api, simulation);
 
     // actions and evaluate observables, i.e. things needed to build a custom simulation loop [experimental]
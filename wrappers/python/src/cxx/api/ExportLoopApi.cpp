@@ -42,6 +42,7 @@
 
 
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <readdy/api/SimulationLoop.h>
 #include <readdy/model/actions/UserDefinedAction.h>
 #include "PyFunction.h"
@@ -114,6 +115,10 @@ void exportLoopApi(pybind11::module &module) {
             .def("make_checkpoints", [](Loop &self, std::size_t stride, std::string basePath, std::size_t maxNSaves, std::string checkpointFormat) {
                 self.makeCheckpoints(stride, basePath, maxNSaves, checkpointFormat);
             })
+            .def("use_adaptive_time_step", &Loop::useAdaptiveTimeStep, "max_displacement"_a,
+                 "max_reaction_probability"_a = .1, "min_time_step"_a = 0., "max_time_step"_a = -1.,
+                 "max_growth_factor"_a = 2.)
+            .def_property_readonly("last_time_step", &Loop::lastTimeStep)
             .def("describe", &Loop::describe)
             .def("validate", &Loop::validate);
 }
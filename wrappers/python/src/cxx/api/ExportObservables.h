@@ -277,6 +277,11 @@ inline obs_handle_t registerObservable_FlatTrajectory(sim& self, readdy::Stride
     return self.registerObservable(self.observe().flatTrajectory(stride));
 }
 
+inline obs_handle_t registerObservable_CompactTrajectory(sim& self, readdy::Stride stride, readdy::scalar precision,
+                                                        std::size_t keyframeInterval) {
+    return self.registerObservable(self.observe().compactTrajectory(stride, precision, keyframeInterval));
+}
+
 template <typename type_, typename... options>
 void exportObservables(py::module &apiModule, py::class_<type_, options...> &simulation) {
     using namespace pybind11::literals;
@@ -326,6 +331,8 @@ void exportObservables(py::module &apiModule, py::class_<type_, options...> &sim
                  "stride"_a, "callback"_a = py::none())
             .def("register_observable_trajectory", &registerObservable_Trajectory, "stride"_a)
             .def("register_observable_flat_trajectory", &registerObservable_FlatTrajectory, "stride"_a)
+            .def("register_observable_compact_trajectory", &registerObservable_CompactTrajectory, "stride"_a,
+                 "precision"_a, "keyframe_interval"_a = 100)
             .def("register_observable_virial", &registerObservable_Virial, "stride"_a, "callback"_a=py::none())
             .def("register_observable_topologies", &registerObservable_Topologies, "stride"_a, "callback"_a=py::none());
 }
@@ -55,6 +55,7 @@
 
 #include <readdy/model/observables/io/TrajectoryEntry.h>
 #include <readdy/model/observables/io/Types.h>
+#include <readdy/model/observables/io/CompactTrajectoryCodec.h>
 #include <readdy/model/IOUtils.h>
 #include <readdy/io/BloscFilter.h>
 #include <readdy/model/reactions/ReactionRecord.h>
@@ -646,6 +647,113 @@ std::vector<std::vector<TrajectoryParticle>> read_trajectory(const std::string &
     return std::move(result);
 }
 
+std::vector<std::vector<TrajectoryParticle>>
+read_compact_trajectory(const std::string &filename, const std::string &name) {
+    readdy::io::BloscFilter bloscFilter;
+    bloscFilter.registerFilter();
+
+    auto f = h5rd::File::open(filename, h5rd::File::Flag::READ_ONLY);
+
+    auto particleInfoH5Type = readdy::model::ioutils::getParticleTypeInfoType(f->ref());
+
+    // get particle types from config
+    std::vector<readdy::model::ioutils::ParticleTypeInfo> types;
+    {
+        auto config = f->getSubgroup("readdy/config");
+        config.read("particle_types", types, &std::get<0>(particleInfoH5Type), &std::get<1>(particleInfoH5Type));
+    }
+    std::unordered_map<std::size_t, std::string> typeMapping;
+    std::unordered_map<std::size_t, std::string> flavorMapping;
+    for (const auto &type : types) {
+        typeMapping[type.type_id] = std::string(type.name);
+        flavorMapping[type.type_id] = std::string(type.flavor);
+    }
+
+    auto traj = f->getSubgroup("readdy/trajectory/" + name);
+
+    // quantization
+    std::vector<readdy::scalar> precision;
+    traj.read("precision", precision);
+    std::vector<readdy::scalar> origin;
+    traj.read("origin", origin);
+    std::vector<std::size_t> keyframeInterval;
+    traj.read("keyframe_interval", keyframeInterval);
+    if (precision.size() != 1 || origin.size() != 3 || keyframeInterval.size() != 1) {
+        throw std::runtime_error(fmt::format("{} is not a valid compact trajectory", "readdy/trajectory/" + name));
+    }
+
+    // limits into the positions and into the changes of the particle set
+    std::vector<std::size_t> limits;
+    traj.read("limits", limits);
+    std::vector<std::size_t> setLimits;
+    traj.read("set_limits", setLimits);
+    std::vector<std::size_t> removedLimits;
+    traj.read("removed_limits", removedLimits);
+    std::vector<std::size_t> changedLimits;
+    traj.read("changed_limits", changedLimits);
+
+    // time
+    std::vector<readdy::TimeStep> time;
+    traj.read("time", time);
+
+    // records
+    std::vector<std::uint32_t> positions;
+    traj.read("positions", positions);
+    std::vector<readdy::ParticleId> ids;
+    traj.read("ids", ids);
+    std::vector<readdy::ParticleTypeId> particleTypes;
+    traj.read("types", particleTypes);
+    std::vector<std::size_t> removed;
+    traj.read("removed", removed);
+    std::vector<std::size_t> changed;
+    traj.read("changed", changed);
+    std::vector<readdy::ParticleTypeId> changedTypes;
+    traj.read("changed_types", changedTypes);
+
+    auto n_frames = limits.size() / 2;
+    readdy::log::debug("got n frames: {}", n_frames);
+    if (setLimits.size() != limits.size() || removedLimits.size() != limits.size()
+        || changedLimits.size() != limits.size() || time.size() != n_frames) {
+        throw std::logic_error(fmt::format("size mismatch in compact trajectory, limits size is {}, set limits size "
+                                           "is {}, removed limits size is {}, changed limits size is {}, time size "
+                                           "is {}", limits.size(), setLimits.size(), removedLimits.size(),
+                                           changedLimits.size(), time.size()));
+    }
+
+    readdy::model::observables::util::CompactTrajectoryDecoder decoder(
+            precision[0], {origin[0], origin[1], origin[2]}, keyframeInterval[0]);
+
+    std::vector<std::vector<TrajectoryParticle>> result;
+    result.reserve(n_frames);
+
+    readdy::model::observables::util::ParticleSetDelta delta;
+    auto timeIt = time.begin();
+    for (std::size_t frame = 0; frame < limits.size(); frame += 2, ++timeIt) {
+        auto begin = limits[frame];
+        auto end = limits[frame + 1];
+        delta.addedIds.assign(ids.begin() + setLimits[frame], ids.begin() + setLimits[frame + 1]);
+        delta.addedTypes.assign(particleTypes.begin() + setLimits[frame],
+                                particleTypes.begin() + setLimits[frame + 1]);
+        delta.removed.assign(removed.begin() + removedLimits[frame], removed.begin() + removedLimits[frame + 1]);
+        delta.changed.assign(changed.begin() + changedLimits[frame], changed.begin() + changedLimits[frame + 1]);
+        delta.changedTypes.assign(changedTypes.begin() + changedLimits[frame],
+                                  changedTypes.begin() + changedLimits[frame + 1]);
+        decoder.decode(positions.data() + 3 * begin, end - begin, delta);
+
+        result.emplace_back();
+        auto &currentFrame = result.back();
+        currentFrame.reserve(end - begin);
+        for (std::size_t i = 0; i < decoder.size(); ++i) {
+            auto typeId = decoder.types()[i];
+            auto pos = decoder.position(i);
+            currentFrame.emplace_back(typeMapping[typeId], flavorMapping[typeId], pos.data, decoder.ids()[i],
+                                      *timeIt);
+        }
+    }
+
+    return result;
+}
+
 void exportUtils(py::module &m) {
     using namespace pybind11::literals;
     py::class_<TrajectoryParticle>(m, "TrajectoryParticle")
@@ -727,6 +835,7 @@ void exportUtils(py::module &m) {
     m.def("convert_readdyviewer", &convert_readdy_viewer, "h5_file_name"_a, "traj_data_set_name"_a,
           "begin"_a = 0, "end"_a = std::numeric_limits<int>::max(), "stride"_a = 1);
     m.def("read_trajectory", &read_trajectory, "filename"_a, "name"_a);
+    m.def("read_compact_trajectory", &read_compact_trajectory, "filename"_a, "name"_a);
     m.def("read_topologies_observable", &readTopologies, "filename"_a, "groupname"_a,
           "begin"_a = 0, "end"_a = std::numeric_limits<int>::max(), "stride"_a = 1);
     m.def("read_reaction_observable", &read_reactions_obs, "filename"_a, "name"_a);
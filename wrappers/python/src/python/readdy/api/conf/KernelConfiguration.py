@@ -48,6 +48,13 @@ class CPUKernelConfiguration(object):
     def __init__(self):
         self._n_threads = -1
         self._cll_radius = 1
+        self._verlet_list = False
+        self._skin = 0.
+        self._reorder_interval = 0
+        self._reorder_hilbert = True
+        self._seed = 0
+        self._sample_first_order_reactions = False
+        self._structure_of_arrays = False
 
     @property
     def n_threads(self):
@@ -67,14 +74,108 @@ class CPUKernelConfiguration(object):
             raise ValueError("Only strictly positive cell linked list radii permitted!")
         self._cll_radius = value
 
+    @property
+    def verlet_list(self):
+        """
+        Whether to use Verlet lists on top of the cell linked list. If enabled, the skin of the simulation is used
+        to decide when the lists need to be rebuilt rather than just increasing the cutoff.
+        """
+        return self._verlet_list
+
+    @verlet_list.setter
+    def verlet_list(self, value):
+        self._verlet_list = bool(value)
+
+    @property
+    def skin(self):
+        return self._skin
+
+    @skin.setter
+    def skin(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative skin sizes permitted!")
+        self._skin = value
+
+    @property
+    def reorder_interval(self):
+        """
+        Number of cell linked list rebuilds between two reorderings of the particle data along a space filling curve,
+        which keeps particles that are close in space close in memory. Zero disables the reordering.
+        """
+        return self._reorder_interval
+
+    @reorder_interval.setter
+    def reorder_interval(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative reorder intervals permitted!")
+        self._reorder_interval = int(value)
+
+    @property
+    def reorder_hilbert(self):
+        """
+        Whether the particle data is reordered along a Hilbert curve, otherwise a Morton curve is used.
+        """
+        return self._reorder_hilbert
+
+    @reorder_hilbert.setter
+    def reorder_hilbert(self, value):
+        self._reorder_hilbert = bool(value)
+
+    @property
+    def seed(self):
+        """
+        Seed of the kernel's random numbers. Runs with the same nonzero seed are reproducible independently of the
+        number of threads, zero selects a random seed.
+        """
+        return self._seed
+
+    @seed.setter
+    def seed(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative seeds permitted!")
+        self._seed = int(value)
+
+    @property
+    def sample_first_order_reactions(self):
+        """
+        Whether the reaction handlers sample the number of first order reaction events per particle type and reaction
+        at once and pick the reacting particles uniformly, instead of drawing a random number for every particle.
+        """
+        return self._sample_first_order_reactions
+
+    @sample_first_order_reactions.setter
+    def sample_first_order_reactions(self, value):
+        self._sample_first_order_reactions = bool(value)
+
+    @property
+    def structure_of_arrays(self):
+        """
+        Whether the particle data additionally keeps positions, forces and types in contiguous arrays, on which the
+        integrator and the pair force loop then operate.
+        """
+        return self._structure_of_arrays
+
+    @structure_of_arrays.setter
+    def structure_of_arrays(self, value):
+        self._structure_of_arrays = bool(value)
+
     def to_json(self):
         import json
         return json.dumps({"CPU": {
             "neighbor_list": {
                 "cll_radius": self.cell_linked_list_radius,
+                "verlet_list": self.verlet_list,
+                "skin": self.skin,
             },
             "thread_config": {
                 "n_threads": self.n_threads,
-            }
+            },
+            "reorder": {
+                "interval": self.reorder_interval,
+                "hilbert": self.reorder_hilbert,
+            },
+            "seed": self.seed,
+            "sample_first_order_reactions": self.sample_first_order_reactions,
+            "structure_of_arrays": self.structure_of_arrays
         }
         })
@@ -101,6 +101,7 @@ class Simulation(object):
         self.skin = skin
         self._show_progress = True
         self._progress_output_stride = 10
+        self._async_output = False
 
         if kernel == "CPU":
             self._kernel_configuration = _CPUKernelConfiguration()
@@ -164,6 +165,34 @@ class Simulation(object):
         """
         self._show_progress = value
 
+    @property
+    def async_output(self) -> bool:
+        """
+        Returns whether observables hand their results to a writer thread instead of writing them into the output file
+        on the simulation thread.
+        :return: true if the output is written asynchronously
+        """
+        return self._async_output
+
+    @async_output.setter
+    def async_output(self, value: bool):
+        """
+        Sets whether observables hand their results to a writer thread, so that compression and file IO overlap with
+        the simulation.
+        :param value: true if the output should be written asynchronously
+        """
+        assert isinstance(value, bool), "the value must be bool but was {}".format(type(value))
+        self._async_output = value
+
+    @property
+    def async_output_statistics(self):
+        """
+        Returns the number of writes, the bytes written, and the seconds spent in writing and in waiting for the writer
+        thread, if the output is written asynchronously.
+        :return: a dictionary with the statistics or None
+        """
+        return self._simulation.async_output_statistics
+
     @property
     def evaluate_topology_reactions(self) -> bool:
         """
@@ -332,6 +361,24 @@ class Simulation(object):
         handle = self._simulation.register_observable_flat_trajectory(stride)
         self._observables._observable_handles.append((name, chunk_size, handle))
 
+    def record_compact_trajectory(self, precision, stride=1, name="", chunk_size=1000, keyframe_interval=100):
+        """
+        Record trajectory into file in the compact format. Positions are quantized on a grid of spacing `precision`
+        relative to the lower corner of the simulation box and stored as differences to the previous frame in between
+        keyframes, particle ids and types are only stored for particles that were added or changed their type. The
+        trajectory can be read back with `readdy.Trajectory(filename, name).read()` like an ordinary trajectory, the
+        particles of a frame are then ordered by their appearance in the trajectory rather than their storage order.
+
+        :param precision: the grid spacing in units of length, positions are reconstructed up to precision / 2
+        :param stride: skip `stride` time steps before evaluating the observable again
+        :param name: the name under which the trajectory can be found
+        :param chunk_size: the chunk size with which it is stored
+        :param keyframe_interval: store absolute positions at least every `keyframe_interval` recorded frames
+        """
+        precision = self._unit_conf.convert(precision, self.length_unit)
+        handle = self._simulation.register_observable_compact_trajectory(stride, precision, keyframe_interval)
+        self._observables._observable_handles.append((name, chunk_size, handle))
+
     def make_checkpoints(self, stride, output_directory, max_n_saves=5):
         """
         Records the system's state (particle positions and topology configuration) every stride steps into the
@@ -543,7 +590,13 @@ class Simulation(object):
         if self.output_file is not None and len(self.output_file) > 0 and os.path.exists(self.output_file):
             raise ValueError("Output file already existed: {}".format(self.output_file))
 
+        verlet_list = isinstance(self.kernel_configuration, _CPUKernelConfiguration) \
+            and self.kernel_configuration.verlet_list
+        if verlet_list:
+            self.kernel_configuration.skin = self._skin
+
         self._simulation.set_kernel_config(self.kernel_configuration.to_json())
+        self._configure_async_output()
 
         loop = self._simulation.create_loop(timestep)
         loop.use_integrator(self.integrator)
@@ -553,7 +606,7 @@ class Simulation(object):
         loop.evaluate_observables(self.evaluate_observables)
         if self.integrator == "MdgfrdIntegrator":
             loop.neighbor_list_cutoff = max(2. * self._simulation.context.calculate_max_cutoff(), loop.neighbor_list_cutoff)
-        if self._skin > 0.:
+        if self._skin > 0. and not verlet_list:
             loop.neighbor_list_cutoff = loop.neighbor_list_cutoff + self._skin
         if self._make_checkpoints:
             loop.make_checkpoints(self._checkpoint_stride, self._checkpoint_outdir,
@@ -586,6 +639,13 @@ class Simulation(object):
 
                 loop.run(n_steps)
 
+    def _configure_async_output(self):
+        if self._async_output:
+            if self._simulation.async_output_statistics is None:
+                self._simulation.enable_async_output()
+        else:
+            self._simulation.disable_async_output()
+
     def _run_custom_loop(self, custom_loop_function, show_summary=True):
         """
         Executes the simulation loop provided by argument, additionally takes care of preparing output file.
@@ -603,6 +663,7 @@ class Simulation(object):
             raise ValueError("Output file already existed: {}".format(self.output_file))
 
         self._simulation.set_kernel_config(self.kernel_configuration.to_json())
+        self._configure_async_output()
 
         # todo consider exposing enable_write_to_file as method of simulation (cpp and py),
         # todo then we can delete this whole run_custom_loop method
@@ -628,3 +689,4 @@ class Simulation(object):
             if show_summary:
                 print(self._simulation.context.describe())
             custom_loop_function()
+            self._simulation.wait_for_async_output()
@@ -46,6 +46,7 @@ import numpy as _np
 
 from readdy._internal.readdybinding.common.util import read_reaction_observable as _read_reaction_observable
 from readdy._internal.readdybinding.common.util import read_trajectory as _read_trajectory
+from readdy._internal.readdybinding.common.util import read_compact_trajectory as _read_compact_trajectory
 from readdy._internal.readdybinding.common.util import TrajectoryParticle
 from readdy._internal.readdybinding.common.util import read_topologies_observable as _read_topologies
 from readdy.util.observable_utils import calculate_pressure as _calculate_pressure
@@ -351,10 +352,16 @@ class Trajectory(object):
 
     def read(self) -> _typing.List[TrajectoryParticle]:
         """
-        Reads the trajectory into memory as a list of lists.
+        Reads the trajectory into memory as a list of lists. Trajectories recorded in the compact format are decoded,
+        their positions are exact up to half of the precision they were recorded with.
 
         :return: the trajectory
         """
+        with _h5py.File(self._filename, "r") as f:
+            group_path = "readdy/trajectory/" + self._name
+            compact = group_path in f and "positions" in f[group_path]
+        if compact:
+            return _read_compact_trajectory(self._filename, self._name)
         return _read_trajectory(self._filename, self._name)
 
     def read_observable_particle_positions(self, data_set_name=""):
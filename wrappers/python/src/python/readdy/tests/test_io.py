@@ -112,6 +112,56 @@ class TestSchemeApi(ReaDDyTestCase):
                 np.testing.assert_equal(item.t, idx)
                 np.testing.assert_equal(item.position, np.array([.0, .0, .0]))
 
+    def test_write_compact_trajectory(self):
+        import readdy
+        rds = readdy.ReactionDiffusionSystem([10, 10, 10])
+        rds.add_species("A", 1.)
+        rds.add_species("B", 1.)
+        rds.reactions.add("conv: A->B", rate=.5)
+        simulation = rds.simulation()
+        simulation.output_file = os.path.join(self.dir, "compact_traj.h5")
+        simulation.add_particles("A", np.random.uniform(-4.9, 4.9, size=(100, 3)))
+        simulation.record_trajectory(1, name="flat")
+        simulation.record_compact_trajectory(1e-4, 1, name="compact", keyframe_interval=7)
+        simulation.run(30, 1e-3, show_summary=False)
+
+        flat = readdy.Trajectory(simulation.output_file, name="flat").read()
+        compact = readdy.Trajectory(simulation.output_file, name="compact").read()
+        np.testing.assert_equal(len(compact), len(flat))
+        for frame_flat, frame_compact in zip(flat, compact):
+            np.testing.assert_equal(len(frame_compact), len(frame_flat))
+            # the compact format keeps its own particle order
+            frame_flat = sorted(frame_flat, key=lambda p: p.id)
+            frame_compact = sorted(frame_compact, key=lambda p: p.id)
+            for p_flat, p_compact in zip(frame_flat, frame_compact):
+                np.testing.assert_equal(p_compact.id, p_flat.id)
+                np.testing.assert_equal(p_compact.type, p_flat.type)
+                np.testing.assert_equal(p_compact.flavor, p_flat.flavor)
+                np.testing.assert_equal(p_compact.t, p_flat.t)
+                np.testing.assert_allclose(p_compact.position, p_flat.position, rtol=0, atol=.5e-4 + 1e-12)
+
+    def test_compact_trajectory_size(self):
+        import readdy
+
+        def run(compact):
+            rds = readdy.ReactionDiffusionSystem([10, 10, 10])
+            rds.add_species("A", .1)
+            rds.add_species("B", .1)
+            rds.reactions.add("conv1: A->B", rate=.5)
+            rds.reactions.add("conv2: B->A", rate=.5)
+            simulation = rds.simulation(kernel="CPU")
+            simulation.output_file = os.path.join(self.dir, "traj_size_{}.h5".format("compact" if compact else "flat"))
+            simulation.add_particles("A", np.random.uniform(-4.9, 4.9, size=(2000, 3)))
+            if compact:
+                simulation.record_compact_trajectory(1e-3, 1)
+            else:
+                simulation.record_trajectory(1)
+            simulation.run(200, 1e-3, show_summary=False)
+            return os.path.getsize(simulation.output_file)
+
+        # in-place type changes must not force rewriting the particle set in every frame
+        np.testing.assert_array_less(5 * run(True), run(False))
+
     def test_write_trajectory_as_observable(self):
         traj_fname = os.path.join(self.dir, "traj_as_obs.h5")
         context = Context()